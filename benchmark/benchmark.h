@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define AM_BENCHMARK_CYCLE_COUNTER_AVAILABLE
+
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+    #endif
+#endif
+
+
+// Keeps the compiler from optimizing away benchmarked computations
+template <typename T>
+inline void DoNotOptimize(const T& value) noexcept
+{
+    static volatile uint64_t sink = 0;
+    sink = sink + static_cast<uint64_t>(value);
+}
+
+
+// Time stamp counter ticks, or 0 if there is no cycle counter. Modern x86 CPUs tick it at constant nominal frequency,
+// so these are reference cycles, which match core cycles only with frequency scaling and turbo boost disabled
+inline uint64_t ReadCycleCounter() noexcept
+{
+#if defined(AM_BENCHMARK_CYCLE_COUNTER_AVAILABLE)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+
+class BenchmarkTimer
+{
+public:
+    BenchmarkTimer()
+        : m_startTime(std::chrono::steady_clock::now()), m_startCycles(ReadCycleCounter())
+    {}
+
+    double GetElapsedSeconds() const noexcept
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+    }
+
+    uint64_t GetElapsedCycles() const noexcept { return ReadCycleCounter() - m_startCycles; }
+
+private:
+    std::chrono::steady_clock::time_point m_startTime;
+    uint64_t m_startCycles;
+};
+
+
+// One measured configuration. Records with equal name, variant and params are comparable between runs
+struct BenchmarkRecord
+{
+    std::string name;
+    std::string variant;
+
+    std::vector<std::pair<std::string, double>> params;
+    std::vector<std::pair<std::string, double>> metrics;
+};
+
+
+void AddBenchmarkRecord(BenchmarkRecord record) noexcept;
+
+// Writes all added records with the build and machine description. Returns false if the file can't be written
+bool WriteBenchmarkReportJson(const char* filepath) noexcept;
+
+
+// Bytes currently allocated through global operator new. The benchmark executable replaces global allocation
+// functions to track it, so memory per entry of the benchmarked containers can be measured without their cooperation
+size_t GetAllocatedBytes() noexcept;
+
+
+// Returns false if any of the benchmarks correctness checks failed
+bool RunStrIDBenchmarks() noexcept;
+bool RunHashBenchmarks() noexcept;
+bool RunFlatHashMapBenchmarks() noexcept;
+bool RunSmallVectorBenchmarks() noexcept;
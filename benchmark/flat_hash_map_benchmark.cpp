@@ -0,0 +1,130 @@
+#include "benchmark.h"
+
+#include "utils/data_structures/flat_hash_map.h"
+
+#include <unordered_map>
+#include <random>
+#include <vector>
+
+
+static constexpr size_t FLAT_HASH_MAP_BENCHMARK_SIZES[] = { 256, 4 * 1024, 64 * 1024, 1024 * 1024 };
+static constexpr size_t FLAT_HASH_MAP_BENCHMARK_LOOKUPS_COUNT = 8ull * 1024 * 1024;
+
+
+// Keys are already hashed like StrID and shader IDs, so both maps get an identity hasher
+struct PrehashedKeyHasher
+{
+    using is_avalanching = void;
+
+    size_t operator()(uint64_t key) const noexcept { return static_cast<size_t>(key); }
+};
+
+
+struct MapBenchmarkResult
+{
+    double insertNsPerOp;
+    double hitLookupNsPerOp;
+    double missLookupNsPerOp;
+    double bytesPerEntry;
+    bool succeeded;
+};
+
+
+template <typename MapT>
+static MapBenchmarkResult RunMapBenchmark(const std::vector<uint64_t>& keys, const std::vector<uint64_t>& missingKeys) noexcept
+{
+    MapBenchmarkResult result = {};
+    result.succeeded = true;
+
+    const size_t allocatedBytesBefore = GetAllocatedBytes();
+
+    MapT map;
+
+    BenchmarkTimer insertTimer;
+
+    for (uint64_t key : keys) {
+        map[key] = key;
+    }
+
+    result.insertNsPerOp = insertTimer.GetElapsedSeconds() * 1e9 / keys.size();
+    result.bytesPerEntry = static_cast<double>(GetAllocatedBytes() - allocatedBytesBefore) / keys.size();
+
+    uint64_t checksum = 0;
+
+    BenchmarkTimer hitTimer;
+
+    for (size_t i = 0; i < FLAT_HASH_MAP_BENCHMARK_LOOKUPS_COUNT; ++i) {
+        const auto it = map.find(keys[(i * 7919) % keys.size()]);
+        checksum += it != map.end() ? it->second : 0;
+    }
+
+    result.hitLookupNsPerOp = hitTimer.GetElapsedSeconds() * 1e9 / FLAT_HASH_MAP_BENCHMARK_LOOKUPS_COUNT;
+
+    size_t missesFound = 0;
+
+    BenchmarkTimer missTimer;
+
+    for (size_t i = 0; i < FLAT_HASH_MAP_BENCHMARK_LOOKUPS_COUNT; ++i) {
+        missesFound += map.find(missingKeys[(i * 7919) % missingKeys.size()]) != map.end() ? 1 : 0;
+    }
+
+    result.missLookupNsPerOp = missTimer.GetElapsedSeconds() * 1e9 / FLAT_HASH_MAP_BENCHMARK_LOOKUPS_COUNT;
+
+    DoNotOptimize(checksum);
+
+    result.succeeded = map.size() == keys.size() && missesFound == 0;
+
+    return result;
+}
+
+
+static void AddMapBenchmarkRecord(const char* pVariant, size_t size, const MapBenchmarkResult& result) noexcept
+{
+    AddBenchmarkRecord({ "flat_hash_map/uint64", pVariant, { { "size", static_cast<double>(size) } }, {
+        { "insert_ns_per_op", result.insertNsPerOp },
+        { "hit_ns_per_op", result.hitLookupNsPerOp },
+        { "miss_ns_per_op", result.missLookupNsPerOp },
+        { "bytes_per_entry", result.bytesPerEntry } } });
+}
+
+
+bool RunFlatHashMapBenchmarks() noexcept
+{
+    std::mt19937_64 generator(1234);
+
+    bool succeeded = true;
+
+    printf("FlatHashMap vs std::unordered_map with prehashed uint64_t keys (ns/op, bytes/entry)\n");
+    printf("%10s %12s %12s %12s %12s %12s %12s %12s %12s\n", "size", "std insert", "flat insert", "std hit", "flat hit", "std miss", "flat miss", "std mem", "flat mem");
+
+    for (size_t size : FLAT_HASH_MAP_BENCHMARK_SIZES) {
+        std::vector<uint64_t> keys(size);
+        std::vector<uint64_t> missingKeys(size);
+
+        // Odd keys are inserted and even keys are looked up as missing ones
+        for (size_t i = 0; i < size; ++i) {
+            keys[i] = generator() | 1ull;
+            missingKeys[i] = generator() & ~1ull;
+        }
+
+        const MapBenchmarkResult stdResult = RunMapBenchmark<std::unordered_map<uint64_t, uint64_t, PrehashedKeyHasher>>(keys, missingKeys);
+        const MapBenchmarkResult flatResult = RunMapBenchmark<ds::FlatHashMap<uint64_t, uint64_t, PrehashedKeyHasher>>(keys, missingKeys);
+
+        succeeded = succeeded && stdResult.succeeded && flatResult.succeeded;
+
+        printf("%10zu %12.2f %12.2f %12.2f %12.2f %12.2f %12.2f %12.2f %12.2f\n", size,
+            stdResult.insertNsPerOp, flatResult.insertNsPerOp,
+            stdResult.hitLookupNsPerOp, flatResult.hitLookupNsPerOp,
+            stdResult.missLookupNsPerOp, flatResult.missLookupNsPerOp,
+            stdResult.bytesPerEntry, flatResult.bytesPerEntry);
+
+        AddMapBenchmarkRecord("std_unordered_map", size, stdResult);
+        AddMapBenchmarkRecord("flat_hash_map", size, flatResult);
+    }
+
+    if (!succeeded) {
+        printf("FlatHashMap benchmark FAILED: lookup results mismatch\n");
+    }
+
+    return succeeded;
+}
@@ -0,0 +1,242 @@
+#include "benchmark.h"
+
+#include "utils/data_structures/hash.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <cstring>
+
+
+// Path-sized inputs hashed by StrID and file lookups, and SPIR-V-sized inputs hashed by shader cache blobs
+static constexpr size_t HASH_BENCHMARK_INPUT_SIZES[] = { 8, 16, 32, 64, 100, 128, 256, 4 * 1024, 64 * 1024, 1024 * 1024 };
+static constexpr size_t HASH_BENCHMARK_BYTES_PER_RUN = 256ull * 1024 * 1024;
+
+static constexpr size_t HASH_BENCHMARK_STREAM_CHUNK_SIZE = 4 * 1024;
+static constexpr size_t HASH_BENCHMARK_COMBINES_COUNT = 64ull * 1024 * 1024;
+static constexpr size_t HASH_BENCHMARK_THREAD_COUNTS[] = { 1, 2, 4, 8 };
+
+
+struct HashThroughput
+{
+    double bytesPerSecond;
+    double bytesPerCycle;
+};
+
+
+// The previous amHashMem word chain with its out of bounds reads fixed, kept as a baseline
+static uint64_t LegacyHashMem(const void* data, size_t size) noexcept
+{
+    const uint8_t* ptr = static_cast<const uint8_t*>(data);
+
+    uint64_t hash = 0;
+
+    for (size_t i = 0; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, ptr + i, sizeof(word));
+
+        hash ^= word;
+        hash *= 1103515245ull;
+    }
+
+    const size_t tailOffset = size - size % sizeof(uint64_t);
+
+    for (size_t i = tailOffset; i < size; ++i) {
+        hash ^= static_cast<uint64_t>(ptr[i]) << ((i - tailOffset) * 8);
+        hash *= 1103515245ull;
+    }
+
+    return hash;
+}
+
+
+static uint64_t StdHashMem(const void* data, size_t size) noexcept
+{
+    return std::hash<std::string_view>()(std::string_view(static_cast<const char*>(data), size));
+}
+
+
+// Streams the input in fixed chunks, like file hashing does
+static uint64_t StreamHashMem(const void* data, size_t size) noexcept
+{
+    const uint8_t* ptr = static_cast<const uint8_t*>(data);
+
+    ds::StreamHasher hasher;
+
+    for (size_t offset = 0; offset < size; offset += HASH_BENCHMARK_STREAM_CHUNK_SIZE) {
+        hasher.Update(ptr + offset, std::min(HASH_BENCHMARK_STREAM_CHUNK_SIZE, size - offset));
+    }
+
+    return hasher.Finalize();
+}
+
+
+template <typename HashFunc>
+static HashThroughput MeasureThroughput(HashFunc hashFunc, const std::vector<uint8_t>& buffer, size_t inputSize) noexcept
+{
+    const size_t iterationsCount = HASH_BENCHMARK_BYTES_PER_RUN / inputSize;
+    const size_t offsetsCount = buffer.size() - inputSize;
+
+    uint64_t result = 0;
+
+    BenchmarkTimer timer;
+
+    // Shifting the input start defeats result caching and covers unaligned loads
+    for (size_t i = 0; i < iterationsCount; ++i) {
+        result += hashFunc(buffer.data() + (i * 67) % offsetsCount, inputSize);
+    }
+
+    const double elapsedSeconds = timer.GetElapsedSeconds();
+    const uint64_t elapsedCycles = timer.GetElapsedCycles();
+
+    DoNotOptimize(result);
+
+    HashThroughput throughput = {};
+    throughput.bytesPerSecond = static_cast<double>(iterationsCount * inputSize) / elapsedSeconds;
+    throughput.bytesPerCycle = elapsedCycles > 0 ? static_cast<double>(iterationsCount * inputSize) / elapsedCycles : 0.0;
+
+    return throughput;
+}
+
+
+// Aggregate throughput of all threads hashing their own inputs, shows where hashing becomes memory bound
+static double MeasureMultiThreadedThroughput(const std::vector<uint8_t>& buffer, size_t inputSize, size_t threadCount) noexcept
+{
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+
+    BenchmarkTimer timer;
+
+    for (size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
+        threads.emplace_back([&buffer, inputSize]() { MeasureThroughput(amHashMem, buffer, inputSize); });
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    return static_cast<double>(threadCount * HASH_BENCHMARK_BYTES_PER_RUN / inputSize * inputSize) / timer.GetElapsedSeconds();
+}
+
+
+// HashBuilder combines per-field hashes of pipeline and shader keys, so its cost is dominated by Combine
+static double MeasureHashBuilderCombineNs() noexcept
+{
+    ds::HashBuilder builder;
+
+    BenchmarkTimer timer;
+
+    for (size_t i = 0; i < HASH_BENCHMARK_COMBINES_COUNT; ++i) {
+        builder.AddValue(i);
+    }
+
+    const double elapsedSeconds = timer.GetElapsedSeconds();
+
+    DoNotOptimize(builder.Value());
+
+    return elapsedSeconds * 1e9 / HASH_BENCHMARK_COMBINES_COUNT;
+}
+
+
+static bool CheckBackendsConsistency(const std::vector<uint8_t>& buffer) noexcept
+{
+    for (size_t size = 1; size < 4096; ++size) {
+        const uint64_t scalarHash = ds::detail::HashMem<ds::detail::HashScalarBackend>(buffer.data() + size % 61, size);
+        
+        if (scalarHash != amHashMem(buffer.data() + size % 61, size)) {
+            printf("Hash benchmark FAILED: SIMD and scalar hashes mismatch for %zu bytes input\n", size);
+            return false;
+        }
+
+        ds::StreamHasher streamHasher;
+        for (size_t offset = 0; offset < size; offset += size % 97 + 1) {
+            streamHasher.Update(buffer.data() + size % 61 + offset, std::min(size % 97 + 1, size - offset));
+        }
+
+        if (streamHasher.Finalize() != scalarHash) {
+            printf("Hash benchmark FAILED: streaming and one-shot hashes mismatch for %zu bytes input\n", size);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+bool RunHashBenchmarks() noexcept
+{
+    std::vector<uint8_t> buffer(2 * HASH_BENCHMARK_INPUT_SIZES[std::size(HASH_BENCHMARK_INPUT_SIZES) - 1]);
+
+    std::mt19937_64 generator(42);
+    for (uint8_t& value : buffer) {
+        value = static_cast<uint8_t>(generator());
+    }
+
+    if (!CheckBackendsConsistency(buffer)) {
+        return false;
+    }
+
+    struct HashVariant
+    {
+        const char* pName;
+        uint64_t (*pHashFunc)(const void*, size_t) noexcept;
+    };
+
+    static constexpr HashVariant HASH_VARIANTS[] = {
+        { "legacy", LegacyHashMem },
+        { "std_hash", StdHashMem },
+        { "scalar", ds::detail::HashMem<ds::detail::HashScalarBackend> },
+        { "simd", amHashMem },
+        { "stream", StreamHashMem },
+    };
+
+    printf("amHashMem throughput (GB/s | bytes/cycle)\n");
+    printf("%10s", "size");
+
+    for (const HashVariant& variant : HASH_VARIANTS) {
+        printf(" %20s", variant.pName);
+    }
+
+    printf("\n");
+
+    for (size_t inputSize : HASH_BENCHMARK_INPUT_SIZES) {
+        printf("%10zu", inputSize);
+
+        for (const HashVariant& variant : HASH_VARIANTS) {
+            const HashThroughput throughput = MeasureThroughput(variant.pHashFunc, buffer, inputSize);
+
+            printf(" %11.2f | %6.2f", throughput.bytesPerSecond / 1e9, throughput.bytesPerCycle);
+
+            AddBenchmarkRecord({ "hash/throughput", variant.pName, { { "size", static_cast<double>(inputSize) } },
+                { { "gb_per_s", throughput.bytesPerSecond / 1e9 }, { "bytes_per_cycle", throughput.bytesPerCycle } } });
+        }
+
+        printf("\n");
+    }
+
+    const size_t multiThreadedInputSize = HASH_BENCHMARK_INPUT_SIZES[std::size(HASH_BENCHMARK_INPUT_SIZES) - 1];
+
+    printf("\namHashMem multi-threaded throughput for %zu bytes inputs (GB/s)\n", multiThreadedInputSize);
+    printf("%10s %12s\n", "threads", "total");
+
+    for (size_t threadCount : HASH_BENCHMARK_THREAD_COUNTS) {
+        const double bytesPerSecond = MeasureMultiThreadedThroughput(buffer, multiThreadedInputSize, threadCount);
+
+        printf("%10zu %12.2f\n", threadCount, bytesPerSecond / 1e9);
+
+        AddBenchmarkRecord({ "hash/throughput_mt", "simd", { { "size", static_cast<double>(multiThreadedInputSize) }, { "threads", static_cast<double>(threadCount) } },
+            { { "gb_per_s", bytesPerSecond / 1e9 } } });
+    }
+
+    const double combineNs = MeasureHashBuilderCombineNs();
+
+    printf("\nHashBuilder::AddValue<uint64_t>: %.2f ns/op\n\n", combineNs);
+
+    AddBenchmarkRecord({ "hash/builder_add_value", "uint64", {}, { { "ns_per_op", combineNs } } });
+
+    return true;
+}
@@ -0,0 +1,53 @@
+#include "benchmark.h"
+
+#include <cstring>
+
+
+static void PrintUsage() noexcept
+{
+    printf("Usage: engine_benchmark [--filter <strid|hash|flat_hash_map|small_vector>] [--json <report filepath>]\n");
+}
+
+
+int main(int argc, char* argv[])
+{
+    const char* pFilter = nullptr;
+    const char* pJsonFilepath = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            pFilter = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            pJsonFilepath = argv[++i];
+        } else {
+            PrintUsage();
+            return -1;
+        }
+    }
+
+    const auto IsEnabled = [pFilter](const char* pName) { return pFilter == nullptr || strcmp(pFilter, pName) == 0; };
+
+    bool succeeded = true;
+
+    if (IsEnabled("strid")) {
+        succeeded = RunStrIDBenchmarks() && succeeded;
+    }
+
+    if (IsEnabled("hash")) {
+        succeeded = RunHashBenchmarks() && succeeded;
+    }
+
+    if (IsEnabled("flat_hash_map")) {
+        succeeded = RunFlatHashMapBenchmarks() && succeeded;
+    }
+
+    if (IsEnabled("small_vector")) {
+        succeeded = RunSmallVectorBenchmarks() && succeeded;
+    }
+
+    if (pJsonFilepath) {
+        succeeded = WriteBenchmarkReportJson(pJsonFilepath) && succeeded;
+    }
+
+    return succeeded ? 0 : -1;
+}
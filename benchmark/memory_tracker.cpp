@@ -0,0 +1,94 @@
+#include "benchmark.h"
+
+#include <atomic>
+#include <new>
+#include <cstdlib>
+
+
+static std::atomic<size_t> s_allocatedBytes = 0;
+
+
+// Stored right before every returned pointer, so deallocation doesn't depend on the sized and aligned overloads being used consistently
+struct AllocationHeader
+{
+    void* pBase;
+    size_t size;
+};
+
+
+static void* TrackedAllocate(size_t size, size_t alignment) noexcept
+{
+    alignment = alignment > alignof(std::max_align_t) ? alignment : alignof(std::max_align_t);
+
+    uint8_t* pBase = static_cast<uint8_t*>(malloc(size + sizeof(AllocationHeader) + alignment));
+
+    if (pBase == nullptr) {
+        return nullptr;
+    }
+
+    const uintptr_t userAddress = (reinterpret_cast<uintptr_t>(pBase) + sizeof(AllocationHeader) + alignment - 1) & ~(alignment - 1);
+
+    AllocationHeader* pHeader = reinterpret_cast<AllocationHeader*>(userAddress) - 1;
+    pHeader->pBase = pBase;
+    pHeader->size = size;
+
+    s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    return reinterpret_cast<void*>(userAddress);
+}
+
+
+static void TrackedDeallocate(void* ptr) noexcept
+{
+    if (ptr == nullptr) {
+        return;
+    }
+
+    const AllocationHeader* pHeader = static_cast<const AllocationHeader*>(ptr) - 1;
+
+    s_allocatedBytes.fetch_sub(pHeader->size, std::memory_order_relaxed);
+
+    free(pHeader->pBase);
+}
+
+
+static void* TrackedAllocateOrThrow(size_t size, size_t alignment)
+{
+    void* ptr = TrackedAllocate(size, alignment);
+
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+
+size_t GetAllocatedBytes() noexcept
+{
+    return s_allocatedBytes.load(std::memory_order_relaxed);
+}
+
+
+void* operator new(size_t size) { return TrackedAllocateOrThrow(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size) { return TrackedAllocateOrThrow(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t alignment) { return TrackedAllocateOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return TrackedAllocateOrThrow(size, static_cast<size_t>(alignment)); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return TrackedAllocate(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedAllocate(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return TrackedAllocate(size, static_cast<size_t>(alignment)); }
+
+void operator delete(void* ptr) noexcept { TrackedDeallocate(ptr); }
+void operator delete[](void* ptr) noexcept { TrackedDeallocate(ptr); }
+void operator delete(void* ptr, size_t) noexcept { TrackedDeallocate(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { TrackedDeallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { TrackedDeallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { TrackedDeallocate(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { TrackedDeallocate(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { TrackedDeallocate(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { TrackedDeallocate(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { TrackedDeallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { TrackedDeallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { TrackedDeallocate(ptr); }
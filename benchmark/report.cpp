@@ -0,0 +1,152 @@
+#include "benchmark.h"
+
+#include <thread>
+#include <mutex>
+#include <cmath>
+
+
+static std::mutex s_recordsMutex;
+static std::vector<BenchmarkRecord> s_records;
+
+
+static const char* GetCompilerDesc() noexcept
+{
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    #define AM_BENCHMARK_STRINGIFY_IMPL(x) #x
+    #define AM_BENCHMARK_STRINGIFY(x) AM_BENCHMARK_STRINGIFY_IMPL(x)
+    return "msvc " AM_BENCHMARK_STRINGIFY(_MSC_FULL_VER);
+#else
+    return "unknown";
+#endif
+}
+
+
+// Cycle counter ticks per nanosecond, so reference cycles in the report can be converted back to time
+static double MeasureCycleCounterFrequencyGHz() noexcept
+{
+#if defined(AM_BENCHMARK_CYCLE_COUNTER_AVAILABLE)
+    BenchmarkTimer timer;
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    return static_cast<double>(timer.GetElapsedCycles()) / (timer.GetElapsedSeconds() * 1e9);
+#else
+    return 0.0;
+#endif
+}
+
+
+static void WriteJsonString(FILE* pFile, const std::string& str) noexcept
+{
+    fputc('"', pFile);
+
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            fputc('\\', pFile);
+            fputc(c, pFile);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            fprintf(pFile, "\\u%04x", c);
+        } else {
+            fputc(c, pFile);
+        }
+    }
+
+    fputc('"', pFile);
+}
+
+
+static void WriteJsonNumber(FILE* pFile, double value) noexcept
+{
+    if (std::isfinite(value)) {
+        fprintf(pFile, "%.17g", value);
+    } else {
+        fputs("null", pFile);
+    }
+}
+
+
+static void WriteJsonObject(FILE* pFile, const std::vector<std::pair<std::string, double>>& values) noexcept
+{
+    fputc('{', pFile);
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i > 0) {
+            fputs(", ", pFile);
+        }
+
+        WriteJsonString(pFile, values[i].first);
+        fputs(": ", pFile);
+        WriteJsonNumber(pFile, values[i].second);
+    }
+
+    fputc('}', pFile);
+}
+
+
+void AddBenchmarkRecord(BenchmarkRecord record) noexcept
+{
+    std::lock_guard<std::mutex> lock(s_recordsMutex);
+    s_records.emplace_back(std::move(record));
+}
+
+
+bool WriteBenchmarkReportJson(const char* filepath) noexcept
+{
+    FILE* pFile = fopen(filepath, "w");
+
+    if (pFile == nullptr) {
+        printf("Failed to open %s for writing benchmark report\n", filepath);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(s_recordsMutex);
+
+    fputs("{\n", pFile);
+    fputs("  \"version\": 1,\n", pFile);
+    fputs("  \"context\": {\n", pFile);
+    fputs("    \"compiler\": ", pFile);
+    WriteJsonString(pFile, GetCompilerDesc());
+#if defined(NDEBUG)
+    fputs(",\n    \"build_type\": \"release\",\n", pFile);
+#else
+    fputs(",\n    \"build_type\": \"debug\",\n", pFile);
+#endif
+    fprintf(pFile, "    \"hardware_threads\": %u,\n", std::thread::hardware_concurrency());
+#if defined(AM_BENCHMARK_CYCLE_COUNTER_AVAILABLE)
+    fputs("    \"cycle_counter\": \"rdtsc\",\n", pFile);
+#else
+    fputs("    \"cycle_counter\": null,\n", pFile);
+#endif
+    fputs("    \"cycle_counter_ghz\": ", pFile);
+    WriteJsonNumber(pFile, MeasureCycleCounterFrequencyGHz());
+    fputs("\n  },\n", pFile);
+
+    fputs("  \"benchmarks\": [", pFile);
+
+    for (size_t i = 0; i < s_records.size(); ++i) {
+        const BenchmarkRecord& record = s_records[i];
+
+        fputs(i > 0 ? ",\n    {" : "\n    {", pFile);
+
+        fputs("\"name\": ", pFile);
+        WriteJsonString(pFile, record.name);
+        fputs(", \"variant\": ", pFile);
+        WriteJsonString(pFile, record.variant);
+        fputs(", \"params\": ", pFile);
+        WriteJsonObject(pFile, record.params);
+        fputs(", \"metrics\": ", pFile);
+        WriteJsonObject(pFile, record.metrics);
+
+        fputc('}', pFile);
+    }
+
+    fputs("\n  ]\n}\n", pFile);
+
+    const bool succeeded = ferror(pFile) == 0;
+    fclose(pFile);
+
+    return succeeded;
+}
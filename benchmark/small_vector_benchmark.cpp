@@ -0,0 +1,100 @@
+#include "benchmark.h"
+
+#include "utils/data_structures/small_vector.h"
+
+#include <vector>
+#include <string>
+
+
+static constexpr size_t SMALL_VECTOR_INLINE_CAPACITY = 16;
+static constexpr size_t SMALL_VECTOR_BENCHMARK_SIZES[] = { 4, 16, 64 };
+static constexpr size_t SMALL_VECTOR_BENCHMARK_ELEMENTS_COUNT = 16ull * 1024 * 1024;
+
+
+// Builds and drops many short lists, like per frame Vulkan object lists do
+template <typename VectorT>
+static double RunFillBenchmark(size_t size) noexcept
+{
+    const size_t roundsCount = SMALL_VECTOR_BENCHMARK_ELEMENTS_COUNT / size;
+
+    uint64_t checksum = 0;
+
+    BenchmarkTimer timer;
+
+    for (size_t round = 0; round < roundsCount; ++round) {
+        VectorT vector;
+
+        for (size_t i = 0; i < size; ++i) {
+            vector.push_back(static_cast<uint32_t>(round + i));
+        }
+
+        checksum += vector[round % size];
+    }
+
+    const double elapsedSeconds = timer.GetElapsedSeconds();
+
+    DoNotOptimize(checksum);
+
+    return elapsedSeconds * 1e9 / (roundsCount * size);
+}
+
+
+// Arguments referencing the vector's own elements must survive growth, like they do with std::vector
+static bool CheckSelfReferencingInserts() noexcept
+{
+    const std::string value = "string long enough to not fit into small string buffer";
+
+    ds::SmallVector<std::string, 2> pushVector;
+    pushVector.push_back(value);
+
+    for (size_t i = 0; i < 64; ++i) {
+        pushVector.push_back(pushVector.back());
+        pushVector.emplace_back(pushVector[0]);
+    }
+
+    for (const std::string& element : pushVector) {
+        if (element != value) {
+            return false;
+        }
+    }
+
+    ds::SmallVector<std::string, 2> resizeVector;
+    resizeVector.push_back(value);
+    resizeVector.resize(64, resizeVector[0]);
+
+    for (const std::string& element : resizeVector) {
+        if (element != value) {
+            return false;
+        }
+    }
+
+    return pushVector.size() == 129 && resizeVector.size() == 64;
+}
+
+
+bool RunSmallVectorBenchmarks() noexcept
+{
+    if (!CheckSelfReferencingInserts()) {
+        printf("SmallVector benchmark FAILED: elements inserted from references to the vector itself are corrupted\n");
+        return false;
+    }
+
+    printf("SmallVector<uint32_t, %zu> vs std::vector fill of short lists (ns/element)\n", SMALL_VECTOR_INLINE_CAPACITY);
+    printf("%10s %12s %12s\n", "size", "std", "small");
+
+    for (size_t size : SMALL_VECTOR_BENCHMARK_SIZES) {
+        const double stdNsPerElement = RunFillBenchmark<std::vector<uint32_t>>(size);
+        const double smallNsPerElement = RunFillBenchmark<ds::SmallVector<uint32_t, SMALL_VECTOR_INLINE_CAPACITY>>(size);
+
+        printf("%10zu %12.2f %12.2f\n", size, stdNsPerElement, smallNsPerElement);
+
+        const std::vector<std::pair<std::string, double>> params = { { "size", static_cast<double>(size) } };
+
+        AddBenchmarkRecord({ "small_vector/fill", "std_vector", params, { { "ns_per_element", stdNsPerElement } } });
+        AddBenchmarkRecord({ "small_vector/fill", "small_vector", params, { { "ns_per_element", smallNsPerElement } } });
+    }
+
+    printf("\n");
+
+    return true;
+}
@@ -0,0 +1,330 @@
+#include "benchmark.h"
+
+#include "utils/data_structures/strid.h"
+
+#include <unordered_map>
+#include <type_traits>
+#include <thread>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <memory>
+#include <cstring>
+
+
+static constexpr size_t STRID_BENCHMARK_UNIQUE_STRINGS_COUNT = 200'000;
+static constexpr size_t STRID_BENCHMARK_ROUNDS_COUNT = 4;
+static constexpr size_t STRID_BENCHMARK_LOOKUPS_PER_THREAD = 2'000'000;
+static constexpr size_t STRID_BENCHMARK_THREAD_COUNTS[] = { 1, 2, 4, 8 };
+
+
+// The previous single-threaded StrID storage design, made thread-safe with one global mutex.
+// Storage is preallocated for the whole benchmark, since growing it would invalidate pointers returned by Load
+class MutexStrIDDataStorage
+{
+public:
+    explicit MutexStrIDDataStorage(size_t storageSize)
+    {
+        m_strBufLocations.reserve(8192);
+        m_storage.resize(storageSize);
+    }
+
+    uint64_t Store(std::string_view str) noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const uint64_t id = amHashConstexpr(str);
+
+        if (m_strBufLocations.find(id) == m_strBufLocations.cend()) {
+            if (m_usedSize + str.length() + 1 > m_storage.size()) {
+                m_storage.resize(m_storage.size() * 2);
+            }
+
+            std::copy_n(str.begin(), str.length(), m_storage.begin() + m_usedSize);
+            m_storage[m_usedSize + str.length()] = '\0';
+
+            m_strBufLocations[id] = m_usedSize;
+            m_usedSize += str.length() + 1;
+        }
+
+        return id;
+    }
+
+    const char* Load(uint64_t id) const noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const auto locationIt = m_strBufLocations.find(id);
+        return locationIt == m_strBufLocations.cend() ? nullptr : m_storage.data() + locationIt->second;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+
+    std::unordered_map<uint64_t, size_t> m_strBufLocations;
+    std::vector<char> m_storage;
+    size_t m_usedSize = 0;
+};
+
+
+template <typename IdT>
+static IdT ComputeStrID(std::string_view str) noexcept
+{
+    if constexpr (std::is_same_v<IdT, ds::Hash128>) {
+        return amHash128Constexpr(str);
+    } else {
+        return amHashConstexpr(str);
+    }
+}
+
+
+template <typename StorageType>
+using StorageIdType = decltype(std::declval<StorageType&>().Store(std::string_view()));
+
+
+static std::vector<std::string> GenerateStrings(size_t count) noexcept
+{
+    std::vector<std::string> strings;
+    strings.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        strings.emplace_back("assets/group_" + std::to_string(i % 97) + "/texture_" + std::to_string(i) + ".png");
+    }
+
+    return strings;
+}
+
+
+// Runs threadFunc(threadIndex) on threadCount threads and returns wall time of all of them
+template <typename ThreadFunc>
+static double RunOnThreads(size_t threadCount, ThreadFunc threadFunc) noexcept
+{
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+
+    BenchmarkTimer timer;
+
+    for (size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
+        threads.emplace_back(threadFunc, threadIndex);
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    return timer.GetElapsedSeconds();
+}
+
+
+template <typename StorageType>
+static bool CheckStorageContents(const StorageType& storage, const std::vector<std::string>& strings) noexcept
+{
+    for (const std::string& str : strings) {
+        const char* pStr = storage.Load(ComputeStrID<StorageIdType<StorageType>>(str));
+
+        if (pStr == nullptr || strcmp(pStr, str.c_str()) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+// Every thread interns all the strings starting from its own offset, so threads both race on inserting
+// the same new strings and look up strings interned by others. Returns interns + loads per second
+template <typename StorageType>
+static double RunStressBenchmark(StorageType& storage, const std::vector<std::string>& strings, size_t threadCount, bool& outSucceeded) noexcept
+{
+    std::vector<char> threadsSucceeded(threadCount, 1);
+
+    const double elapsedSeconds = RunOnThreads(threadCount, [&](size_t threadIndex)
+    {
+        const size_t stringsCount = strings.size();
+        const size_t offset = threadIndex * stringsCount / threadCount;
+
+        for (size_t round = 0; round < STRID_BENCHMARK_ROUNDS_COUNT; ++round) {
+            for (size_t i = 0; i < stringsCount; ++i) {
+                const std::string& str = strings[(offset + i) % stringsCount];
+
+                const auto id = storage.Store(str);
+                const char* pStr = storage.Load(id);
+
+                if (pStr == nullptr || strcmp(pStr, str.c_str()) != 0) {
+                    threadsSucceeded[threadIndex] = 0;
+                }
+            }
+        }
+    });
+
+    for (char threadSucceeded : threadsSucceeded) {
+        outSucceeded = outSucceeded && threadSucceeded;
+    }
+
+    // Pointers returned earlier must stay valid and unchanged after all the inserts
+    outSucceeded = outSucceeded && CheckStorageContents(storage, strings);
+
+    const double operationsCount = 2.0 * threadCount * STRID_BENCHMARK_ROUNDS_COUNT * strings.size();
+    return operationsCount / elapsedSeconds;
+}
+
+
+// Threads intern disjoint parts of the strings into the empty storage, so every operation is an insert. Returns interns per second
+template <typename StorageType>
+static double RunInternBenchmark(StorageType& storage, const std::vector<std::string>& strings, size_t threadCount, bool& outSucceeded) noexcept
+{
+    const double elapsedSeconds = RunOnThreads(threadCount, [&](size_t threadIndex)
+    {
+        const size_t begin = threadIndex * strings.size() / threadCount;
+        const size_t end = (threadIndex + 1) * strings.size() / threadCount;
+
+        for (size_t i = begin; i < end; ++i) {
+            storage.Store(strings[i]);
+        }
+    });
+
+    outSucceeded = outSucceeded && CheckStorageContents(storage, strings);
+
+    return static_cast<double>(strings.size()) / elapsedSeconds;
+}
+
+
+struct LookupLatency
+{
+    double loadNs;
+    double findNs;
+};
+
+
+// Average latency seen by every thread, when all threads look up already interned strings at the same time.
+// Load resolves an id to the string, find is Store of an existing string: hashing plus id lookup
+template <typename StorageType>
+static LookupLatency RunLookupBenchmark(StorageType& storage, const std::vector<std::string>& strings, size_t threadCount, bool& outSucceeded) noexcept
+{
+    using IdType = StorageIdType<StorageType>;
+
+    std::vector<IdType> ids;
+    ids.reserve(strings.size());
+
+    for (const std::string& str : strings) {
+        ids.emplace_back(storage.Store(str));
+    }
+
+    std::vector<char> threadsSucceeded(threadCount, 1);
+
+    const double loadSeconds = RunOnThreads(threadCount, [&](size_t threadIndex)
+    {
+        size_t checksum = 0;
+
+        // Prime stride spreads the accesses over the whole table
+        for (size_t i = 0; i < STRID_BENCHMARK_LOOKUPS_PER_THREAD; ++i) {
+            const char* pStr = storage.Load(ids[(threadIndex * 131 + i * 7919) % ids.size()]);
+            checksum += pStr ? static_cast<size_t>(pStr[0]) : 0;
+        }
+
+        threadsSucceeded[threadIndex] = checksum == STRID_BENCHMARK_LOOKUPS_PER_THREAD * 'a';
+    });
+
+    const double findSeconds = RunOnThreads(threadCount, [&](size_t threadIndex)
+    {
+        for (size_t i = 0; i < STRID_BENCHMARK_LOOKUPS_PER_THREAD; ++i) {
+            const size_t idx = (threadIndex * 131 + i * 7919) % strings.size();
+
+            if (storage.Store(strings[idx]) != ids[idx]) {
+                threadsSucceeded[threadIndex] = 0;
+            }
+        }
+    });
+
+    for (char threadSucceeded : threadsSucceeded) {
+        outSucceeded = outSucceeded && threadSucceeded;
+    }
+
+    LookupLatency latency = {};
+    latency.loadNs = loadSeconds * 1e9 / STRID_BENCHMARK_LOOKUPS_PER_THREAD;
+    latency.findNs = findSeconds * 1e9 / STRID_BENCHMARK_LOOKUPS_PER_THREAD;
+
+    return latency;
+}
+
+
+template <typename StorageType, typename... Args>
+static void RunStorageBenchmarks(const char* pVariant, const std::vector<std::string>& strings, bool& outSucceeded, Args... storageArgs) noexcept
+{
+    size_t stringsTotalSize = 0;
+    for (const std::string& str : strings) {
+        stringsTotalSize += str.length() + 1;
+    }
+
+    printf("%-12s %8s %16s %16s %16s %14s\n", pVariant, "threads", "mixed (Mops/s)", "intern (Mops/s)", "load (ns/op)", "find (ns/op)");
+
+    for (size_t threadCount : STRID_BENCHMARK_THREAD_COUNTS) {
+        const auto MakeParams = [threadCount]() { return std::vector<std::pair<std::string, double>>{ { "threads", static_cast<double>(threadCount) } }; };
+
+        std::unique_ptr<StorageType> pStressStorage = std::make_unique<StorageType>(storageArgs...);
+        const double mixedOpsPerSecond = RunStressBenchmark(*pStressStorage, strings, threadCount, outSucceeded);
+        pStressStorage.reset();
+
+        const size_t allocatedBytesBefore = GetAllocatedBytes();
+
+        std::unique_ptr<StorageType> pStorage = std::make_unique<StorageType>(storageArgs...);
+        const double internOpsPerSecond = RunInternBenchmark(*pStorage, strings, threadCount, outSucceeded);
+
+        const double bytesPerEntry = static_cast<double>(GetAllocatedBytes() - allocatedBytesBefore) / strings.size();
+
+        const LookupLatency latency = RunLookupBenchmark(*pStorage, strings, threadCount, outSucceeded);
+
+        printf("%-12s %8zu %16.2f %16.2f %16.2f %14.2f\n", "", threadCount, mixedOpsPerSecond / 1e6, internOpsPerSecond / 1e6, latency.loadNs, latency.findNs);
+
+        AddBenchmarkRecord({ "strid/mixed", pVariant, MakeParams(), { { "mops_per_s", mixedOpsPerSecond / 1e6 } } });
+        AddBenchmarkRecord({ "strid/intern", pVariant, MakeParams(), { { "mops_per_s", internOpsPerSecond / 1e6 } } });
+        AddBenchmarkRecord({ "strid/lookup", pVariant, MakeParams(), { { "load_ns_per_op", latency.loadNs }, { "find_ns_per_op", latency.findNs } } });
+
+        // Storage layout doesn't depend on the threads count, so memory is reported once
+        if (threadCount == 1) {
+            AddBenchmarkRecord({ "strid/memory", pVariant, {}, { { "bytes_per_entry", bytesPerEntry },
+                { "string_bytes_per_entry", static_cast<double>(stringsTotalSize) / strings.size() } } });
+        }
+    }
+
+    printf("\n");
+}
+
+
+bool RunStrIDBenchmarks() noexcept
+{
+    const std::vector<std::string> strings = GenerateStrings(STRID_BENCHMARK_UNIQUE_STRINGS_COUNT);
+
+    size_t stringsTotalSize = 0;
+    for (const std::string& str : strings) {
+        stringsTotalSize += str.length() + 1;
+    }
+
+    bool succeeded = true;
+
+    printf("StrID storage benchmark (%zu unique strings, %zu mixed rounds, %zu lookups per thread)\n",
+        strings.size(), STRID_BENCHMARK_ROUNDS_COUNT, STRID_BENCHMARK_LOOKUPS_PER_THREAD);
+
+    RunStorageBenchmarks<MutexStrIDDataStorage>("mutex", strings, succeeded, stringsTotalSize);
+    RunStorageBenchmarks<ds::StrIDDataStorage<char>>("sharded", strings, succeeded);
+    RunStorageBenchmarks<ds::StrIDDataStorage<char, ds::Hash128>>("sharded128", strings, succeeded);
+
+    const size_t allocatedBytesBefore = GetAllocatedBytes();
+
+    {
+        std::unique_ptr<ds::StrIDDataStorage<char>> pStorage = std::make_unique<ds::StrIDDataStorage<char>>();
+        RunInternBenchmark(*pStorage, strings, 1, succeeded);
+    }
+
+    if (!succeeded) {
+        printf("StrID benchmark FAILED: interned strings mismatch\n");
+    }
+
+    // Storage must return all of its memory on destruction
+    if (GetAllocatedBytes() != allocatedBytesBefore) {
+        printf("StrID benchmark FAILED: storage leaked %zu bytes\n", GetAllocatedBytes() - allocatedBytesBefore);
+        succeeded = false;
+    }
+
+    return succeeded;
+}
@@ -0,0 +1,169 @@
+# Generates a header with compile-time shader variant keys from shader groups setup.json files.
+#
+# Usage:
+#   cmake -DAM_SHADERS_SOURCE_CODE_DIR=<dir> -DAM_OUTPUT_FILEPATH=<file> -P generate_shader_variant_keys.cmake
+
+cmake_minimum_required(VERSION 3.19) # string(JSON ...)
+
+if(NOT AM_SHADERS_SOURCE_CODE_DIR OR NOT AM_OUTPUT_FILEPATH)
+    message(FATAL_ERROR "AM_SHADERS_SOURCE_CODE_DIR and AM_OUTPUT_FILEPATH must be specified")
+endif()
+
+set(AM_SHADER_VARIANT_KEY_MAX_DEFINES_COUNT 24)
+
+
+# Identifiers are used after a prefix, so leading and repeated underscores are dropped to avoid reserved names like DEFINE__DEBUG
+function(am_make_cxx_identifier INPUT OUTPUT_VAR)
+    string(MAKE_C_IDENTIFIER "${INPUT}" identifier)
+    string(TOUPPER "${identifier}" identifier)
+    string(REGEX REPLACE "_+" "_" identifier "${identifier}")
+    string(REGEX REPLACE "^_" "" identifier "${identifier}")
+
+    if(identifier STREQUAL "")
+        message(FATAL_ERROR "'${INPUT}' can't be converted to C++ identifier")
+    endif()
+
+    set(${OUTPUT_VAR} ${identifier} PARENT_SCOPE)
+endfunction()
+
+
+# Matches amGetShaderGroupID: 64-bit FNV-1a of the group name folded to 32 bits. CMake math is 64-bit signed,
+# so the hash is kept in two 32-bit halves
+function(am_get_shader_group_id GROUP_NAME OUTPUT_VAR)
+    set(hashHigh 0xCBF29CE4)
+    set(hashLow  0x84222325)
+
+    string(HEX "${GROUP_NAME}" groupNameHex)
+    string(LENGTH "${groupNameHex}" groupNameHexLength)
+
+    set(i 0)
+    while(i LESS groupNameHexLength)
+        string(SUBSTRING "${groupNameHex}" ${i} 2 byteHex)
+        math(EXPR hashLow "${hashLow} ^ 0x${byteHex}")
+
+        # hash * (2^40 + 0x1B3) mod 2^64
+        math(EXPR lowProduct "${hashLow} * 0x1B3")
+        math(EXPR hashHigh "(${hashHigh} * 0x1B3 + (${lowProduct} >> 32) + (${hashLow} << 8)) & 0xFFFFFFFF")
+        math(EXPR hashLow "${lowProduct} & 0xFFFFFFFF")
+
+        math(EXPR i "${i} + 2")
+    endwhile()
+
+    math(EXPR groupID "${hashHigh} ^ ${hashLow}" OUTPUT_FORMAT HEXADECIMAL)
+    set(${OUTPUT_VAR} ${groupID} PARENT_SCOPE)
+endfunction()
+
+
+file(GLOB AM_SHADER_SETUP_FILES LIST_DIRECTORIES false "${AM_SHADERS_SOURCE_CODE_DIR}/*/*.json")
+list(SORT AM_SHADER_SETUP_FILES)
+
+set(groupIDs "")
+set(groupNamespaces "")
+
+set(content "")
+string(APPEND content "#pragma once\n\n")
+string(APPEND content "// Generated by cmake/generate_shader_variant_keys.cmake from shader groups setup files. Don't edit it manually.\n\n")
+string(APPEND content "#include \"shader_system/shader_variant_key.h\"\n\n\n")
+string(APPEND content "namespace shaders\n{\n")
+
+foreach(setupFilepath ${AM_SHADER_SETUP_FILES})
+    get_filename_component(groupDir "${setupFilepath}" DIRECTORY)
+    get_filename_component(groupName "${groupDir}" NAME)
+    string(MAKE_C_IDENTIFIER "${groupName}" groupNamespace)
+
+    if(groupNamespace IN_LIST groupNamespaces)
+        message(FATAL_ERROR "Shader group '${groupName}' namespace ${groupNamespace} collides with another shader group")
+    endif()
+    list(APPEND groupNamespaces ${groupNamespace})
+
+    am_get_shader_group_id("${groupName}" groupID)
+    if(groupID IN_LIST groupIDs)
+        message(FATAL_ERROR "Shader group '${groupName}' ID ${groupID} collides with another shader group, rename the group")
+    endif()
+    list(APPEND groupIDs ${groupID})
+
+    file(READ "${setupFilepath}" setupJson)
+
+    string(JSON definesCount ERROR_VARIABLE jsonError LENGTH "${setupJson}" defines)
+    if(jsonError)
+        message(FATAL_ERROR "Failed to parse ${setupFilepath}: ${jsonError}")
+    endif()
+
+    if(definesCount GREATER AM_SHADER_VARIANT_KEY_MAX_DEFINES_COUNT)
+        message(FATAL_ERROR "${setupFilepath} has ${definesCount} defines, max supported count is ${AM_SHADER_VARIANT_KEY_MAX_DEFINES_COUNT}")
+    endif()
+
+    # Match nlohmann::json object iteration order, which defines the runtime define indices
+    set(defineNames "")
+    if(definesCount GREATER 0)
+        math(EXPR lastDefineIndex "${definesCount} - 1")
+        foreach(i RANGE ${lastDefineIndex})
+            string(JSON defineName MEMBER "${setupJson}" defines ${i})
+            list(APPEND defineNames "${defineName}")
+        endforeach()
+        list(SORT defineNames)
+    endif()
+
+    set(enumContent "")
+    set(vsDefinesMask 0)
+    set(psDefinesMask 0)
+    set(defineIndex 0)
+    set(defineIdentifiers "")
+
+    foreach(defineName ${defineNames})
+        am_make_cxx_identifier("${defineName}" defineIdentifier)
+
+        if(defineIdentifier IN_LIST defineIdentifiers)
+            message(FATAL_ERROR "Define '${defineName}' in ${setupFilepath} maps to DEFINE_${defineIdentifier}, which is used by another define")
+        endif()
+        list(APPEND defineIdentifiers ${defineIdentifier})
+
+        string(APPEND enumContent "            DEFINE_${defineIdentifier} = 1u << ${defineIndex},\n")
+
+        string(JSON typesCount LENGTH "${setupJson}" defines "${defineName}" type)
+        math(EXPR lastTypeIndex "${typesCount} - 1")
+
+        foreach(j RANGE ${lastTypeIndex})
+            string(JSON type GET "${setupJson}" defines "${defineName}" type ${j})
+
+            if(type STREQUAL "vs")
+                math(EXPR vsDefinesMask "${vsDefinesMask} | (1 << ${defineIndex})" OUTPUT_FORMAT HEXADECIMAL)
+            elseif(type STREQUAL "ps")
+                math(EXPR psDefinesMask "${psDefinesMask} | (1 << ${defineIndex})" OUTPUT_FORMAT HEXADECIMAL)
+            else()
+                message(FATAL_ERROR "Invalid shader setup type '${type}' in ${setupFilepath}")
+            endif()
+        endforeach()
+
+        math(EXPR defineIndex "${defineIndex} + 1")
+    endforeach()
+
+    if(NOT content MATCHES "{\n$")
+        string(APPEND content "\n")
+    endif()
+
+    string(APPEND content "    namespace ${groupNamespace}\n    {\n")
+    string(APPEND content "        inline constexpr uint32_t GROUP_ID = amGetShaderGroupID(\"${groupName}\");\n\n")
+    
+    if(enumContent)
+        string(APPEND content "        enum Define : uint32_t\n        {\n${enumContent}        };\n\n")
+    endif()
+
+    string(APPEND content "        inline constexpr uint32_t VS_DEFINES_MASK = ${vsDefinesMask};\n")
+    string(APPEND content "        inline constexpr uint32_t PS_DEFINES_MASK = ${psDefinesMask};\n\n")
+    string(APPEND content "        constexpr ShaderVariantKey VS(uint32_t defines = 0) noexcept { return amMakeShaderVariantKey(GROUP_ID, AM_VERTEX_SHADER_MASK, defines & VS_DEFINES_MASK); }\n")
+    string(APPEND content "        constexpr ShaderVariantKey PS(uint32_t defines = 0) noexcept { return amMakeShaderVariantKey(GROUP_ID, AM_PIXEL_SHADER_MASK, defines & PS_DEFINES_MASK); }\n")
+    string(APPEND content "    }\n")
+endforeach()
+
+string(APPEND content "}\n")
+
+# Don't touch the output if nothing changed to avoid needless rebuilds
+set(oldContent "")
+if(EXISTS "${AM_OUTPUT_FILEPATH}")
+    file(READ "${AM_OUTPUT_FILEPATH}" oldContent)
+endif()
+
+if(NOT oldContent STREQUAL content)
+    file(WRITE "${AM_OUTPUT_FILEPATH}" "${content}")
+endif()
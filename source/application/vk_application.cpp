@@ -4,47 +4,192 @@
 #include "path_system/path_system.h"
 
 #include "utils/debug/assertion.h"
-#include "utils/json/json.h"
+#include "utils/json/json_schema.h"
+#include "utils/json/json_cache.h"
 #include "utils/file/file.h"
+#include "utils/file/strid_table_file.h"
+#include "utils/file/async_file_io.h"
+#include "utils/file/async_file_writer.h"
+#include "utils/file/file_fingerprint_db.h"
+#include "utils/file/virtual_file_system.h"
 #include "utils/timer/timer.h"
 
 #include "shader_system/shader_system.h"
 
+#include "shader_variant_keys.h"
 
-static constexpr const char* ENGINE_NAME = "Engine";
-static constexpr const char* APPLICATION_NAME   = "Application";
+#if defined(AM_OS_WINDOWS)
+    #include <timeapi.h>
+#endif
 
-// Application config JSON field names
-static constexpr const char* JSON_APP_CONFIG_WINDOW_FIELD_NAME = "window";
-static constexpr const char* JSON_APP_CONFIG_WINDOW_TITLE_FIELD_NAME = "title";
-static constexpr const char* JSON_APP_CONFIG_WINDOW_WIDTH_FIELD_NAME = "width";
-static constexpr const char* JSON_APP_CONFIG_WINDOW_HEIGHT_FIELD_NAME = "height";
-static constexpr const char* JSON_APP_CONFIG_WINDOW_RESIZABLE_FLAG_FIELD_NAME = "resizable";
 
+static constexpr const char* ENGINE_NAME = "Engine";
+static constexpr const char* APPLICATION_NAME   = "Application";
 
 static constexpr float AM_DEFAULT_QUEUE_PRIORITY = 1.0f;
 
+// Enumerated only during initialization, so bigger lists may spill to the heap
+static constexpr size_t AM_VK_INLINE_EXTENSIONS_COUNT = 32;
+static constexpr size_t AM_VK_INLINE_LAYERS_COUNT = 16;
+static constexpr size_t AM_VK_INLINE_PHYSICAL_DEVICES_COUNT = 4;
+static constexpr size_t AM_VK_INLINE_QUEUE_FAMILIES_COUNT = 8;
+
 
 static std::optional<VulkanAppInitInfo> ParseAppInitInfoJson(const fs::path& pathToJson) noexcept
 {
-    using namespace amjson;
+    VulkanAppInitInfo appInitInfo = {};
 
-    const std::optional<nlohmann::json> appInitInfoJsonOpt = amjson::ParseJson(pathToJson);
-    if (!appInitInfoJsonOpt.has_value()) {
+    if (!amjson::ParseJsonSchema(pathToJson, appInitInfo)) {
+        AM_LOG_ERROR("Failed to parse {} application config", pathToJson.string().c_str());
         return {};
     }
-    
-    const nlohmann::json& appInitInfoJson = appInitInfoJsonOpt.value();
 
-    const nlohmann::json& windowConfigJson = GetJsonSubNode(appInitInfoJson, JSON_APP_CONFIG_WINDOW_FIELD_NAME);
+    return appInitInfo;
+}
 
-    VulkanAppInitInfo appInitInfo = {};
-    GetJsonSubNode(windowConfigJson, JSON_APP_CONFIG_WINDOW_TITLE_FIELD_NAME).get_to(appInitInfo.windowInitInfo.title);
-    GetJsonSubNode(windowConfigJson, JSON_APP_CONFIG_WINDOW_WIDTH_FIELD_NAME).get_to(appInitInfo.windowInitInfo.width);
-    GetJsonSubNode(windowConfigJson, JSON_APP_CONFIG_WINDOW_HEIGHT_FIELD_NAME).get_to(appInitInfo.windowInitInfo.height);
-    GetJsonSubNode(windowConfigJson, JSON_APP_CONFIG_WINDOW_RESIZABLE_FLAG_FIELD_NAME).get_to(appInitInfo.windowInitInfo.resizable);
 
-    return appInitInfo;
+static std::vector<fs::path> GetAssetsPackDirectories() noexcept
+{
+    return { PathSystem::GetProjectShadersSourceCodeDirectory(), PathSystem::GetProjectConfigDirectory() };
+}
+
+
+static std::optional<VkPresentModeKHR> ParseVkPresentMode(std::string_view name) noexcept
+{
+    static constexpr std::pair<std::string_view, VkPresentModeKHR> PRESENT_MODES[] = {
+        { "immediate",      VK_PRESENT_MODE_IMMEDIATE_KHR },
+        { "mailbox",        VK_PRESENT_MODE_MAILBOX_KHR },
+        { "fifo",           VK_PRESENT_MODE_FIFO_KHR },
+        { "fifo_relaxed",   VK_PRESENT_MODE_FIFO_RELAXED_KHR },
+    };
+
+    for (const auto& [modeName, mode] : PRESENT_MODES) {
+        if (modeName == name) {
+            return mode;
+        }
+    }
+
+    return std::nullopt;
+}
+
+
+static std::optional<VkSurfaceFormatKHR> ParseVkSurfaceFormat(std::string_view name) noexcept
+{
+    static constexpr std::pair<std::string_view, VkFormat> SURFACE_FORMATS[] = {
+        { "R8G8B8A8_SRGB",          VK_FORMAT_R8G8B8A8_SRGB },
+        { "B8G8R8A8_SRGB",          VK_FORMAT_B8G8R8A8_SRGB },
+        { "R8G8B8A8_UNORM",         VK_FORMAT_R8G8B8A8_UNORM },
+        { "B8G8R8A8_UNORM",         VK_FORMAT_B8G8R8A8_UNORM },
+        { "A2B10G10R10_UNORM",      VK_FORMAT_A2B10G10R10_UNORM_PACK32 },
+    };
+
+    for (const auto& [formatName, format] : SURFACE_FORMATS) {
+        if (formatName == name) {
+            return VkSurfaceFormatKHR { format, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
+        }
+    }
+
+    return std::nullopt;
+}
+
+
+static std::optional<ShaderOptimizationLevel> ParseShaderOptimizationLevel(std::string_view name) noexcept
+{
+    static constexpr std::pair<std::string_view, ShaderOptimizationLevel> OPTIMIZATION_LEVELS[] = {
+        { "none",   SHADER_OPTIMIZATION_LEVEL_NONE },
+        { "speed",  SHADER_OPTIMIZATION_LEVEL_SPEED },
+        { "size",   SHADER_OPTIMIZATION_LEVEL_SIZE },
+    };
+
+    if (name == "default") {
+        return VulkanShaderSystem::GetDefaultOptimizationLevel();
+    }
+
+    for (const auto& [levelName, level] : OPTIMIZATION_LEVELS) {
+        if (levelName == name) {
+            return level;
+        }
+    }
+
+    return std::nullopt;
+}
+
+
+static std::optional<spdlog::level::level_enum> ParseLogLevel(std::string_view name) noexcept
+{
+    static constexpr std::pair<std::string_view, spdlog::level::level_enum> LOG_LEVELS[] = {
+        { "info",   spdlog::level::info },
+        { "warn",   spdlog::level::warn },
+        { "error",  spdlog::level::err },
+        { "off",    spdlog::level::off },
+    };
+
+    for (const auto& [levelName, level] : LOG_LEVELS) {
+        if (levelName == name) {
+            return level;
+        }
+    }
+
+    return std::nullopt;
+}
+
+
+static void ApplyLoggingConfig(const AppLoggingInitInfo& initInfo) noexcept
+{
+    const std::optional<spdlog::level::level_enum> level = ParseLogLevel(initInfo.level);
+    if (!level.has_value()) {
+        AM_LOG_WARN("Unknown log level '{}' in logging config is ignored", initInfo.level.c_str());
+        return;
+    }
+
+    amSetLogLevel(level.value());
+}
+
+
+static VulkanRenderConfig MakeVulkanRenderConfig(const AppRenderInitInfo& initInfo) noexcept
+{
+    VulkanRenderConfig config = {};
+
+    const std::optional<VkPresentModeKHR> presentMode = ParseVkPresentMode(initInfo.presentMode);
+    if (!presentMode.has_value()) {
+        AM_LOG_WARN("Unknown present mode '{}' in render config, 'fifo' is used", initInfo.presentMode.c_str());
+    }
+    config.presentMode = presentMode.value_or(VK_PRESENT_MODE_FIFO_KHR);
+
+    for (const std::string& formatName : initInfo.surfaceFormats) {
+        const std::optional<VkSurfaceFormatKHR> surfaceFormat = ParseVkSurfaceFormat(formatName);
+
+        if (!surfaceFormat.has_value()) {
+            AM_LOG_WARN("Unknown surface format '{}' in render config is skipped", formatName.c_str());
+            continue;
+        }
+
+        config.surfaceFormats.emplace_back(surfaceFormat.value());
+    }
+
+    config.framesInFlight = std::clamp(initInfo.framesInFlight, 1u, static_cast<uint32_t>(AM_VK_MAX_FRAMES_IN_FLIGHT));
+    if (config.framesInFlight != initInfo.framesInFlight) {
+        AM_LOG_WARN("Frames in flight count {} in render config is clamped to {}", initInfo.framesInFlight, config.framesInFlight);
+    }
+
+    config.swapChainImagesCount = initInfo.swapChainImagesCount;
+
+    const std::optional<ShaderOptimizationLevel> shaderOptimizationLevel = ParseShaderOptimizationLevel(initInfo.shaderOptimizationLevel);
+    if (!shaderOptimizationLevel.has_value()) {
+        AM_LOG_WARN("Unknown shader optimization level '{}' in render config, build default is used", initInfo.shaderOptimizationLevel.c_str());
+    }
+    config.shaderOptimizationLevel = shaderOptimizationLevel.value_or(VulkanShaderSystem::GetDefaultOptimizationLevel());
+
+#if defined(AM_VK_VALIDATION_LAYERS_ENABLED)
+    config.validationEnabled = initInfo.validationEnabled;
+#else
+    if (initInfo.validationEnabled) {
+        AM_LOG_WARN("Validation is requested by render config, but validation layers are disabled in this build");
+    }
+    config.validationEnabled = false;
+#endif
+
+    return config;
 }
 
 
@@ -240,8 +385,8 @@ static std::string MakeVulkanObjectsListString(const VkObjT* pObjects, size_t ob
 }
 
 
-template<typename VkObjT>
-static std::string MakeVulkanObjectsListString(const std::vector<VkObjT>& objects) noexcept
+template<typename VkObjContainerT>
+static std::string MakeVulkanObjectsListString(const VkObjContainerT& objects) noexcept
 {
     return MakeVulkanObjectsListString(objects.data(), objects.size());
 }
@@ -252,7 +397,7 @@ static bool CheckVulkanInstanceExtensionsSupport(const char* const* pExtensions,
     uint32_t availableVulkanInstExtCount = 0;
     vkEnumerateInstanceExtensionProperties(nullptr, &availableVulkanInstExtCount, nullptr);
 
-    std::vector<VkExtensionProperties> availableVulkanInstExtensions(availableVulkanInstExtCount);
+    ds::SmallVector<VkExtensionProperties, AM_VK_INLINE_EXTENSIONS_COUNT> availableVulkanInstExtensions(availableVulkanInstExtCount);
     vkEnumerateInstanceExtensionProperties(nullptr, &availableVulkanInstExtCount, availableVulkanInstExtensions.data());
 
     AM_LOG_GRAPHICS_API_INFO("Available Vulkan instance extensions:\n{}", MakeVulkanObjectsListString(availableVulkanInstExtensions).c_str());
@@ -283,7 +428,7 @@ AM_MAYBE_UNUSED static bool CheckVulkanInstanceValidationLayersSupport(const cha
     uint32_t availableLayerCount;
     vkEnumerateInstanceLayerProperties(&availableLayerCount, nullptr);
 
-    std::vector<VkLayerProperties> availableLayers(availableLayerCount);
+    ds::SmallVector<VkLayerProperties, AM_VK_INLINE_LAYERS_COUNT> availableLayers(availableLayerCount);
     vkEnumerateInstanceLayerProperties(&availableLayerCount, availableLayers.data());
 
     AM_LOG_GRAPHICS_API_INFO("Available Vulkan validation layers:\n{}", MakeVulkanObjectsListString(availableLayers).c_str());
@@ -320,7 +465,7 @@ static bool CheckVulkanLogicalDeviceExtensionSupport(const VulkanPhysicalDevice&
     uint32_t extensionCount;
     vkEnumerateDeviceExtensionProperties(physicalDevice.pDevice, nullptr, &extensionCount, nullptr);
 
-    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    ds::SmallVector<VkExtensionProperties, AM_VK_INLINE_EXTENSIONS_COUNT> availableExtensions(extensionCount);
     vkEnumerateDeviceExtensionProperties(physicalDevice.pDevice, nullptr, &extensionCount, availableExtensions.data());
     
     AM_LOG_GRAPHICS_API_INFO("Available Vulkan logical device extensions:\n{}", MakeVulkanObjectsListString(availableExtensions));
@@ -549,7 +694,7 @@ static VulkanQueueFamilyIndices FindRequiredVulkanQueueFamilyIndices(VulkanPhysi
     uint32_t physDeviceQueueFamiliesCount = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(pPhysicalDevice, &physDeviceQueueFamiliesCount, nullptr);
 
-    std::vector<VkQueueFamilyProperties> physDeviceQueueFamilies(physDeviceQueueFamiliesCount);
+    ds::SmallVector<VkQueueFamilyProperties, AM_VK_INLINE_QUEUE_FAMILIES_COUNT> physDeviceQueueFamilies(physDeviceQueueFamiliesCount);
     vkGetPhysicalDeviceQueueFamilyProperties(pPhysicalDevice, &physDeviceQueueFamiliesCount, physDeviceQueueFamilies.data());
 
     VulkanQueueFamilyIndices indices;
@@ -665,28 +810,37 @@ static VulkanSwapChainDesc GetVulkanSwapChainDeviceSurfaceDesc(const VulkanPhysi
 }
 
 
-static const VkSurfaceFormatKHR& PickSwapChainSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats) noexcept
+static const VkSurfaceFormatKHR& PickSwapChainSurfaceFormat(const VkSurfaceFormatKHR* pAvailableFormats, size_t availableFormatsCount, 
+    const VkSurfaceFormatKHR* pPreferredFormats, size_t preferredFormatsCount) noexcept
 {
-    // Create configuration file node for this in future
-    for (const VkSurfaceFormatKHR& format : availableFormats) {
-        if (format.format == VK_FORMAT_R8G8B8A8_SRGB && format.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
-            return format;
+    for (size_t i = 0; i < preferredFormatsCount; ++i) {
+        const VkSurfaceFormatKHR& preferredFormat = pPreferredFormats[i];
+
+        for (size_t j = 0; j < availableFormatsCount; ++j) {
+            const VkSurfaceFormatKHR& format = pAvailableFormats[j];
+
+            if (format.format == preferredFormat.format && format.colorSpace == preferredFormat.colorSpace) {
+                return format;
+            }
         }
     }
 
-    return availableFormats[0];
+    AM_LOG_WARN("None of preferred surface formats is supported, the first available one is used");
+    return pAvailableFormats[0];
 }
 
 
-static VkPresentModeKHR PickSwapChainPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes) noexcept
+static VkPresentModeKHR PickSwapChainPresentMode(const VkPresentModeKHR* pAvailablePresentModes, size_t availablePresentModesCount, 
+    VkPresentModeKHR preferredPresentMode) noexcept
 {
-    // Create configuration file node for this in future
-    for (const VkPresentModeKHR& presentMode : availablePresentModes) {
-        if (presentMode == VK_PRESENT_MODE_MAILBOX_KHR) {
-            return presentMode;
+    for (size_t i = 0; i < availablePresentModesCount; ++i) {
+        if (pAvailablePresentModes[i] == preferredPresentMode) {
+            return preferredPresentMode;
         }
     }
 
+    // FIFO is the only present mode that is required to be supported
+    AM_LOG_WARN("Preferred present mode is not supported, FIFO is used");
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
@@ -726,6 +880,41 @@ bool VulkanApplication::Init() noexcept
         return false;
     }
 
+#if defined(AM_STRID_TABLE_PERSISTENCE_ENABLED)
+    LoadStrIDTable(PathSystem::GetProjectStrIDTableFilepath());
+#endif
+
+    if (!AsyncFileIO::Init()) {
+        return false;
+    }
+
+    if (!AsyncFileWriter::Init()) {
+        return false;
+    }
+
+    if (!FileFingerprintDB::Init(PathSystem::GetProjectFileFingerprintDBFilepath())) {
+        return false;
+    }
+
+    if (!VirtualFileSystem::Init(PathSystem::GetProjectRootDirectory())) {
+        return false;
+    }
+
+    if (!JsonBinaryCache::Init(PathSystem::GetProjectJsonCacheFilepath())) {
+        return false;
+    }
+
+#if defined(AM_PACKED_ASSETS_ENABLED)
+    const fs::path assetsPackFilepath = PathSystem::GetProjectAssetsPackFilepath();
+
+    // Stale pack would shadow edited shaders and configs and disable the config reload
+    if (VirtualFileSystem::IsPackOutdated(assetsPackFilepath, GetAssetsPackDirectories())) {
+        AM_LOG_WARN("{} is outdated, loose files are used. Rebuild the engine or run it with --build-assets-pack", assetsPackFilepath.string().c_str());
+    } else {
+        VirtualFileSystem::Instance().Mount(assetsPackFilepath);
+    }
+#endif
+
     std::optional<VulkanAppInitInfo> appInitInfoOpt = ParseAppInitInfoJson(PathSystem::GetProjectConfigFilepath());
     if (!appInitInfoOpt.has_value()) {
         return false;
@@ -733,11 +922,13 @@ bool VulkanApplication::Init() noexcept
 
     const VulkanAppInitInfo& appInitInfo = appInitInfoOpt.value();
 
+    ApplyLoggingConfig(appInitInfo.loggingInitInfo);
+
     if (!CreateGLFWWindow(appInitInfo.windowInitInfo)) {
         return false;
     }
 
-    if (!InitVulkan()) {
+    if (!InitVulkan(appInitInfo.renderInitInfo)) {
         Terminate();
         return false;
     }
@@ -762,13 +953,44 @@ void VulkanApplication::Terminate() noexcept
     TerminateVulkan();
     TerminateGLFWWindow();
 
+    JsonBinaryCache::Terminate();
+    FileFingerprintDB::Terminate();
+    AsyncFileIO::Terminate();
+    VirtualFileSystem::Terminate();
+
+    // Flushes pending writes, including the ones queued by the systems above
+    AsyncFileWriter::Terminate();
+
+#if defined(AM_STRID_TABLE_PERSISTENCE_ENABLED)
+    if (PathSystem::IsInitialized()) {
+        StoreStrIDTable(PathSystem::GetProjectStrIDTableFilepath());
+    }
+#endif
+
+    amTerminateLogSystem();
+}
+
+
+bool VulkanApplication::BuildAssetsPack() noexcept
+{
+    amInitLogSystem();
+
+    bool succeeded = PathSystem::Init();
+
+    if (succeeded) {
+        succeeded = VirtualFileSystem::BuildPack(PathSystem::GetProjectAssetsPackFilepath(), PathSystem::GetProjectRootDirectory(), 
+            GetAssetsPackDirectories());
+    }
+
     amTerminateLogSystem();
+
+    return succeeded;
 }
 
 
 bool VulkanApplication::IsInitialized() noexcept
 {
-    return amIsLogSystemInitialized() && PathSystem::IsInitialized() && s_pAppInst && s_pAppInst->IsInstanceInitialized();
+    return amIsLogSystemInitialized() && PathSystem::IsInitialized() && AsyncFileIO::IsInitialized() && AsyncFileWriter::IsInitialized() && FileFingerprintDB::IsInitialized() && VirtualFileSystem::IsInitialized() && JsonBinaryCache::IsInitialized() && s_pAppInst && s_pAppInst->IsInstanceInitialized();
 }
 
 
@@ -780,7 +1002,11 @@ void VulkanApplication::Run() noexcept
         }
 
         glfwPollEvents();
+
+        ApplyConfigChanges();
+
         RenderFrame();
+        LimitFrameRate();
     }
 }
 
@@ -857,23 +1083,32 @@ bool VulkanApplication::InitVulkanInstance() noexcept
         VK_KHR_WIN32_SURFACE_EXTENSION_NAME,
     #endif
 
+    // Must stay the last one, it's excluded when validation is disabled by render config
     #if defined(AM_VK_VALIDATION_LAYERS_ENABLED)
         VK_EXT_DEBUG_UTILS_EXTENSION_NAME,
     #endif
     };
 
-    static constexpr size_t VULKAN_INST_REQUIRED_EXTENSIONS_COUNT = _countof(VULKAN_INST_REQUIRED_EXTENSIONS);
+    size_t instExtensionsCount = _countof(VULKAN_INST_REQUIRED_EXTENSIONS);
+
+#if defined(AM_VK_VALIDATION_LAYERS_ENABLED)
+    const bool isValidationEnabled = s_pVulkanState->renderConfig.validationEnabled;
+
+    if (!isValidationEnabled) {
+        --instExtensionsCount;
+    }
+#endif
 
-    if (!CheckVulkanInstanceExtensionsSupport(VULKAN_INST_REQUIRED_EXTENSIONS, VULKAN_INST_REQUIRED_EXTENSIONS_COUNT)) {
+    if (!CheckVulkanInstanceExtensionsSupport(VULKAN_INST_REQUIRED_EXTENSIONS, instExtensionsCount)) {
         AM_ASSERT_GRAPHICS_API_FAIL("Not all required Vulkan instance extensions are supported");
         return false;
     }
 
     AM_LOG_GRAPHICS_API_INFO("Included Vulkan instance extensions:\n{}", 
-        MakeVulkanObjectsListString(VULKAN_INST_REQUIRED_EXTENSIONS, VULKAN_INST_REQUIRED_EXTENSIONS_COUNT).c_str());
+        MakeVulkanObjectsListString(VULKAN_INST_REQUIRED_EXTENSIONS, instExtensionsCount).c_str());
 
     instCreateInfo.ppEnabledExtensionNames = VULKAN_INST_REQUIRED_EXTENSIONS;
-    instCreateInfo.enabledExtensionCount = VULKAN_INST_REQUIRED_EXTENSIONS_COUNT;
+    instCreateInfo.enabledExtensionCount = instExtensionsCount;
     
     VkDebugUtilsMessengerCreateInfoEXT vulkanDebugMessengerCreateInfo = {};
 
@@ -884,20 +1119,22 @@ bool VulkanApplication::InitVulkanInstance() noexcept
 
     static constexpr size_t VULKAN_INST_REQUIRED_VALIDATION_LAYERS_COUNT = _countof(VULKAN_INST_REQUIRED_VALIDATION_LAYERS);
 
-    if (!CheckVulkanInstanceValidationLayersSupport(VULKAN_INST_REQUIRED_VALIDATION_LAYERS, VULKAN_INST_REQUIRED_VALIDATION_LAYERS_COUNT)) {
-        AM_ASSERT_GRAPHICS_API_FAIL("Not all required validation layers are supported");
-        return false;
-    }
+    if (isValidationEnabled) {
+        if (!CheckVulkanInstanceValidationLayersSupport(VULKAN_INST_REQUIRED_VALIDATION_LAYERS, VULKAN_INST_REQUIRED_VALIDATION_LAYERS_COUNT)) {
+            AM_ASSERT_GRAPHICS_API_FAIL("Not all required validation layers are supported");
+            return false;
+        }
 
-    AM_LOG_GRAPHICS_API_INFO("Included Vulkan validation layers:\n{}", 
-        MakeVulkanObjectsListString(VULKAN_INST_REQUIRED_VALIDATION_LAYERS, VULKAN_INST_REQUIRED_VALIDATION_LAYERS_COUNT).c_str());
+        AM_LOG_GRAPHICS_API_INFO("Included Vulkan validation layers:\n{}", 
+            MakeVulkanObjectsListString(VULKAN_INST_REQUIRED_VALIDATION_LAYERS, VULKAN_INST_REQUIRED_VALIDATION_LAYERS_COUNT).c_str());
 
-    instCreateInfo.ppEnabledLayerNames = VULKAN_INST_REQUIRED_VALIDATION_LAYERS;
-    instCreateInfo.enabledLayerCount = VULKAN_INST_REQUIRED_VALIDATION_LAYERS_COUNT;
-    
-    vulkanDebugMessengerCreateInfo = CreateVkDebugUtilsMessengerCreateInfo();
-    
-    instCreateInfo.pNext = (VkDebugUtilsMessengerCreateInfoEXT*)&vulkanDebugMessengerCreateInfo;
+        instCreateInfo.ppEnabledLayerNames = VULKAN_INST_REQUIRED_VALIDATION_LAYERS;
+        instCreateInfo.enabledLayerCount = VULKAN_INST_REQUIRED_VALIDATION_LAYERS_COUNT;
+        
+        vulkanDebugMessengerCreateInfo = CreateVkDebugUtilsMessengerCreateInfo();
+        
+        instCreateInfo.pNext = (VkDebugUtilsMessengerCreateInfoEXT*)&vulkanDebugMessengerCreateInfo;
+    }
 #endif
 
     if (vkCreateInstance(&instCreateInfo, nullptr, &s_pVulkanState->intance.pInstance) != VK_SUCCESS) {
@@ -930,6 +1167,10 @@ void VulkanApplication::TerminateVulkanInstance() noexcept
 bool VulkanApplication::InitVulkanDebugMessenger(const VkDebugUtilsMessengerCreateInfoEXT& messengerCreateInfo) noexcept
 {
 #if defined(AM_VK_VALIDATION_LAYERS_ENABLED)
+    if (s_pVulkanState && !s_pVulkanState->renderConfig.validationEnabled) {
+        return true;
+    }
+
     if (IsVulkanDebugMessengerInitialized()) {
         AM_LOG_WARN("Vulkan debug messenger is already initialized");
         return true;
@@ -1043,7 +1284,7 @@ bool VulkanApplication::InitVulkanPhysicalDevice() noexcept
         return false;
     }
 
-    std::vector<VkPhysicalDevice> devices(deviceCount);
+    ds::SmallVector<VkPhysicalDevice, AM_VK_INLINE_PHYSICAL_DEVICES_COUNT> devices(deviceCount);
     vkEnumeratePhysicalDevices(s_pVulkanState->intance.pInstance, &deviceCount, devices.data());
 
     AM_LOG_GRAPHICS_API_INFO("Picking suitable physical device...");
@@ -1141,14 +1382,15 @@ bool VulkanApplication::InitVulkanLogicalDevice() noexcept
     createInfo.ppEnabledExtensionNames = VULKAN_LOGICAL_DEVICE_EXTENSIONS;
     createInfo.enabledExtensionCount = VULKAN_LOGICAL_DEVICE_EXTENSIONS_COUNT;
 
-    std::unordered_set<uint32_t> uniqueQueueFamilyIndices(VulkanQueueFamilyIndices::COUNT);
+    ds::FixedVector<uint32_t, VulkanQueueFamilyIndices::COUNT> uniqueQueueFamilyIndices;
     
-    for (int32_t queueFamilyIndex : queueFamilyIndices.indices) {
-        uniqueQueueFamilyIndices.insert(queueFamilyIndex);
+    for (uint32_t queueFamilyIndex : queueFamilyIndices.indices) {
+        if (std::find(uniqueQueueFamilyIndices.cbegin(), uniqueQueueFamilyIndices.cend(), queueFamilyIndex) == uniqueQueueFamilyIndices.cend()) {
+            uniqueQueueFamilyIndices.push_back(queueFamilyIndex);
+        }
     }
 
-    std::vector<VkDeviceQueueCreateInfo> deviceQueueCreateInfos;
-    deviceQueueCreateInfos.reserve(uniqueQueueFamilyIndices.size());
+    ds::FixedVector<VkDeviceQueueCreateInfo, VulkanQueueFamilyIndices::COUNT> deviceQueueCreateInfos;
 
     for (uint32_t queueFamilyIndex : uniqueQueueFamilyIndices) {
         VkDeviceQueueCreateInfo queueCreateInfo = {};
@@ -1226,14 +1468,19 @@ bool VulkanApplication::InitVulkanSwapChain() noexcept
         return false;
     }
 
-    const VkPresentModeKHR presentMode = PickSwapChainPresentMode(swapChainDesc.presentModes);
-    const VkSurfaceFormatKHR& surfaceFormat = PickSwapChainSurfaceFormat(swapChainDesc.formats);
+    const VulkanRenderConfig& renderConfig = s_pVulkanState->renderConfig;
+
+    const VkPresentModeKHR presentMode = PickSwapChainPresentMode(swapChainDesc.presentModes.data(), swapChainDesc.presentModes.size(), 
+        renderConfig.presentMode);
+    const VkSurfaceFormatKHR& surfaceFormat = PickSwapChainSurfaceFormat(swapChainDesc.formats.data(), swapChainDesc.formats.size(), 
+        renderConfig.surfaceFormats.data(), renderConfig.surfaceFormats.size());
 
     int framebufferWidth = 0, framebufferHeight = 0;
     glfwGetFramebufferSize(s_pGLFWWindow, &framebufferWidth, &framebufferHeight);
     const VkExtent2D extent = PickSwapChainSurfaceExtent(swapChainDesc.capabilities, (uint32_t)framebufferWidth, (uint32_t)framebufferHeight);
 
-    uint32_t imageCount = swapChainDesc.capabilities.minImageCount + 1;
+    uint32_t imageCount = renderConfig.swapChainImagesCount > 0 ? renderConfig.swapChainImagesCount : swapChainDesc.capabilities.minImageCount + 1;
+    imageCount = std::max(imageCount, swapChainDesc.capabilities.minImageCount);
 
     if (swapChainDesc.capabilities.maxImageCount > 0 && imageCount > swapChainDesc.capabilities.maxImageCount) {
         imageCount = swapChainDesc.capabilities.maxImageCount;
@@ -1279,14 +1526,15 @@ bool VulkanApplication::InitVulkanSwapChain() noexcept
     uint32_t finalImageCount = 0;
     vkGetSwapchainImagesKHR(s_pVulkanState->logicalDevice.pDevice, pSwapChain, &finalImageCount, nullptr);
     
-    std::vector<VkImage>& swapChainImages = s_pVulkanState->swapChain.images;
-    swapChainImages.resize(imageCount);
-    vkGetSwapchainImagesKHR(s_pVulkanState->logicalDevice.pDevice, pSwapChain, &imageCount, swapChainImages.data());
+    // Implementation is allowed to create more images than requested
+    auto& swapChainImages = s_pVulkanState->swapChain.images;
+    swapChainImages.resize(finalImageCount);
+    vkGetSwapchainImagesKHR(s_pVulkanState->logicalDevice.pDevice, pSwapChain, &finalImageCount, swapChainImages.data());
 
     swapChainDesc.currExtent = extent;
     swapChainDesc.currFormat = surfaceFormat.format;
 
-    std::vector<VkImageView>& swapChainImageViews = s_pVulkanState->swapChain.imageViews;
+    auto& swapChainImageViews = s_pVulkanState->swapChain.imageViews;
     swapChainImageViews.resize(swapChainImages.size());
 
     for (size_t i = 0; i < swapChainImageViews.size(); ++i) {
@@ -1526,32 +1774,27 @@ bool VulkanApplication::InitVulkanGraphicsPipeline() noexcept
         return false;
     }
 
-    // Temp solution
-    const fs::path& shadersSourceCodeDir = PathSystem::GetProjectShadersSourceCodeDirectory();
-
     VkPipelineShaderStageCreateInfo vertShaderStageInfo = {};
     vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+    vertShaderStageInfo.module = shaderSystem.FindShaderModule(shaders::base::VS());
+    vertShaderStageInfo.pName = "main";
 
-    ShaderIDProxy vsIdProxy = ShaderID((shadersSourceCodeDir / "base" / "base.vs").string(), {});
-    if (shaderSystem.m_shaderModules.find(vsIdProxy) == shaderSystem.m_shaderModules.cend()) {
+    if (vertShaderStageInfo.module == VK_NULL_HANDLE) {
         AM_ASSERT_GRAPHICS_API_FAIL("Can't find vertex shader module");
         return false;
     }
-    vertShaderStageInfo.module = shaderSystem.m_shaderModules[vsIdProxy];
-    vertShaderStageInfo.pName = "main";
 
     VkPipelineShaderStageCreateInfo pixShaderStageInfo = {};
     pixShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     pixShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    pixShaderStageInfo.module = shaderSystem.FindShaderModule(shaders::base::PS());
+    pixShaderStageInfo.pName = "main";
 
-    ShaderIDProxy psIdProxy = ShaderID((shadersSourceCodeDir / "base" / "base.fs").string(), {});
-    if (shaderSystem.m_shaderModules.find(psIdProxy) == shaderSystem.m_shaderModules.cend()) {
+    if (pixShaderStageInfo.module == VK_NULL_HANDLE) {
         AM_ASSERT_GRAPHICS_API_FAIL("Can't find pixel shader module");
         return false;
-    }    
-    pixShaderStageInfo.module = shaderSystem.m_shaderModules[psIdProxy];
-    pixShaderStageInfo.pName = "main";
+    }
 
     VkPipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo, pixShaderStageInfo };
 
@@ -1624,12 +1867,12 @@ bool VulkanApplication::InitVulkanFramebuffers() noexcept
     AM_LOG_INFO(AM_MAKE_COLORED_TEXT(AM_OUTPUT_COLOR_YELLOW_ASCII_CODE, "Initializing Vulkan framebuffers..."));
 
     const VulkanSwapChain& swapChain = s_pVulkanState->swapChain;
-    const std::vector<VkImageView>& swapChainImageViews = swapChain.imageViews;
+    const auto& swapChainImageViews = swapChain.imageViews;
     const size_t swapChainImageViewsCount = swapChainImageViews.size();
 
     AM_ASSERT_GRAPHICS_API(swapChainImageViewsCount > 0, "There is no any image views in swap chain");
 
-    std::vector<VkFramebuffer>& framebuffers = s_pVulkanState->framebuffers.framebuffers;
+    auto& framebuffers = s_pVulkanState->framebuffers.framebuffers;
     framebuffers.resize(swapChainImageViewsCount);
 
     for (size_t i = 0; i < swapChainImageViewsCount; ++i) {
@@ -1731,6 +1974,7 @@ bool VulkanApplication::InitVulkanCommandBuffers() noexcept
     AM_LOG_INFO(AM_MAKE_COLORED_TEXT(AM_OUTPUT_COLOR_YELLOW_ASCII_CODE, "Initializing Vulkan command buffer..."));
 
     auto& commandBuffArray = s_pVulkanState->commandBufferArray;
+    commandBuffArray.resize(s_pVulkanState->renderConfig.framesInFlight);
 
     VkCommandBufferAllocateInfo commandBufAllocateInfo = {};
     commandBufAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -1738,16 +1982,17 @@ bool VulkanApplication::InitVulkanCommandBuffers() noexcept
     commandBufAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
     commandBufAllocateInfo.commandBufferCount = commandBuffArray.size();
 
-    VkCommandBuffer* commandBuffers[MAX_FRAMES_IN_FLIGHT];
-    for (size_t i = 0; i < commandBuffArray.size(); ++i) {
-        commandBuffers[i] = &commandBuffArray[i].pBuffer;
-    }
+    VkCommandBuffer commandBuffers[AM_VK_MAX_FRAMES_IN_FLIGHT] = {};
 
-    if (vkAllocateCommandBuffers(s_pVulkanState->logicalDevice.pDevice, &commandBufAllocateInfo, *commandBuffers) != VK_SUCCESS) {
+    if (vkAllocateCommandBuffers(s_pVulkanState->logicalDevice.pDevice, &commandBufAllocateInfo, commandBuffers) != VK_SUCCESS) {
         AM_ASSERT_GRAPHICS_API_FAIL("Vulkan command buffer allocation failed");
         return false;
     }
 
+    for (size_t i = 0; i < commandBuffArray.size(); ++i) {
+        commandBuffArray[i].pBuffer = commandBuffers[i];
+    }
+
     AM_LOG_INFO(AM_MAKE_COLORED_TEXT(AM_OUTPUT_COLOR_GREEN_ASCII_CODE, "Vulkan command buffer initialization finished"));
 
     return true;
@@ -1780,6 +2025,7 @@ bool VulkanApplication::InitVulkanSyncObjects() noexcept
     AM_LOG_INFO(AM_MAKE_COLORED_TEXT(AM_OUTPUT_COLOR_YELLOW_ASCII_CODE, "Initializing Vulkan sync objects..."));
 
     auto& syncObjectsArray = s_pVulkanState->syncObjectsArray;
+    syncObjectsArray.resize(s_pVulkanState->renderConfig.framesInFlight);
 
     VkSemaphoreCreateInfo semaphoreCreateInfo = {};
     semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -1831,7 +2077,7 @@ void VulkanApplication::TerminateSyncObjects() noexcept
 }
 
 
-bool VulkanApplication::InitVulkan() noexcept
+bool VulkanApplication::InitVulkan(const AppRenderInitInfo& renderInitInfo) noexcept
 {
     if (IsVulkanInitialized()) {
         AM_LOG_WARN("Vulkan is already initialized");
@@ -1843,6 +2089,7 @@ bool VulkanApplication::InitVulkan() noexcept
     Timer vulkanInitTimer;
 
     s_pVulkanState = std::make_unique<VulkanState>();
+    s_pVulkanState->renderConfig = MakeVulkanRenderConfig(renderInitInfo);
 
     if (!InitVulkanInstance()) {
         return false;
@@ -1864,6 +2111,8 @@ bool VulkanApplication::InitVulkan() noexcept
         return false;
     }
 
+    VulkanShaderSystem::SetOptimizationLevel(s_pVulkanState->renderConfig.shaderOptimizationLevel);
+
     if (!VulkanShaderSystem::Init(s_pVulkanState->logicalDevice.pDevice)) {
         return false;
     }
@@ -1936,7 +2185,11 @@ bool VulkanApplication::IsGLFWWindowCreated() noexcept
 bool VulkanApplication::IsVulkanDebugMessengerInitialized() noexcept
 {
 #if defined(AM_VK_VALIDATION_LAYERS_ENABLED)
-    return s_pVulkanState && s_pVulkanState->intance.pDebugMessenger != VK_NULL_HANDLE;
+    if (!s_pVulkanState) {
+        return false;
+    }
+
+    return !s_pVulkanState->renderConfig.validationEnabled || s_pVulkanState->intance.pDebugMessenger != VK_NULL_HANDLE;
 #else
     return true;
 #endif
@@ -2076,9 +2329,73 @@ bool VulkanApplication::IsVulkanInitialized() noexcept
 }
 
 
+bool VulkanApplication::RebuildVulkanSwapChain(bool forcePipelineRebuild) noexcept
+{
+    AM_LOG_INFO(AM_MAKE_COLORED_TEXT(AM_OUTPUT_COLOR_YELLOW_ASCII_CODE, "Rebuilding Vulkan swap chain..."));
+
+    vkDeviceWaitIdle(s_pVulkanState->logicalDevice.pDevice);
+
+    const VkFormat prevSurfaceFormat = s_pVulkanState->swapChain.desc.currFormat;
+
+    TerminateVulkanFramebuffers();
+    TerminateVulkanSwapChain();
+
+    if (!InitVulkanSwapChain()) {
+        return false;
+    }
+
+    // Render pass attachment format, and so the pipeline, depend on the surface format
+    if (forcePipelineRebuild || s_pVulkanState->swapChain.desc.currFormat != prevSurfaceFormat) {
+        TerminateVulkanGraphicsPipeline();
+        TerminateVulkanRenderPass();
+
+        if (!InitVulkanRenderPass()) {
+            return false;
+        }
+
+        if (!RebuildVulkanGraphicsPipeline()) {
+            return false;
+        }
+    }
+
+    return InitVulkanFramebuffers();
+}
+
+
+bool VulkanApplication::RebuildVulkanGraphicsPipeline() noexcept
+{
+    AM_LOG_INFO(AM_MAKE_COLORED_TEXT(AM_OUTPUT_COLOR_YELLOW_ASCII_CODE, "Rebuilding Vulkan graphics pipeline..."));
+
+    vkDeviceWaitIdle(s_pVulkanState->logicalDevice.pDevice);
+
+    VulkanShaderSystem& shaderSys = VulkanShaderSystem::Instance();
+
+    // Shader modules are released once the pipeline is created, so they are loaded again. Variants of the current
+    // optimization level missing in shader cache are compiled
+    shaderSys.CompileShaders();
+
+    TerminateVulkanGraphicsPipeline();
+    const bool isPipelineInitialized = InitVulkanGraphicsPipeline();
+
+    shaderSys.ClearVulkanShaderModules();
+
+    return isPipelineInitialized;
+}
+
+
 VulkanApplication::VulkanApplication(const VulkanAppInitInfo& appInitInfo)
+    : m_appInitInfo(appInitInfo), m_nextFrameTime(std::chrono::steady_clock::now())
 {
-    
+#if defined(AM_OS_WINDOWS)
+    // Default 15.6 ms timer resolution makes frame rate limiter sleeps useless
+    timeBeginPeriod(1);
+#endif
+
+    // Config is read from the pack if it's mounted, and the pack can't be edited
+    if (!VirtualFileSystem::Instance().IsPackMounted()) {
+        m_configWatcher.AddFile(PathSystem::GetProjectConfigFilepath());
+        m_configWatcher.Start();
+    }
 }
 
 
@@ -2260,13 +2577,116 @@ void VulkanApplication::RenderFrame() noexcept
 
 void VulkanApplication::IncFrameIndex() noexcept
 {
-    m_currentFrameIndex = (m_currentFrameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+    m_currentFrameIndex = (m_currentFrameIndex + 1) % s_pVulkanState->syncObjectsArray.size();
 }
 
 
-VulkanApplication::~VulkanApplication()
+void VulkanApplication::ApplyConfigChanges() noexcept
+{
+    if (!m_configWatcher.HasChangedFiles()) {
+        return;
+    }
+
+    m_configWatcher.TakeChangedFiles();
+
+    const fs::path& configFilepath = PathSystem::GetProjectConfigFilepath();
+
+    // Invalid edits keep the current config, so the file can be fixed without restart
+    std::optional<VulkanAppInitInfo> appInitInfoOpt = ParseAppInitInfoJson(configFilepath);
+    if (!appInitInfoOpt.has_value()) {
+        return;
+    }
+
+    AM_LOG_INFO(AM_MAKE_COLORED_TEXT(AM_OUTPUT_COLOR_YELLOW_ASCII_CODE, "Applying {} changes..."), configFilepath.string().c_str());
+
+    const VulkanAppInitInfo& appInitInfo = appInitInfoOpt.value();
+    const AppRenderInitInfo& renderInitInfo = appInitInfo.renderInitInfo;
+    const AppRenderInitInfo& currRenderInitInfo = m_appInitInfo.renderInitInfo;
+
+    if (appInitInfo.windowInitInfo != m_appInitInfo.windowInitInfo) {
+        AM_LOG_WARN("Window config changes are applied after restart");
+    }
+
+    if (renderInitInfo.framesInFlight != currRenderInitInfo.framesInFlight || renderInitInfo.validationEnabled != currRenderInitInfo.validationEnabled) {
+        AM_LOG_WARN("Frames in flight and validation config changes are applied after restart");
+    }
+
+    if (appInitInfo.loggingInitInfo != m_appInitInfo.loggingInitInfo) {
+        ApplyLoggingConfig(appInitInfo.loggingInitInfo);
+    }
+
+    VulkanRenderConfig& renderConfig = s_pVulkanState->renderConfig;
+    VulkanRenderConfig newRenderConfig = MakeVulkanRenderConfig(renderInitInfo);
+
+    // Per frame objects and instance layers are created once
+    newRenderConfig.framesInFlight = renderConfig.framesInFlight;
+    newRenderConfig.validationEnabled = renderConfig.validationEnabled;
+
+    const bool shouldRebuildSwapChain = renderInitInfo.presentMode != currRenderInitInfo.presentMode
+        || renderInitInfo.surfaceFormats != currRenderInitInfo.surfaceFormats
+        || renderInitInfo.swapChainImagesCount != currRenderInitInfo.swapChainImagesCount;
+
+    const bool shouldRebuildPipeline = newRenderConfig.shaderOptimizationLevel != renderConfig.shaderOptimizationLevel;
+
+    renderConfig = std::move(newRenderConfig);
+    VulkanShaderSystem::SetOptimizationLevel(renderConfig.shaderOptimizationLevel);
+
+    bool isRebuilt = true;
+
+    if (shouldRebuildSwapChain) {
+        isRebuilt = RebuildVulkanSwapChain(shouldRebuildPipeline);
+    } else if (shouldRebuildPipeline) {
+        isRebuilt = RebuildVulkanGraphicsPipeline();
+    }
+
+    if (!isRebuilt) {
+        AM_ASSERT_GRAPHICS_API_FAIL("Failed to rebuild Vulkan objects after render config change");
+    }
+
+    // Frame rate limit is read from the config every frame
+    m_appInitInfo = std::move(appInitInfoOpt.value());
+
+    AM_LOG_INFO(AM_MAKE_COLORED_TEXT(AM_OUTPUT_COLOR_GREEN_ASCII_CODE, "Applying {} changes finished"), configFilepath.string().c_str());
+}
+
+
+void VulkanApplication::LimitFrameRate() noexcept
 {
+    using Clock = std::chrono::steady_clock;
+
+    const uint32_t frameRateLimit = m_appInitInfo.renderInitInfo.frameRateLimit;
+    const Clock::time_point now = Clock::now();
+
+    if (frameRateLimit == 0) {
+        m_nextFrameTime = now;
+        return;
+    }
+
+    const Clock::duration frameDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / frameRateLimit));
+
+    // Late frames restart the pacing instead of making the next frames catch up
+    m_nextFrameTime = std::max(m_nextFrameTime + frameDuration, now);
+
+    // Sleep may overshoot by a scheduler tick even with 1 ms timer resolution, so the rest of the frame time is spun out
+    static constexpr std::chrono::milliseconds SPIN_WAIT_DURATION(2);
     
+    const Clock::time_point sleepEndTime = m_nextFrameTime - SPIN_WAIT_DURATION;
+
+    if (now < sleepEndTime) {
+        std::this_thread::sleep_until(sleepEndTime);
+    }
+
+    while (Clock::now() < m_nextFrameTime) {
+        std::this_thread::yield();
+    }
+}
+
+
+VulkanApplication::~VulkanApplication()
+{
+#if defined(AM_OS_WINDOWS)
+    timeEndPeriod(1);
+#endif
 }
 
 
@@ -1,10 +1,18 @@
 #pragma once
 
 #include <string>
+#include <chrono>
 #include <cstdint>
 
 #include "core.h"
 
+#include "utils/data_structures/small_vector.h"
+#include "utils/data_structures/fixed_vector.h"
+#include "utils/json/json_schema.h"
+#include "utils/file/file_watcher.h"
+
+#include "shader_system/shader_system.h"
+
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
@@ -15,21 +23,59 @@
 #include <GLFW/glfw3native.h>
 
 
-struct AppWindowInitInfo
-{
-    std::string title = {};
+// Inline capacities of per device and per swap chain Vulkan object lists. Bigger lists spill to the heap
+static inline constexpr size_t AM_VK_INLINE_SURFACE_FORMATS_COUNT = 16;
+static inline constexpr size_t AM_VK_INLINE_PRESENT_MODES_COUNT = 8;
+static inline constexpr size_t AM_VK_INLINE_SWAP_CHAIN_IMAGES_COUNT = 8;
+static inline constexpr size_t AM_VK_INLINE_SURFACE_FORMAT_PREFERENCES_COUNT = 4;
 
-    uint32_t width = 0;
-    uint32_t height = 0;
-    
-    bool resizable = false;
-};
+// Upper bound of render.frames_in_flight config value. Per frame objects are stored inline
+static inline constexpr size_t AM_VK_MAX_FRAMES_IN_FLIGHT = 4;
 
 
-struct VulkanAppInitInfo
-{
-    AppWindowInitInfo windowInitInfo;
-};
+// app_config.json schema
+#define AM_APP_WINDOW_INIT_INFO_SCHEMA(FIELD)           \
+    FIELD(std::string,  title,      "title")            \
+    FIELD(uint32_t,     width,      "width")            \
+    FIELD(uint32_t,     height,     "height")           \
+    FIELD(bool,         resizable,  "resizable")
+
+AM_JSON_SCHEMA_STRUCT(AppWindowInitInfo, AM_APP_WINDOW_INIT_INFO_SCHEMA);
+
+
+// present_mode: "immediate", "mailbox", "fifo" or "fifo_relaxed". Falls back to "fifo" if not supported
+// surface_formats: preferred formats in priority order, e.g. "B8G8R8A8_SRGB". Falls back to the first available format
+// swap_chain_images_count: 0 requests one image more than the surface minimum
+// validation: enables validation layers in builds with AM_VK_VALIDATION_LAYERS_ENABLED only
+// frame_rate_limit: 0 disables the limit
+// shader_optimization_level: "none", "speed", "size" or "default" for the build default
+//
+// Edits are applied while running except for frames_in_flight and validation, which need restart
+#define AM_APP_RENDER_INIT_INFO_SCHEMA(FIELD)                                                 \
+    FIELD(std::string,              presentMode,              "present_mode")                 \
+    FIELD(std::vector<std::string>, surfaceFormats,           "surface_formats")              \
+    FIELD(uint32_t,                 framesInFlight,           "frames_in_flight")             \
+    FIELD(uint32_t,                 swapChainImagesCount,     "swap_chain_images_count")      \
+    FIELD(bool,                     validationEnabled,        "validation")                   \
+    FIELD(uint32_t,                 frameRateLimit,           "frame_rate_limit")             \
+    FIELD(std::string,              shaderOptimizationLevel,  "shader_optimization_level")
+
+AM_JSON_SCHEMA_STRUCT(AppRenderInitInfo, AM_APP_RENDER_INIT_INFO_SCHEMA);
+
+
+// level: "info", "warn", "error" or "off"
+#define AM_APP_LOGGING_INIT_INFO_SCHEMA(FIELD)          \
+    FIELD(std::string,  level,      "level")
+
+AM_JSON_SCHEMA_STRUCT(AppLoggingInitInfo, AM_APP_LOGGING_INIT_INFO_SCHEMA);
+
+
+#define AM_VULKAN_APP_INIT_INFO_SCHEMA(FIELD)                   \
+    FIELD(AppWindowInitInfo,    windowInitInfo,     "window")   \
+    FIELD(AppRenderInitInfo,    renderInitInfo,     "render")   \
+    FIELD(AppLoggingInitInfo,   loggingInitInfo,    "logging")
+
+AM_JSON_SCHEMA_STRUCT(VulkanAppInitInfo, AM_VULKAN_APP_INIT_INFO_SCHEMA);
 
 
 struct VulkanQueueFamilyIndices
@@ -58,6 +104,18 @@ struct VulkanQueueFamilyIndices
 };
 
 
+// Render config resolved to Vulkan values
+struct VulkanRenderConfig
+{
+    ds::SmallVector<VkSurfaceFormatKHR, AM_VK_INLINE_SURFACE_FORMAT_PREFERENCES_COUNT> surfaceFormats;
+    VkPresentModeKHR                                                                    presentMode;
+    uint32_t                                                                            framesInFlight;
+    uint32_t                                                                            swapChainImagesCount;
+    ShaderOptimizationLevel                                                             shaderOptimizationLevel;
+    bool                                                                                validationEnabled;
+};
+
+
 struct VulkanInstance
 {
     VkInstance pInstance;
@@ -106,21 +164,21 @@ struct VulkanSwapChainDesc
 {
     bool IsValid() const noexcept { return !formats.empty() && !presentModes.empty(); }
 
-    VkSurfaceCapabilitiesKHR        capabilities;
-    std::vector<VkSurfaceFormatKHR> formats;
-    std::vector<VkPresentModeKHR>   presentModes;
+    VkSurfaceCapabilitiesKHR                                                capabilities;
+    ds::SmallVector<VkSurfaceFormatKHR, AM_VK_INLINE_SURFACE_FORMATS_COUNT> formats;
+    ds::SmallVector<VkPresentModeKHR, AM_VK_INLINE_PRESENT_MODES_COUNT>     presentModes;
 
-    VkFormat                        currFormat;
-    VkExtent2D                      currExtent;
+    VkFormat                                                                currFormat;
+    VkExtent2D                                                              currExtent;
 };
 
 
 struct VulkanSwapChain
 {
-    VulkanSwapChainDesc      desc;
-    std::vector<VkImage>     images;
-    std::vector<VkImageView> imageViews;
-    VkSwapchainKHR           pSwapChain;
+    VulkanSwapChainDesc                                                 desc;
+    ds::SmallVector<VkImage, AM_VK_INLINE_SWAP_CHAIN_IMAGES_COUNT>      images;
+    ds::SmallVector<VkImageView, AM_VK_INLINE_SWAP_CHAIN_IMAGES_COUNT>  imageViews;
+    VkSwapchainKHR                                                      pSwapChain;
 };
 
 
@@ -141,7 +199,7 @@ struct VulkanFramebuffers
 {
     bool IsValid() const noexcept;
 
-    std::vector<VkFramebuffer> framebuffers;
+    ds::SmallVector<VkFramebuffer, AM_VK_INLINE_SWAP_CHAIN_IMAGES_COUNT> framebuffers;
 };
 
 
@@ -184,6 +242,9 @@ public:
 
     static bool IsInitialized() noexcept;
 
+    // Packs shaders and configs into the assets pack which is mounted by release builds. Doesn't require Init
+    static bool BuildAssetsPack() noexcept;
+
     VulkanApplication(const VulkanApplication& app) = delete;
     VulkanApplication& operator=(const VulkanApplication& app) = delete;
     
@@ -234,9 +295,14 @@ private:
     static bool InitVulkanSyncObjects() noexcept;
     static void TerminateSyncObjects() noexcept;
 
-    static bool InitVulkan() noexcept;
+    static bool InitVulkan(const AppRenderInitInfo& renderInitInfo) noexcept;
     static void TerminateVulkan() noexcept;
 
+    // Recreates the swap chain with the current render config. Render pass and graphics pipeline are recreated
+    // only if the surface format changed or forcePipelineRebuild is set
+    static bool RebuildVulkanSwapChain(bool forcePipelineRebuild) noexcept;
+    static bool RebuildVulkanGraphicsPipeline() noexcept;
+
     static bool IsGLFWWindowCreated() noexcept;
 
     static bool IsVulkanDebugMessengerInitialized() noexcept;
@@ -265,13 +331,16 @@ private:
     void RenderFrame() noexcept;
     void IncFrameIndex() noexcept;
 
-private:
-    static constexpr inline size_t MAX_FRAMES_IN_FLIGHT = 2;
+    // Must be called at a frame boundary
+    void ApplyConfigChanges() noexcept;
+    void LimitFrameRate() noexcept;
 
+private:
     static inline GLFWwindow* s_pGLFWWindow = nullptr;
 
     struct VulkanState
     {
+        VulkanRenderConfig      renderConfig;
         VulkanInstance          intance;
         VulkanPhysicalDevice    physicalDevice;
         VulkanLogicalDevice     logicalDevice;
@@ -282,13 +351,19 @@ private:
         VulkanFramebuffers      framebuffers;
         VulkanCommandPool       commandPool;
 
-        std::array<VulkanCommandBuffer, MAX_FRAMES_IN_FLIGHT> commandBufferArray;
-        std::array<VulkanSyncObjects,   MAX_FRAMES_IN_FLIGHT> syncObjectsArray;
+        // Sized to renderConfig.framesInFlight
+        ds::FixedVector<VulkanCommandBuffer, AM_VK_MAX_FRAMES_IN_FLIGHT> commandBufferArray;
+        ds::FixedVector<VulkanSyncObjects,   AM_VK_MAX_FRAMES_IN_FLIGHT> syncObjectsArray;
     };
     static inline std::unique_ptr<VulkanState> s_pVulkanState = nullptr;
 
     static inline std::unique_ptr<VulkanApplication> s_pAppInst = nullptr;
 
 private:
+    VulkanAppInitInfo m_appInitInfo;
+    FileWatcher m_configWatcher;
+
+    std::chrono::steady_clock::time_point m_nextFrameTime;
+
     size_t m_currentFrameIndex = 0;
 };
\ No newline at end of file
@@ -33,6 +33,10 @@
   #define AM_VK_VALIDATION_LAYERS_ENABLED
 #endif
 
+#if defined(AM_DEBUG)
+  #define AM_STRID_COLLISION_CHECK_ENABLED
+#endif
+
 
 #if defined(_MSC_VER)
   #define AM_DEBUG_BREAK() __debugbreak()
@@ -1,8 +1,14 @@
 #include "application/vk_application.h"
 
+#include <cstring>
+
 
 int main(int argc, char* argv[])
 {   
+    if (argc > 1 && strcmp(argv[1], "--build-assets-pack") == 0) {
+        return VulkanApplication::BuildAssetsPack() ? 0 : -1;
+    }
+
     if (!VulkanApplication::Init()) {
         exit(-1);
     }
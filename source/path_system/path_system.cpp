@@ -5,6 +5,21 @@
 #include "utils/debug/assertion.h"
 
 
+static fs::path GetExecutableDirectory() noexcept
+{
+#if defined(AM_OS_WINDOWS)
+    wchar_t executableFilepath[MAX_PATH] = {};
+    const DWORD length = GetModuleFileNameW(nullptr, executableFilepath, MAX_PATH);
+
+    if (length > 0 && length < MAX_PATH) {
+        return fs::path(executableFilepath).parent_path();
+    }
+#endif
+
+    return fs::path();
+}
+
+
 bool PathSystem::Init() noexcept
 {
     if (IsInitialized()) {
@@ -22,6 +37,13 @@ bool PathSystem::Init() noexcept
     s_projectBinaryOutputDirPath        = AM_PROJECT_BINARY_OUTPUT_DIR;
     s_projectShaderCacheDirPath         = s_projectBinaryOutputDirPath / "shader_cache";
     s_projectShaderCacheFilepath        = s_projectShaderCacheDirPath / "shader_cache.spv";
+    s_projectShaderSetupManifestFilepath = s_projectShaderCacheDirPath / "shader_setup_manifest.bin";
+    s_projectStrIDTableFilepath         = s_projectBinaryOutputDirPath / "strid_table.bin";
+    s_projectFileFingerprintDBFilepath  = s_projectBinaryOutputDirPath / "file_fingerprints.bin";
+    // Pack is shipped next to the executable, so unlike the other paths its location isn't baked in at compile time
+    const fs::path executableDirPath    = GetExecutableDirectory();
+    s_projectAssetsPackFilepath         = (executableDirPath.empty() ? s_projectBinaryOutputDirPath : executableDirPath) / "assets.pack";
+    s_projectJsonCacheFilepath          = s_projectBinaryOutputDirPath / "json_cache.bin";
 
     if (!PrecreateOutputDirectories()) {
         return false;
@@ -89,6 +111,41 @@ fs::path PathSystem::GetProjectShaderCacheFilepath() noexcept
 }
 
 
+fs::path PathSystem::GetProjectShaderSetupManifestFilepath() noexcept
+{
+    AM_ASSERT(IsInitialized(), "Path system is not initialized");
+    return s_projectShaderSetupManifestFilepath;
+}
+
+
+fs::path PathSystem::GetProjectStrIDTableFilepath() noexcept
+{
+    AM_ASSERT(IsInitialized(), "Path system is not initialized");
+    return s_projectStrIDTableFilepath;
+}
+
+
+fs::path PathSystem::GetProjectFileFingerprintDBFilepath() noexcept
+{
+    AM_ASSERT(IsInitialized(), "Path system is not initialized");
+    return s_projectFileFingerprintDBFilepath;
+}
+
+
+fs::path PathSystem::GetProjectAssetsPackFilepath() noexcept
+{
+    AM_ASSERT(IsInitialized(), "Path system is not initialized");
+    return s_projectAssetsPackFilepath;
+}
+
+
+fs::path PathSystem::GetProjectJsonCacheFilepath() noexcept
+{
+    AM_ASSERT(IsInitialized(), "Path system is not initialized");
+    return s_projectJsonCacheFilepath;
+}
+
+
 bool PathSystem::PrecreateOutputDirectories() noexcept
 {
     const auto CreateDirectoryIfNotExists = [](const fs::path& dirPath) -> bool
@@ -18,6 +18,12 @@ public:
     static fs::path GetProjectBinaryOutputDirectory() noexcept;
     static fs::path GetProjectShaderCacheDirectory() noexcept;
     static fs::path GetProjectShaderCacheFilepath() noexcept;
+    static fs::path GetProjectShaderSetupManifestFilepath() noexcept;
+    static fs::path GetProjectStrIDTableFilepath() noexcept;
+    static fs::path GetProjectFileFingerprintDBFilepath() noexcept;
+    // Next to the executable
+    static fs::path GetProjectAssetsPackFilepath() noexcept;
+    static fs::path GetProjectJsonCacheFilepath() noexcept;
 
     static fs::path GetProjectConfigDirectory() noexcept;
     static fs::path GetProjectConfigFilepath() noexcept;
@@ -45,6 +51,11 @@ private:
     static inline fs::path s_projectBinaryOutputDirPath;
     static inline fs::path s_projectShaderCacheDirPath;
     static inline fs::path s_projectShaderCacheFilepath;
+    static inline fs::path s_projectShaderSetupManifestFilepath;
+    static inline fs::path s_projectStrIDTableFilepath;
+    static inline fs::path s_projectFileFingerprintDBFilepath;
+    static inline fs::path s_projectAssetsPackFilepath;
+    static inline fs::path s_projectJsonCacheFilepath;
 
     static inline bool s_isInitialized = false;
 };
\ No newline at end of file
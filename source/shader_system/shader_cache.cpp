@@ -1,23 +1,78 @@
 #include "pch.h"
 
 #include "shader_cache.h"
+#include "shader_system.h"
 
 #include "utils/debug/assertion.h"
 #include "utils/file/file.h"
+#include "utils/file/async_file_writer.h"
 
 
 static constexpr size_t AM_SHADER_CACHE_SUBMITION_PREALLOCATION_SIZE = 4 << 20;
 
+static constexpr uint32_t AM_SHADER_CACHE_MAGIC   = 0x43534D41; // 'AMSC'
+
+// Bump when the layout or ShaderID hashing changes, entries keyed by old hashes are never looked up again
+static constexpr uint32_t AM_SHADER_CACHE_VERSION = 2;
+
+
+// Shader cache structure:
+//      4 bytes - magic
+//      4 bytes - version
+//      4 bytes - cache entries count
+//      Cache entries:
+//           4 bytes - code size
+//           8 bytes - hash
+//         ... bytes - code
+struct VulkanShaderCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entriesCount;
+};
+
+
+static constexpr size_t AM_SHADER_CACHE_ENTRY_HEADER_SIZE = sizeof(uint32_t) + sizeof(ShaderIDProxy);
+
+
+static void WriteShaderCacheHeader(std::vector<uint8_t>& storage) noexcept
+{
+    VulkanShaderCacheHeader header = {};
+    header.magic = AM_SHADER_CACHE_MAGIC;
+    header.version = AM_SHADER_CACHE_VERSION;
+    header.entriesCount = 0;
+
+    storage.resize(sizeof(header));
+    memcpy_s(storage.data(), storage.size(), &header, sizeof(header));
+}
+
+
+static void WriteShaderCacheEntry(std::vector<uint8_t>& storage, ShaderIDProxy idProxy, const uint8_t* pShaderCompiledCode, size_t codeSize) noexcept
+{
+    if (storage.empty()) {
+        WriteShaderCacheHeader(storage);
+    }
+
+    const size_t oldStorageSize = storage.size();
+    storage.resize(oldStorageSize + AM_SHADER_CACHE_ENTRY_HEADER_SIZE + codeSize);
+
+    uint8_t* pCacheEntrySizeBuffer = storage.data() + oldStorageSize;
+    const uint32_t codeSizeU32 = static_cast<uint32_t>(codeSize);
+    memcpy_s(pCacheEntrySizeBuffer, sizeof(uint32_t), &codeSizeU32, sizeof(uint32_t));
+
+    uint8_t* pShaderHashIdBuffer = pCacheEntrySizeBuffer + sizeof(uint32_t);
+    memcpy_s(pShaderHashIdBuffer, sizeof(ShaderIDProxy), &idProxy, sizeof(ShaderIDProxy));
+
+    uint8_t* pShaderCodeBuffer = pShaderHashIdBuffer + sizeof(ShaderIDProxy);
+    memcpy_s(pShaderCodeBuffer, codeSize, pShaderCompiledCode, codeSize);
+
+    VulkanShaderCacheHeader* pHeader = reinterpret_cast<VulkanShaderCacheHeader*>(storage.data());
+    ++pHeader->entriesCount;
+}
+
 
 bool VulkanShaderCache::Load(const fs::path& shaderCacheFilepath) noexcept
 {
-    // Shader cache structure:
-    //      4 bytes - cache entries count
-    //      Cache entries:
-    //           4 bytes - code size
-    //           8 bytes - hash
-    //         ... bytes - code
-    
     Clear();
 
     m_cacheStorage.reserve(AM_SHADER_CACHE_SUBMITION_PREALLOCATION_SIZE);
@@ -28,14 +83,29 @@ bool VulkanShaderCache::Load(const fs::path& shaderCacheFilepath) noexcept
         return false;
     }
 
+    VulkanShaderCacheHeader header = {};
+
+    if (m_cacheStorage.size() >= sizeof(header)) {
+        memcpy_s(&header, sizeof(header), m_cacheStorage.data(), sizeof(header));
+    }
+
+    if (header.magic != AM_SHADER_CACHE_MAGIC || header.version != AM_SHADER_CACHE_VERSION) {
+        AM_LOG_GRAPHICS_API_WARN("Shader cache {} is outdated and will be rebuilt", shaderCacheFilepath.string().c_str());
+        Clear();
+        return false;
+    }
+
     const uint8_t* pStorageBeginU8  = m_cacheStorage.data();
     const uint8_t* pStorageEndU8    = m_cacheStorage.data() + m_cacheStorage.size();
 
-    const uint32_t cacheEntryCount = *((const uint32_t*)pStorageBeginU8);
-    m_cacheLocations.reserve(cacheEntryCount * 2);
+    m_cacheLocations.reserve(header.entriesCount);
 
-    const uint8_t* pCacheEntry = pStorageBeginU8 + sizeof(uint32_t);
+    const uint8_t* pCacheEntry = pStorageBeginU8 + sizeof(header);
     while (pCacheEntry < pStorageEndU8) {
+        if (static_cast<size_t>(pStorageEndU8 - pCacheEntry) < AM_SHADER_CACHE_ENTRY_HEADER_SIZE) {
+            break;
+        }
+
         uint32_t cacheEntrySize = 0;
         memcpy_s(&cacheEntrySize, sizeof(uint32_t), pCacheEntry, sizeof(uint32_t));
 
@@ -46,15 +116,26 @@ bool VulkanShaderCache::Load(const fs::path& shaderCacheFilepath) noexcept
 
         pCacheEntry += sizeof(ShaderIDProxy);
 
+        if (static_cast<size_t>(pStorageEndU8 - pCacheEntry) < cacheEntrySize) {
+            break;
+        }
+
         VulkanShaderCacheEntryLocation entryLocation;
         entryLocation.beginPosition = pCacheEntry - pStorageBeginU8;
         entryLocation.sizeInU8 = cacheEntrySize;
+        entryLocation.isReferenced = false;
 
         m_cacheLocations[id] = entryLocation;
 
         pCacheEntry += cacheEntrySize;
     }
 
+    if (pCacheEntry != pStorageEndU8) {
+        AM_LOG_GRAPHICS_API_WARN("Shader cache {} is corrupted and will be rebuilt", shaderCacheFilepath.string().c_str());
+        Clear();
+        return false;
+    }
+
     return true;
 }
 
@@ -134,30 +215,86 @@ void VulkanShaderCache::AddCacheEntryToSubmitBuffer(ShaderIDProxy idProxy, const
     AM_ASSERT_GRAPHICS_API(pShaderCompiledCode != nullptr, "pShaderCompiledCode is nullptr");
     AM_ASSERT_GRAPHICS_API(codeSize != 0, "Compiled code size is 0. Cache entry {}", idProxy.Hash());
 
-    const size_t oldStorageSize = m_cacheStorage.empty() ? sizeof(uint32_t) : m_cacheStorage.size();
-    const size_t newStorageSize = oldStorageSize + sizeof(uint32_t) + sizeof(ShaderIDProxy) + codeSize;
+    WriteShaderCacheEntry(m_cacheStorage, idProxy, pShaderCompiledCode, codeSize);
 
-    m_cacheStorage.resize(newStorageSize);
+    // Recompiled entry replaces the previous one, whose code stays in the storage until the next Submit
+    VulkanShaderCacheEntryLocation entryLocation;
+    entryLocation.beginPosition = m_cacheStorage.size() - codeSize;
+    entryLocation.sizeInU8 = codeSize;
+    entryLocation.isReferenced = true;
 
-    uint8_t* pStorageBeginU8  = m_cacheStorage.data();
+    m_cacheLocations[idProxy] = entryLocation;
+}
 
-    uint8_t* pCacheEntrySizeBuffer = pStorageBeginU8 + oldStorageSize;
-    memcpy_s(pCacheEntrySizeBuffer, sizeof(uint32_t), &codeSize, sizeof(uint32_t));
 
-    uint8_t* pShaderHashIdBuffer = pCacheEntrySizeBuffer + sizeof(uint32_t);
-    memcpy_s(pShaderHashIdBuffer, sizeof(ShaderIDProxy), &idProxy, sizeof(ShaderIDProxy));
+void VulkanShaderCache::ResetReferences() noexcept
+{
+    for (auto& [idProxy, location] : m_cacheLocations) {
+        location.isReferenced = false;
+    }
+}
 
-    uint8_t* pShaderCodeBuffer = pShaderHashIdBuffer + sizeof(ShaderIDProxy);
-    memcpy_s(pShaderCodeBuffer, codeSize, pShaderCompiledCode, codeSize);
 
-    uint32_t& cacheEntryCount = *((uint32_t*)pStorageBeginU8);
-    ++cacheEntryCount;
+void VulkanShaderCache::MarkReferenced(const ShaderID& id) noexcept
+{
+    // Variants built with other optimization levels are kept too, so switching the level back doesn't recompile everything
+    for (uint32_t level = 0; level < SHADER_OPTIMIZATION_LEVEL_COUNT; ++level) {
+        const auto locationIt = m_cacheLocations.find(ShaderIDProxy(id.HashForOptimizationLevel(level)));
+
+        if (locationIt != m_cacheLocations.end()) {
+            locationIt->second.isReferenced = true;
+        }
+    }
+}
+
+
+bool VulkanShaderCache::HasUnreferencedEntries() const noexcept
+{
+    for (const auto& [idProxy, location] : m_cacheLocations) {
+        if (!location.isReferenced) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 
 void VulkanShaderCache::Submit(const fs::path &shaderCacheFilepath) noexcept
 {
-    WriteBinaryFile(shaderCacheFilepath, m_cacheStorage.data(), m_cacheStorage.size());
+    // Storage is compacted to the referenced entries, so code of replaced and unused entries doesn't pile up between loads
+    std::vector<uint8_t> compactedStorage;
+    compactedStorage.reserve(m_cacheStorage.size());
+
+    // Header is written even if there are no entries, so an empty cache is still a valid one
+    WriteShaderCacheHeader(compactedStorage);
+
+    ds::FlatHashMap<ShaderIDProxy, VulkanShaderCacheEntryLocation> compactedLocations;
+    compactedLocations.reserve(m_cacheLocations.size());
+
+    for (const auto& [idProxy, location] : m_cacheLocations) {
+        if (!location.isReferenced) {
+            continue;
+        }
+
+        WriteShaderCacheEntry(compactedStorage, idProxy, m_cacheStorage.data() + location.beginPosition, location.sizeInU8);
+
+        VulkanShaderCacheEntryLocation compactedLocation = location;
+        compactedLocation.beginPosition = compactedStorage.size() - location.sizeInU8;
+
+        compactedLocations[idProxy] = compactedLocation;
+    }
+
+    m_cacheStorage = std::move(compactedStorage);
+    m_cacheLocations = std::move(compactedLocations);
+
+    if (!AsyncFileWriter::IsInitialized()) {
+        WriteBinaryFile(shaderCacheFilepath, m_cacheStorage.data(), m_cacheStorage.size());
+        return;
+    }
+
+    // Storage keeps growing with new entries, so the writer gets its own snapshot. Copying is much cheaper than the disk write
+    AsyncFileWriter::Instance().WriteFileAsync(shaderCacheFilepath, std::vector<uint8_t>(m_cacheStorage));
 }
 
 
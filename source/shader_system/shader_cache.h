@@ -1,8 +1,7 @@
 #pragma once
 
-#include <unordered_map>
-
 #include "utils/file/file.h"
+#include "utils/data_structures/flat_hash_map.h"
 #include "shaderid.h"
 
 
@@ -24,9 +23,11 @@ private:
     {
         size_t beginPosition;
         size_t sizeInU8;
+        bool isReferenced;
     };
 
 public:
+    // Returns false if there is no cache file or it was written with a different layout or shader ID hashing
     bool Load(const fs::path& shaderCacheFilepath) noexcept;
     void Clear() noexcept;
 
@@ -39,6 +40,12 @@ public:
     VulkanShaderCompiledCodeBuffer GetShaderPrecompiledCode(uint64_t shaderHash) const noexcept;
     VulkanShaderCompiledCodeBuffer GetShaderPrecompiledCode(const ShaderID& id) const noexcept;
 
+    // Entries are referenced by loading or adding them. Submit stores the referenced entries only, so entries of removed shaders
+    // and outdated shader IDs are dropped from the cache file. Marking a shader references its entries of every optimization level
+    void ResetReferences() noexcept;
+    void MarkReferenced(const ShaderID& id) noexcept;
+    bool HasUnreferencedEntries() const noexcept;
+
     void AddCacheEntryToSubmitBuffer(const ShaderID& id, const std::vector<uint8_t>& shaderCompiledCode) noexcept;
     void AddCacheEntryToSubmitBuffer(const ShaderID& id, const uint8_t* pShaderCompiledCode, size_t codeSize) noexcept;
     void AddCacheEntryToSubmitBuffer(ShaderIDProxy idProxy, const uint8_t* pShaderCompiledCode, size_t codeSize) noexcept;
@@ -52,7 +59,7 @@ private:
     VulkanShaderCompiledCodeBuffer GetShaderPrecompiledCode(const VulkanShaderCacheEntryLocation& location) const noexcept;
 
 private:
-    std::unordered_map<ShaderIDProxy, VulkanShaderCacheEntryLocation> m_cacheLocations;
+    ds::FlatHashMap<ShaderIDProxy, VulkanShaderCacheEntryLocation> m_cacheLocations;
     std::vector<uint8_t> m_cacheStorage;
 };
 
@@ -7,7 +7,11 @@
 
 #include "utils/debug/assertion.h"
 #include "utils/file/file.h"
-#include "utils/json/json.h"
+#include "utils/file/mapped_file.h"
+#include "utils/file/async_file_io.h"
+#include "utils/file/async_file_writer.h"
+#include "utils/file/virtual_file_system.h"
+#include "utils/json/json_schema.h"
 
 #include <shaderc/shaderc.hpp>
 
@@ -22,8 +26,11 @@ static const fs::path AM_VERTEX_SHADER_EXTENSIONS[] = { ".vs", ".vsh", ".vert",
 static const fs::path AM_PIXEL_SHADER_EXTENSIONS[]  = { ".ps", ".fs", ".psh", ".frag", ".glsl" };
 
 
-static constexpr uint32_t AM_VERTEX_SHADER_MASK = 0x1;
-static constexpr uint32_t AM_PIXEL_SHADER_MASK  = 0x2;
+static_assert(AM_SHADER_VARIANT_KEY_MAX_DEFINES_COUNT <= ShaderID::MAX_SHADER_DEFINES_COUNT, "ShaderID must be able to store all shader variant key define bits");
+
+
+static constexpr uint32_t AM_SHADER_SETUP_MANIFEST_MAGIC   = 0x4D53534D; // 'MSSM'
+static constexpr uint32_t AM_SHADER_SETUP_MANIFEST_VERSION = 2;
 
 
 static shaderc::Compiler g_shadercCompiler;
@@ -35,15 +42,120 @@ static shaderc::Compiler g_shadercCompiler;
     static constexpr ShaderOptimizationLevel g_shaderOptimaizationLevelValue = SHADER_OPTIMIZATION_LEVEL_SPEED; 
 #endif
 
+// Build default can be overridden by render config
+static ShaderOptimizationLevel g_shaderOptimizationLevel = g_shaderOptimaizationLevelValue;
+
+
+// Binary snapshot of the discovered shader groups and their parsed setups.
+// Lets warm startups skip shaders directory iteration and setup JSON parsing.
+// Shader group files are validated by content hash from FileFingerprintDB, so touched but unchanged files keep the manifest valid.
+//
+// Shader setup manifest structure:
+//      4 bytes - magic
+//      4 bytes - version
+//      8 bytes - shaders root directory write time
+//      4 bytes - groups count
+//      Groups:
+//           8 bytes - group directory write time
+//          16 bytes - setup file content hash
+//          16 bytes - vertex shader file content hash
+//          16 bytes - pixel shader file content hash
+//         ... bytes - group directory, setup, vertex and pixel shader filepaths (4 bytes length + chars)
+//           4 bytes - defines count
+//           Defines:
+//               4 bytes - shader type mask
+//             ... bytes - name and condition (4 bytes length + chars)
+class ShaderSetupManifestWriter
+{
+public:
+    template <typename T>
+    void Write(const T& value) noexcept
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be written to shader setup manifest");
+        
+        const size_t offset = m_buffer.size();
+        m_buffer.resize(offset + sizeof(T));
+        memcpy_s(m_buffer.data() + offset, sizeof(T), &value, sizeof(T));
+    }
+
+    void Write(std::string_view str) noexcept
+    {
+        Write(static_cast<uint32_t>(str.size()));
+        m_buffer.insert(m_buffer.end(), str.begin(), str.end());
+    }
+
+    std::vector<uint8_t> ReleaseBuffer() noexcept { return std::move(m_buffer); }
+
+private:
+    std::vector<uint8_t> m_buffer;
+};
+
+
+class ShaderSetupManifestReader
+{
+public:
+    ShaderSetupManifestReader(const FileView& buffer)
+        : m_pCurr(buffer.data()), m_pEnd(buffer.data() + buffer.size()) {}
+
+    template <typename T>
+    bool Read(T& value) noexcept
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be read from shader setup manifest");
+
+        if (m_pCurr + sizeof(T) > m_pEnd) {
+            return false;
+        }
+
+        memcpy_s(&value, sizeof(T), m_pCurr, sizeof(T));
+        m_pCurr += sizeof(T);
+
+        return true;
+    }
+
+    bool Read(std::string& str) noexcept
+    {
+        uint32_t length = 0;
+        if (!Read(length) || m_pCurr + length > m_pEnd) {
+            return false;
+        }
+
+        str.assign(reinterpret_cast<const char*>(m_pCurr), length);
+        m_pCurr += length;
+
+        return true;
+    }
+
+    bool IsEnd() const noexcept { return m_pCurr == m_pEnd; }
+
+private:
+    const uint8_t* m_pCurr = nullptr;
+    const uint8_t* m_pEnd = nullptr;
+};
+
 
 struct VulkanShaderGroupFilepaths
 {
+    ds::StrID groupDirpath;
     ds::StrID setupFilepath;
     ds::StrID vsFilepath;
     ds::StrID psFilepath;
 };
 
 
+// setup.json schema
+#define AM_SHADER_DEFINE_CONFIG_SCHEMA(FIELD)                                                  \
+    FIELD(std::vector<std::string>, types,     JSON_SHADER_SETUP_DEFINES_TYPE_FIELD_NAME)      \
+    FIELD(std::string,              condition, JSON_SHADER_SETUP_DEFINES_CONDITION_FIELD_NAME)
+
+AM_JSON_SCHEMA_STRUCT(ShaderDefineConfig, AM_SHADER_DEFINE_CONFIG_SCHEMA);
+
+
+#define AM_SHADER_SETUP_CONFIG_SCHEMA(FIELD)                                                   \
+    FIELD(amjson::JsonMap<ShaderDefineConfig>, defines, JSON_SHADER_SETUP_DEFINES_FIELD_NAME)
+
+AM_JSON_SCHEMA_STRUCT(ShaderSetupConfig, AM_SHADER_SETUP_CONFIG_SCHEMA);
+
+
 struct VulkanShaderDefine
 {
     bool IsVertex() const noexcept { return (shaderTypeMask & AM_VERTEX_SHADER_MASK) != 0; }
@@ -58,7 +170,7 @@ struct VulkanShaderDefine
 class VulkanShaderGroupSetup
 {
 public:
-    VulkanShaderGroupSetup(const fs::path& jsonFilepath);
+    VulkanShaderGroupSetup(const fs::path& jsonFilepath, ShaderSetupConfig& setupConfig);
 
     size_t GetVSDefinesCombinationsCount() const noexcept { return GetShaderDefineCombinationsCount(m_vsDefinesIndices.size()); }
     size_t GetPSDefinesCombinationsCount() const noexcept { return GetShaderDefineCombinationsCount(m_psDefinesIndices.size()); }
@@ -70,10 +182,16 @@ public:
 
 public:
     static VulkanShaderGroupSetup ParseJSON(const fs::path& jsonFilepath) noexcept;
+    static VulkanShaderGroupSetup ParseJSON(const fs::path& jsonFilepath, const std::vector<uint8_t>& jsonText) noexcept;
+
+    void Serialize(ShaderSetupManifestWriter& writer) const noexcept;
+    static std::optional<VulkanShaderGroupSetup> Deserialize(ShaderSetupManifestReader& reader) noexcept;
 
 private:
     VulkanShaderGroupSetup() = default;
 
+    void AddDefine(const VulkanShaderDefine& define) noexcept;
+
     static size_t GetShaderDefineCombinationsCount(size_t definesCount) noexcept { return 1 + (1 + definesCount) * definesCount / 2; }
 
 private:
@@ -97,6 +215,150 @@ struct VulkanShaderBuildInfo
 };
 
 
+static int64_t GetFileWriteTimeStamp(const fs::path& path) noexcept
+{
+    std::error_code error;
+    const fs::file_time_type writeTime = fs::last_write_time(path, error);
+    
+    return error ? 0 : static_cast<int64_t>(writeTime.time_since_epoch().count());
+}
+
+
+// Invalid or unreadable files get zero hash
+static ds::Hash128 GetFileContentHash(ds::StrID filepath) noexcept
+{
+    if (!filepath.IsValid()) {
+        return ds::Hash128();
+    }
+
+    return VirtualFileSystem::Instance().GetContentHash(filepath.CStr()).value_or(ds::Hash128());
+}
+
+
+static void StoreShaderSetupManifest(const fs::path& manifestFilepath, const fs::path& shadersRootDir, 
+    const std::vector<VulkanShaderGroupFilepaths>& groupFilepathsList, const std::vector<VulkanShaderGroupSetup>& setups) noexcept
+{
+    AM_ASSERT_GRAPHICS_API(groupFilepathsList.size() == setups.size(), "Shader group filepaths and setups count mismatch");
+
+    ShaderSetupManifestWriter writer;
+
+    writer.Write(AM_SHADER_SETUP_MANIFEST_MAGIC);
+    writer.Write(AM_SHADER_SETUP_MANIFEST_VERSION);
+    writer.Write(GetFileWriteTimeStamp(shadersRootDir));
+    writer.Write(static_cast<uint32_t>(groupFilepathsList.size()));
+
+    for (size_t i = 0; i < groupFilepathsList.size(); ++i) {
+        const VulkanShaderGroupFilepaths& groupFilepaths = groupFilepathsList[i];
+
+        const ds::StrID filepaths[] = { 
+            groupFilepaths.groupDirpath, groupFilepaths.setupFilepath, groupFilepaths.vsFilepath, groupFilepaths.psFilepath 
+        };
+
+        writer.Write(GetFileWriteTimeStamp(groupFilepaths.groupDirpath.CStr()));
+
+        for (size_t j = 1; j < _countof(filepaths); ++j) {
+            writer.Write(GetFileContentHash(filepaths[j]));
+        }
+
+        for (ds::StrID filepath : filepaths) {
+            writer.Write(std::string_view(filepath.IsValid() ? filepath.CStr() : ""));
+        }
+
+        setups[i].Serialize(writer);
+    }
+
+    AsyncFileWriter::Instance().WriteFileAsync(manifestFilepath, writer.ReleaseBuffer());
+}
+
+
+// Returns false if there is no manifest or if any of the shader group files or directories changed since it was written
+static bool LoadShaderSetupManifest(const fs::path& manifestFilepath, const fs::path& shadersRootDir, 
+    std::vector<VulkanShaderGroupFilepaths>& outGroupFilepathsList, std::vector<VulkanShaderGroupSetup>& outSetups) noexcept
+{
+    outGroupFilepathsList.clear();
+    outSetups.clear();
+
+    if (!fs::exists(manifestFilepath)) {
+        return false;
+    }
+
+    MappedFile manifestFile;
+    if (!manifestFile.Open(manifestFilepath, MAPPED_FILE_ACCESS_SEQUENTIAL)) {
+        return false;
+    }
+
+    ShaderSetupManifestReader reader(manifestFile.GetView());
+
+    uint32_t magic = 0, version = 0, groupsCount = 0;
+    int64_t rootDirWriteTime = 0;
+
+    if (!reader.Read(magic) || magic != AM_SHADER_SETUP_MANIFEST_MAGIC || !reader.Read(version) || version != AM_SHADER_SETUP_MANIFEST_VERSION) {
+        AM_LOG_GRAPHICS_API_WARN("Shader setup manifest {} is invalid or outdated", manifestFilepath.string().c_str());
+        return false;
+    }
+
+    if (!reader.Read(rootDirWriteTime) || rootDirWriteTime != GetFileWriteTimeStamp(shadersRootDir) || !reader.Read(groupsCount)) {
+        return false;
+    }
+
+    outGroupFilepathsList.reserve(groupsCount);
+    outSetups.reserve(groupsCount);
+
+    for (uint32_t i = 0; i < groupsCount; ++i) {
+        int64_t groupDirWriteTime = 0;
+        ds::Hash128 contentHashes[3] = {};
+        std::string filepaths[4];
+
+        if (!reader.Read(groupDirWriteTime)) {
+            return false;
+        }
+
+        for (ds::Hash128& contentHash : contentHashes) {
+            if (!reader.Read(contentHash)) {
+                return false;
+            }
+        }
+
+        for (std::string& filepath : filepaths) {
+            if (!reader.Read(filepath)) {
+                return false;
+            }
+        }
+
+        if (groupDirWriteTime != GetFileWriteTimeStamp(filepaths[0])) {
+            return false;
+        }
+
+        for (size_t j = 1; j < _countof(filepaths); ++j) {
+            if (!filepaths[j].empty() && contentHashes[j - 1] != GetFileContentHash(ds::StrID(filepaths[j]))) {
+                return false;
+            }
+        }
+
+        std::optional<VulkanShaderGroupSetup> setup = VulkanShaderGroupSetup::Deserialize(reader);
+        if (!setup.has_value()) {
+            return false;
+        }
+
+        const auto ToStrID = [](const std::string& filepath) -> ds::StrID
+        {
+            return filepath.empty() ? ds::StrID() : ds::StrID(filepath);
+        };
+
+        VulkanShaderGroupFilepaths groupFilepaths;
+        groupFilepaths.groupDirpath  = ToStrID(filepaths[0]);
+        groupFilepaths.setupFilepath = ToStrID(filepaths[1]);
+        groupFilepaths.vsFilepath    = ToStrID(filepaths[2]);
+        groupFilepaths.psFilepath    = ToStrID(filepaths[3]);
+
+        outGroupFilepathsList.emplace_back(groupFilepaths);
+        outSetups.emplace_back(std::move(setup.value()));
+    }
+
+    return reader.IsEnd();
+}
+
+
 static bool IsVertexShaderFile(const fs::path& filepath) noexcept
 {
     const fs::path fileExtension = filepath.extension();
@@ -164,19 +426,20 @@ static std::optional<shaderc_shader_kind> GetShaderCShaderKind(const ShaderID& s
 }
 
 
-static bool PreprocessShader(std::vector<uint8_t>& buffer, const VulkanShaderBuildInfo& buildInfo) noexcept
+// Source code is read directly from the mapped shader file, and preprocessed code is written to outBuffer
+static bool PreprocessShader(const FileView& source, std::vector<uint8_t>& outBuffer, const VulkanShaderBuildInfo& buildInfo) noexcept
 {
     AM_ASSERT_GRAPHICS_API(buildInfo.IsValid(), "buildInfo is invalid");
 
     const ShaderID& shaderId = *buildInfo.pShaderId;
 
-    std::vector<uint8_t>& sourceCode = buffer;
+    std::vector<uint8_t>& sourceCode = outBuffer;
 
     const char* shaderFilepath = shaderId.GetFilepath().CStr();
 
     AM_LOG_GRAPHICS_API_INFO(AM_MAKE_COLORED_TEXT(AM_OUTPUT_COLOR_YELLOW_ASCII_CODE, "Preprocessing '{}'..."), shaderFilepath);
 
-    shaderc::PreprocessedSourceCompilationResult result = g_shadercCompiler.PreprocessGlsl(reinterpret_cast<char*>(sourceCode.data()), sourceCode.size(), 
+    shaderc::PreprocessedSourceCompilationResult result = g_shadercCompiler.PreprocessGlsl(source.AsText().data(), source.size(), 
         buildInfo.kind, shaderFilepath, buildInfo.compileOptions);
 
     if (result.GetCompilationStatus() != shaderc_compilation_status_success) {
@@ -313,14 +576,14 @@ static std::vector<uint8_t> BuildSPIRVCodeFromFile(const VulkanShaderGroupSetup&
             break;
     }
 
-    std::vector<uint8_t> buffer;
-    ReadBinaryFile(shaderId.GetFilepath().CStr(), buffer);
-
-    if (buffer.empty()) {
+    VirtualFile sourceFile;
+    if (!VirtualFileSystem::Instance().Open(shaderId.GetFilepath().CStr(), sourceFile, MAPPED_FILE_ACCESS_SEQUENTIAL)) {
         return {};
     }
 
-    if (!PreprocessShader(buffer, buildInfo)) {
+    std::vector<uint8_t> buffer;
+
+    if (!PreprocessShader(sourceFile.GetView(), buffer, buildInfo)) {
         return {};
     }
 
@@ -365,37 +628,44 @@ static VkShaderModule CreateVulkanShaderModule(VkDevice pLogicalDevice, const Vu
 
 static std::vector<VulkanShaderGroupFilepaths> GetShaderGroupFilepathsList(const fs::path& shadersRootDir) noexcept
 {
-    const size_t groupsCount = CalculateDirectoriesCount(shadersRootDir);
-
-    if (groupsCount == 0) {
-        AM_LOG_ERROR("Failed to find any shader source files");
-        return {};
-    }
-
     std::vector<VulkanShaderGroupFilepaths> result;
-    result.reserve(groupsCount);
+    ds::FlatHashMap<ds::StrID, size_t> groupIndices;
 
-    ForEachDirectory(shadersRootDir, [&result](const fs::directory_entry& dirEntry)
+    // Every shader group is a directory right under the shaders root, so files are grouped by their parent directory.
+    // Files are listed through VFS, so the same code works for loose files and for the mounted pack
+    const fs::path normalizedShadersRootDir = shadersRootDir.lexically_normal();
+
+    VirtualFileSystem::Instance().ForEachFile(shadersRootDir, [&](const fs::path& filepath)
     {
-        VulkanShaderGroupFilepaths pathGroup;
+        const fs::path groupDir = filepath.parent_path();
 
-        ForEachFile(dirEntry.path(), [&pathGroup](const fs::directory_entry& fileEntry)
-        {
-            const fs::path& filepath = fileEntry.path();
-
-            if (IsShaderGroupSetupFile(filepath)) {
-                pathGroup.setupFilepath = filepath.string();
-            } else if (IsVertexShaderFile(filepath)) {
-                pathGroup.vsFilepath = filepath.string();
-            } else if (IsPixelShaderFile(filepath)) {
-                pathGroup.psFilepath = filepath.string();
-            } else {
-                AM_ASSERT_FAIL("Invalid shader related file type");
-            }
-        }, 0);
+        if (groupDir.lexically_normal() == normalizedShadersRootDir) {
+            return;
+        }
+
+        const ds::StrID groupDirpath = groupDir.string();
+
+        const auto [groupIndexIt, isNewGroup] = groupIndices.try_emplace(groupDirpath, result.size());
+        if (isNewGroup) {
+            result.emplace_back().groupDirpath = groupDirpath;
+        }
+
+        VulkanShaderGroupFilepaths& pathGroup = result[groupIndexIt->second];
+
+        if (IsShaderGroupSetupFile(filepath)) {
+            pathGroup.setupFilepath = filepath.string();
+        } else if (IsVertexShaderFile(filepath)) {
+            pathGroup.vsFilepath = filepath.string();
+        } else if (IsPixelShaderFile(filepath)) {
+            pathGroup.psFilepath = filepath.string();
+        } else {
+            AM_ASSERT_FAIL("Invalid shader related file type");
+        }
+    }, 1);
 
-        result.emplace_back(pathGroup);
-    }, 0);
+    if (result.empty()) {
+        AM_LOG_ERROR("Failed to find any shader source files");
+    }
 
     return result;
 }
@@ -451,17 +721,50 @@ bool VulkanShaderSystem::IsInitialized() noexcept
 
 
 ShaderOptimizationLevel VulkanShaderSystem::GetOptimizationLevel() noexcept
+{
+    return g_shaderOptimizationLevel;
+}
+
+
+ShaderOptimizationLevel VulkanShaderSystem::GetDefaultOptimizationLevel() noexcept
 {
     return g_shaderOptimaizationLevelValue;
 }
 
 
+void VulkanShaderSystem::SetOptimizationLevel(ShaderOptimizationLevel level) noexcept
+{
+    AM_ASSERT_GRAPHICS_API(level < SHADER_OPTIMIZATION_LEVEL_COUNT, "Invalid optimization level ({})", static_cast<uint32_t>(level));
+    g_shaderOptimizationLevel = level;
+}
+
+
 void VulkanShaderSystem::RecompileShaders() noexcept
 {
     CompileShaders(true);
 }
 
 
+VkShaderModule VulkanShaderSystem::FindShaderModule(ShaderVariantKey variantKey) const noexcept
+{
+    return GetShaderModule(FindShaderModuleHandle(variantKey));
+}
+
+
+ShaderModuleHandle VulkanShaderSystem::FindShaderModuleHandle(ShaderVariantKey variantKey) const noexcept
+{
+    const auto handleIt = m_shaderModuleHandles.find(variantKey);
+    return handleIt != m_shaderModuleHandles.cend() ? handleIt->second : ShaderModuleHandle();
+}
+
+
+VkShaderModule VulkanShaderSystem::GetShaderModule(ShaderModuleHandle handle) const noexcept
+{
+    const VkShaderModule* ppShaderModule = m_shaderModules.Get(handle);
+    return ppShaderModule ? *ppShaderModule : VK_NULL_HANDLE;
+}
+
+
 bool VulkanShaderSystem::IsInstanceInitialized() noexcept
 {
     return s_pShaderSysInstance != nullptr;
@@ -510,54 +813,86 @@ void VulkanShaderSystem::ClearVulkanShaderModules() noexcept
 {
     AM_ASSERT_GRAPHICS_API(IsVulkanLogicalDeviceValid(), "Reference to invalid Vulkan logical device inside {}", __FUNCTION__);
 
-    for (auto& [shaderId, pVkModule] : m_shaderModules) {
+    for (VkShaderModule& pVkModule : m_shaderModules) {
         vkDestroyShaderModule(s_pLogicalDevice, pVkModule, nullptr);
         pVkModule = VK_NULL_HANDLE;
     }
 
-    m_shaderModules.clear();
+    m_shaderModules.Clear();
+    m_shaderModuleHandles.clear();
 }
 
 void VulkanShaderSystem::CompileShaders(bool forceRecompile) noexcept
 {
-    std::vector<VulkanShaderGroupFilepaths> shaderGroupFilepathsList = GetShaderGroupFilepathsList(PathSystem::GetProjectShadersSourceCodeDirectory());
-    
+    const fs::path shadersRootDir = PathSystem::GetProjectShadersSourceCodeDirectory();
+    const fs::path manifestFilepath = PathSystem::GetProjectShaderSetupManifestFilepath();
+
+    std::vector<VulkanShaderGroupFilepaths> shaderGroupFilepathsList;
     std::vector<VulkanShaderGroupSetup> setups;
-    setups.reserve(shaderGroupFilepathsList.size());
+
+    if (forceRecompile || !LoadShaderSetupManifest(manifestFilepath, shadersRootDir, shaderGroupFilepathsList, setups)) {
+        shaderGroupFilepathsList = GetShaderGroupFilepathsList(shadersRootDir);
+
+        setups.clear();
+        setups.reserve(shaderGroupFilepathsList.size());
+
+        std::vector<fs::path> setupFilepaths;
+        setupFilepaths.reserve(shaderGroupFilepathsList.size());
+
+        for (const VulkanShaderGroupFilepaths& groupFilepaths : shaderGroupFilepathsList) {
+            setupFilepaths.emplace_back(groupFilepaths.setupFilepath.CStr());
+        }
+
+        // Setups are parsed while the rest of them are still being read
+        std::vector<std::future<AsyncFileReadResult>> setupFiles = AsyncFileIO::Instance().ReadFilesAsync(setupFilepaths);
+
+        for (std::future<AsyncFileReadResult>& setupFile : setupFiles) {
+            const AsyncFileReadResult setupFileReadResult = setupFile.get();
+            setups.emplace_back(VulkanShaderGroupSetup::ParseJSON(setupFileReadResult.filepath, setupFileReadResult.data));
+        }
+
+        StoreShaderSetupManifest(manifestFilepath, shadersRootDir, shaderGroupFilepathsList, setups);
+    }
     
     size_t totalShaderCombinations = 0;
 
-    for (const VulkanShaderGroupFilepaths& groupFilepaths : shaderGroupFilepathsList) {
-        VulkanShaderGroupSetup setup = VulkanShaderGroupSetup::ParseJSON(fs::path(groupFilepaths.setupFilepath.CStr()));
-        
+    for (const VulkanShaderGroupSetup& setup : setups) {
         totalShaderCombinations += setup.GetVSDefinesCombinationsCount() + setup.GetPSDefinesCombinationsCount();
-
-        setups.emplace_back(setup);
     }
 
     ClearVulkanShaderModules();
+    m_pShaderCache->ResetReferences();
 
-    m_shaderModules.reserve(totalShaderCombinations);
+    m_shaderModules.Reserve(totalShaderCombinations);
+    m_shaderModuleHandles.reserve(totalShaderCombinations);
 
-    const auto CreateAllCombinationsShaderModules = [this](const VulkanShaderGroupSetup& setup, 
-        const std::vector<size_t>& indices, ds::StrID shaderFilepath, bool forceRecompile) -> bool
+    const auto CreateAllCombinationsShaderModules = [this](const VulkanShaderGroupSetup& setup, const std::vector<size_t>& indices, 
+        ds::StrID shaderFilepath, uint32_t groupID, uint32_t stageMask, bool forceRecompile) -> bool
     {
-        ShaderID shaderId(shaderFilepath, {});
+        ShaderID shaderId(shaderFilepath);
+        ShaderVariantKey variantKey = amMakeShaderVariantKey(groupID, stageMask, 0);
 
         bool newShaderCacheEntry = false;
 
-        if (forceRecompile || !LoadAndAddShaderModule(shaderId)) {
-            newShaderCacheEntry = BuildAndAddShaderModule(&setup, shaderId) || newShaderCacheEntry;
+        if (forceRecompile || !LoadAndAddShaderModule(shaderId, variantKey)) {
+            newShaderCacheEntry = BuildAndAddShaderModule(&setup, shaderId, variantKey) || newShaderCacheEntry;
         }
 
         for (size_t i = 0; i < indices.size(); ++i) {
-            shaderId.ClearBits();
+            shaderId = shaderId.WithoutDefineBits();
+            uint32_t defineBits = 0;
 
             for (size_t j = i; j < indices.size(); ++j) {
-                shaderId.SetDefineBit(indices[j]);
+                AM_ASSERT_GRAPHICS_API(indices[j] < AM_SHADER_VARIANT_KEY_MAX_DEFINES_COUNT, "Shader ({}) define index ({}) doesn't fit into shader variant key", 
+                    shaderFilepath.CStr(), indices[j]);
+
+                shaderId = shaderId.WithDefineBit(indices[j]);
+                defineBits |= 1u << indices[j];
 
-                if (forceRecompile || !LoadAndAddShaderModule(shaderId)) {
-                    newShaderCacheEntry = BuildAndAddShaderModule(&setup, shaderId) || newShaderCacheEntry;
+                variantKey = amMakeShaderVariantKey(groupID, stageMask, defineBits);
+
+                if (forceRecompile || !LoadAndAddShaderModule(shaderId, variantKey)) {
+                    newShaderCacheEntry = BuildAndAddShaderModule(&setup, shaderId, variantKey) || newShaderCacheEntry;
                 }
             }
         }
@@ -569,20 +904,26 @@ void VulkanShaderSystem::CompileShaders(bool forceRecompile) noexcept
 
     for (size_t i = 0; i < setups.size(); ++i) {
         const VulkanShaderGroupSetup& setup = setups[i];
+        const VulkanShaderGroupFilepaths& groupFilepaths = shaderGroupFilepathsList[i];
+
+        const uint32_t groupID = amGetShaderGroupID(fs::path(groupFilepaths.groupDirpath.CStr()).filename().string());
 
-        const bool newVsCombinations = CreateAllCombinationsShaderModules(setup, setup.GetVSDefinesIndices(), shaderGroupFilepathsList[i].vsFilepath, forceRecompile);
-        const bool newPsCombinations = CreateAllCombinationsShaderModules(setup, setup.GetPSDefinesIndices(), shaderGroupFilepathsList[i].psFilepath, forceRecompile);
+        const bool newVsCombinations = CreateAllCombinationsShaderModules(setup, setup.GetVSDefinesIndices(), groupFilepaths.vsFilepath, groupID, AM_VERTEX_SHADER_MASK, forceRecompile);
+        const bool newPsCombinations = CreateAllCombinationsShaderModules(setup, setup.GetPSDefinesIndices(), groupFilepaths.psFilepath, groupID, AM_PIXEL_SHADER_MASK, forceRecompile);
 
         needToSubmitShaderCache = needToSubmitShaderCache || newVsCombinations || newPsCombinations;
     }
 
+    // Entries which weren't used by this pass belong to removed shaders or variants and are pruned from the cache file
+    needToSubmitShaderCache = needToSubmitShaderCache || m_pShaderCache->HasUnreferencedEntries();
+
     if (needToSubmitShaderCache) {
         m_pShaderCache->Submit(PathSystem::GetProjectShaderCacheFilepath());
     }
 }
 
 
-bool VulkanShaderSystem::BuildAndAddShaderModule(const VulkanShaderGroupSetup* pSetup, const ShaderID &shaderId) noexcept
+bool VulkanShaderSystem::BuildAndAddShaderModule(const VulkanShaderGroupSetup* pSetup, const ShaderID &shaderId, ShaderVariantKey variantKey) noexcept
 {
     AM_ASSERT_GRAPHICS_API(pSetup, "pSetup is nullptr");
 
@@ -594,15 +935,16 @@ bool VulkanShaderSystem::BuildAndAddShaderModule(const VulkanShaderGroupSetup* p
         return false;
     }
 
-    m_shaderModules[ShaderIDProxy(shaderId)] = pShaderModule;
+    AddShaderModule(variantKey, pShaderModule);
 
     m_pShaderCache->AddCacheEntryToSubmitBuffer(shaderId, spirvCode);
+    m_pShaderCache->MarkReferenced(shaderId);
 
     return true;
 }
 
 
-bool VulkanShaderSystem::LoadAndAddShaderModule(const ShaderID &shaderId) noexcept
+bool VulkanShaderSystem::LoadAndAddShaderModule(const ShaderID &shaderId, ShaderVariantKey variantKey) noexcept
 {
     if (!m_pShaderCache->Contains(shaderId)) {
         AM_LOG_GRAPHICS_API_WARN("Failed to load {} from shader cache", shaderId.GetFilepath().CStr());
@@ -618,68 +960,144 @@ bool VulkanShaderSystem::LoadAndAddShaderModule(const ShaderID &shaderId) noexce
         return false;
     }
 
-    m_shaderModules[ShaderIDProxy(shaderCacheEntry.hash)] = pShaderModule;
+    AddShaderModule(variantKey, pShaderModule);
+    m_pShaderCache->MarkReferenced(shaderId);
+
     return true;
 }
 
 
-VulkanShaderGroupSetup::VulkanShaderGroupSetup(const fs::path &jsonFilepath)
+void VulkanShaderSystem::AddShaderModule(ShaderVariantKey variantKey, VkShaderModule pShaderModule) noexcept
 {
-    const auto setupJsonConf = amjson::ParseJson(jsonFilepath);
-    AM_ASSERT(setupJsonConf.has_value(), "VulkanShaderGroupSetup Json parsing error");
+    auto [handleIt, inserted] = m_shaderModuleHandles.try_emplace(variantKey);
+
+    if (!inserted) {
+        VkShaderModule* ppOldShaderModule = m_shaderModules.Get(handleIt->second);
+
+        if (ppOldShaderModule) {
+            vkDestroyShaderModule(s_pLogicalDevice, *ppOldShaderModule, nullptr);
+            *ppOldShaderModule = pShaderModule;
+            return;
+        }
+    }
+
+    // Handle of a new variant or the one made stale by the previous recompilation. Every recompilation releases all slots,
+    // and a slot which ran out of generations is retired instead of reused, so Add fails once no slots are left
+    handleIt->second = m_shaderModules.Add(pShaderModule);
+    AM_ASSERT_GRAPHICS_API(handleIt->second.IsValid(), "Shader modules pool ran out of slots, retired slots aren't reused");
+}
 
-    const nlohmann::json& setupJson = setupJsonConf.value();
 
-    const nlohmann::json& definesJson = amjson::GetJsonSubNode(setupJson, JSON_SHADER_SETUP_DEFINES_FIELD_NAME);
-    const size_t definesCount = definesJson.size();
+VulkanShaderGroupSetup::VulkanShaderGroupSetup(const fs::path& jsonFilepath, ShaderSetupConfig& setupConfig)
+{
+    amjson::JsonMap<ShaderDefineConfig>& defines = setupConfig.defines;
+    const size_t definesCount = defines.size();
 
     if (!definesCount) {
         AM_LOG_INFO("No defines in {} detected", jsonFilepath.string().c_str());
         return;
     }
 
+    // Define indices follow nlohmann::json object iteration order, which generated shader_variant_keys.h relies on
+    std::sort(defines.begin(), defines.end(), [](const auto& left, const auto& right) { return left.first < right.first; });
+
     m_defines.reserve(definesCount);
     m_vsDefinesIndices.reserve(definesCount);
     m_psDefinesIndices.reserve(definesCount);
 
-    size_t defineIndex = 0;
-
-    for (const auto& [defineName, defineDescJson] : definesJson.items()) {
+    for (auto& [defineName, defineConfig] : defines) {
         VulkanShaderDefine define = {};
         
-        define.name = defineName;
-        amjson::GetJsonSubNode(defineDescJson, JSON_SHADER_SETUP_DEFINES_CONDITION_FIELD_NAME).get_to<std::string>(define.condition);
-        
-        bool isVertex = false, isPixel = false;
+        define.name = std::move(defineName);
+        define.condition = std::move(defineConfig.condition);
 
-        for (const std::string& type : amjson::ParseJsonSubNodeToArray<std::string>(defineDescJson, JSON_SHADER_SETUP_DEFINES_TYPE_FIELD_NAME)) {
+        for (const std::string& type : defineConfig.types) {
             if (type == JSON_SHADER_SETUP_DEFINES_TYPE_VERTEX) {
                 define.shaderTypeMask |= AM_VERTEX_SHADER_MASK;
-                isVertex = true;
             } else if (type == JSON_SHADER_SETUP_DEFINES_TYPE_PIXEL) {
                 define.shaderTypeMask |= AM_PIXEL_SHADER_MASK;
-                isPixel = true;
             } else {
                 AM_ASSERT_FAIL("Invalid shader setup type");
             }
         }
 
-        m_defines.emplace_back(define);
-        
-        if (isVertex) {
-            m_vsDefinesIndices.emplace_back(defineIndex);
-        }
+        AddDefine(define);
+    }
+}
+
+
+VulkanShaderGroupSetup VulkanShaderGroupSetup::ParseJSON(const fs::path &jsonFilepath) noexcept
+{
+    ShaderSetupConfig setupConfig;
+
+    AM_MAYBE_UNUSED const bool isParsed = amjson::ParseJsonSchema(jsonFilepath, setupConfig);
+    AM_ASSERT(isParsed, "VulkanShaderGroupSetup Json parsing error");
+
+    return VulkanShaderGroupSetup(jsonFilepath, setupConfig);
+}
+
+
+VulkanShaderGroupSetup VulkanShaderGroupSetup::ParseJSON(const fs::path& jsonFilepath, const std::vector<uint8_t>& jsonText) noexcept
+{
+    ShaderSetupConfig setupConfig;
+
+    AM_MAYBE_UNUSED const bool isParsed = amjson::ParseJsonSchema(jsonFilepath, jsonText.data(), jsonText.size(), setupConfig);
+    AM_ASSERT(isParsed, "VulkanShaderGroupSetup Json parsing error");
+
+    return VulkanShaderGroupSetup(jsonFilepath, setupConfig);
+}
+
+
+void VulkanShaderGroupSetup::Serialize(ShaderSetupManifestWriter& writer) const noexcept
+{
+    writer.Write(static_cast<uint32_t>(m_defines.size()));
+
+    for (const VulkanShaderDefine& define : m_defines) {
+        writer.Write(define.shaderTypeMask);
+        writer.Write(std::string_view(define.name));
+        writer.Write(std::string_view(define.condition));
+    }
+}
+
 
-        if (isPixel) {
-            m_psDefinesIndices.emplace_back(defineIndex);
+std::optional<VulkanShaderGroupSetup> VulkanShaderGroupSetup::Deserialize(ShaderSetupManifestReader& reader) noexcept
+{
+    uint32_t definesCount = 0;
+    if (!reader.Read(definesCount)) {
+        return std::nullopt;
+    }
+
+    VulkanShaderGroupSetup setup;
+
+    setup.m_defines.reserve(definesCount);
+    setup.m_vsDefinesIndices.reserve(definesCount);
+    setup.m_psDefinesIndices.reserve(definesCount);
+
+    for (uint32_t i = 0; i < definesCount; ++i) {
+        VulkanShaderDefine define = {};
+
+        if (!reader.Read(define.shaderTypeMask) || !reader.Read(define.name) || !reader.Read(define.condition)) {
+            return std::nullopt;
         }
 
-        ++defineIndex;
+        setup.AddDefine(define);
     }
+
+    return setup;
 }
 
 
-VulkanShaderGroupSetup VulkanShaderGroupSetup::ParseJSON(const fs::path &jsonFilepath) noexcept
+void VulkanShaderGroupSetup::AddDefine(const VulkanShaderDefine& define) noexcept
 {
-    return VulkanShaderGroupSetup(jsonFilepath);
+    const size_t defineIndex = m_defines.size();
+
+    m_defines.emplace_back(define);
+
+    if (define.IsVertex()) {
+        m_vsDefinesIndices.emplace_back(defineIndex);
+    }
+
+    if (define.IsPixel()) {
+        m_psDefinesIndices.emplace_back(defineIndex);
+    }
 }
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "shader_cache.h"
+#include "shader_variant_key.h"
 
 #include "utils/debug/assertion.h"
 #include "utils/file/file.h"
+#include "utils/data_structures/flat_hash_map.h"
+#include "utils/data_structures/handle_pool.h"
 
 #include <vulkan/vulkan.h>
 
@@ -23,6 +26,9 @@ enum ShaderOptimizationLevel
 class VulkanShaderGroupSetup;
 
 
+using ShaderModuleHandle = ds::Handle<VkShaderModule>;
+
+
 class VulkanShaderSystem
 {
     friend class VulkanApplication;
@@ -36,6 +42,10 @@ public:
     static bool IsInitialized() noexcept;
 
     static ShaderOptimizationLevel GetOptimizationLevel() noexcept;
+    static ShaderOptimizationLevel GetDefaultOptimizationLevel() noexcept;
+
+    // Takes effect on the next shaders compilation. Shader IDs include the level, so cache entries of different levels don't collide
+    static void SetOptimizationLevel(ShaderOptimizationLevel level) noexcept;
 
     VulkanShaderSystem(const VulkanShaderSystem& sys) = delete;
     VulkanShaderSystem& operator=(const VulkanShaderSystem& sys) = delete;
@@ -51,6 +61,16 @@ public:
     // Force shaders recompiling and submiting to shader cache
     void RecompileShaders() noexcept;
 
+    // Returns VK_NULL_HANDLE if there is no module for the variant. Use generated shader_variant_keys.h to get the keys
+    VkShaderModule FindShaderModule(ShaderVariantKey variantKey) const noexcept;
+
+    // Returns invalid handle if there is no module for the variant. Resolve the handle with GetShaderModule() afterwards
+    // to skip the variant key lookup. Handles become stale after shaders recompiling
+    ShaderModuleHandle FindShaderModuleHandle(ShaderVariantKey variantKey) const noexcept;
+
+    // Returns VK_NULL_HANDLE if the handle is stale
+    VkShaderModule GetShaderModule(ShaderModuleHandle handle) const noexcept;
+
 private:
     static bool IsInstanceInitialized() noexcept;
     static bool IsVulkanLogicalDeviceValid() noexcept;
@@ -66,17 +86,21 @@ private:
 
     // Creates shader module from file
     // Writes compiled code to shader cache
-    bool BuildAndAddShaderModule(const VulkanShaderGroupSetup* pSetup, const ShaderID& shaderId) noexcept;
+    bool BuildAndAddShaderModule(const VulkanShaderGroupSetup* pSetup, const ShaderID& shaderId, ShaderVariantKey variantKey) noexcept;
 
     // Creates shader module from shader cache
-    bool LoadAndAddShaderModule(const ShaderID& shaderId) noexcept;
+    bool LoadAndAddShaderModule(const ShaderID& shaderId, ShaderVariantKey variantKey) noexcept;
+
+    // Replaces and destroys previous module of the variant if there is any, so issued handle stays the same
+    void AddShaderModule(ShaderVariantKey variantKey, VkShaderModule pShaderModule) noexcept;
 
 private:
     static inline std::unique_ptr<VulkanShaderSystem> s_pShaderSysInstance = nullptr;
     static inline VkDevice s_pLogicalDevice = VK_NULL_HANDLE;
 
 private:
-    std::unordered_map<ShaderIDProxy, VkShaderModule> m_shaderModules;
+    ds::HandlePool<VkShaderModule> m_shaderModules;
+    ds::FlatHashMap<ShaderVariantKey, ShaderModuleHandle, ShaderVariantKeyHasher> m_shaderModuleHandles;
 
     std::unique_ptr<VulkanShaderCache> m_pShaderCache = nullptr;
 };
\ No newline at end of file
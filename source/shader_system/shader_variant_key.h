@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "utils/data_structures/hash.h"
+
+
+// Shader variant key layout:
+//      32 bits - shader group ID (hash of the group directory name)
+//       8 bits - shader stage mask
+//      24 bits - define bits (define indices match the setup.json defines order)
+using ShaderVariantKey = uint64_t;
+
+
+static constexpr uint32_t AM_VERTEX_SHADER_MASK = 0x1;
+static constexpr uint32_t AM_PIXEL_SHADER_MASK  = 0x2;
+
+static constexpr size_t AM_SHADER_VARIANT_KEY_MAX_DEFINES_COUNT = 24;
+static constexpr ShaderVariantKey AM_INVALID_SHADER_VARIANT_KEY = UINT64_MAX;
+
+
+constexpr uint32_t amGetShaderGroupID(std::string_view groupName) noexcept
+{
+    const uint64_t hash = amHashConstexpr(groupName);
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+
+constexpr ShaderVariantKey amMakeShaderVariantKey(uint32_t groupID, uint32_t stageMask, uint32_t defineBits) noexcept
+{
+    return (static_cast<uint64_t>(groupID) << 32) | (static_cast<uint64_t>(stageMask & 0xFFu) << 24) | (defineBits & 0xFFFFFFu);
+}
+
+
+// Keys are already unique, only fold the group ID into the low bits used for bucket selection
+struct ShaderVariantKeyHasher
+{
+    constexpr size_t operator()(ShaderVariantKey key) const noexcept { return static_cast<size_t>(key ^ (key >> 32)); }
+};
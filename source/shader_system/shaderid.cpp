@@ -8,55 +8,71 @@
 #include "shader_system.h"
 
 
-ShaderID::ShaderID(ds::StrID filepath)
-    : m_filepath(filepath)
+template <size_t MaxDefinesCount>
+ShaderIDImpl<MaxDefinesCount>::ShaderIDImpl(ds::StrID filepath, DefineMaskType defineBits)
+    : m_hash(ComputeHash(filepath, defineBits, VulkanShaderSystem::GetOptimizationLevel())), m_filepath(filepath), m_defineBits(defineBits)
 {
 }
 
 
-ShaderID::ShaderID(ds::StrID filepath, const std::bitset<MAX_SHADER_DEFINES_COUNT>& defineBits)
-    : m_defineBits(defineBits), m_filepath(filepath)
-{
-}
-
-
-void ShaderID::SetDefineBit(size_t index, bool value) noexcept
+template <size_t MaxDefinesCount>
+ShaderIDImpl<MaxDefinesCount> ShaderIDImpl<MaxDefinesCount>::WithDefineBit(size_t index, bool value) const noexcept
 {
     AM_ASSERT_GRAPHICS_API(index < MAX_SHADER_DEFINES_COUNT, "Max shader ({}) defines ({}) count reached", m_filepath.CStr(), MAX_SHADER_DEFINES_COUNT);
 
-    m_defineBits.set(index, value);
-}
+    DefineMaskType defineBits = m_defineBits;
 
+    if constexpr (std::is_integral_v<DefineMaskType>) {
+        const DefineMaskType bit = static_cast<DefineMaskType>(DefineMaskType(1) << index);
+        defineBits = value ? static_cast<DefineMaskType>(defineBits | bit) : static_cast<DefineMaskType>(defineBits & ~bit);
+    } else {
+        defineBits.set(index, value);
+    }
 
-void ShaderID::ClearDefineBit(size_t index) noexcept
-{
-    SetDefineBit(index, false);
+    return ShaderIDImpl(m_filepath, defineBits);
 }
 
 
-void ShaderID::ClearBits() noexcept
+template <size_t MaxDefinesCount>
+bool ShaderIDImpl<MaxDefinesCount>::IsDefineBit(size_t index) const noexcept
 {
-    m_defineBits.reset();
+    AM_ASSERT_GRAPHICS_API(index < MAX_SHADER_DEFINES_COUNT, "Invalid shader ({}) define index ({})", m_filepath.CStr(), index);
+
+    if constexpr (std::is_integral_v<DefineMaskType>) {
+        return (m_defineBits & (DefineMaskType(1) << index)) != 0;
+    } else {
+        return m_defineBits.test(index);
+    }
 }
 
 
-bool ShaderID::IsDefineBit(size_t index) const noexcept
+template <size_t MaxDefinesCount>
+uint64_t ShaderIDImpl<MaxDefinesCount>::HashForOptimizationLevel(uint32_t optimizationLevel) const noexcept
 {
-    return m_defineBits.test(index);
+    AM_ASSERT_GRAPHICS_API(optimizationLevel < SHADER_OPTIMIZATION_LEVEL_COUNT, "Invalid optimization level ({})", optimizationLevel);
+    return ComputeHash(m_filepath, m_defineBits, optimizationLevel);
 }
 
 
-uint64_t ShaderID::Hash() const noexcept
+template <size_t MaxDefinesCount>
+uint64_t ShaderIDImpl<MaxDefinesCount>::ComputeHash(ds::StrID filepath, const DefineMaskType& defineBits, uint32_t optimizationLevel) noexcept
 {
     ds::HashBuilder builder;
-    builder.AddValue(m_filepath);
-    builder.AddValue(m_defineBits);
-    builder.AddValue(VulkanShaderSystem::GetOptimizationLevel()); 
+    builder.AddValue(filepath);
+    builder.AddValue(defineBits);
+    builder.AddValue(static_cast<ShaderOptimizationLevel>(optimizationLevel)); 
 
     return builder.Value();
 }
 
 
+template class ShaderIDImpl<8>;
+template class ShaderIDImpl<16>;
+template class ShaderIDImpl<32>;
+template class ShaderIDImpl<64>;
+template class ShaderIDImpl<256>;
+
+
 ShaderIDProxy::ShaderIDProxy(const ShaderID &id)
     : m_hash(id.Hash())
 {
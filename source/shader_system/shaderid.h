@@ -2,47 +2,71 @@
 
 #include <cstdint>
 #include <bitset>
+#include <type_traits>
+#include <limits>
 
 #include "utils/data_structures/strid.h"
 
 
-class ShaderID
+// Max defines count used by ShaderID. Must cover AM_SHADER_VARIANT_KEY_MAX_DEFINES_COUNT
+#define AM_SHADER_MAX_DEFINES_COUNT 32
+
+
+// Immutable shader key. The hash is computed once on construction, and the define bits are stored 
+// in the smallest unsigned integer that fits MaxDefinesCount (std::bitset is used only for more than 64 defines)
+template <size_t MaxDefinesCount>
+class ShaderIDImpl
 {
 public:
-    static inline constexpr size_t MAX_SHADER_DEFINES_COUNT = 256;
+    static inline constexpr size_t MAX_SHADER_DEFINES_COUNT = MaxDefinesCount;
     static inline constexpr uint64_t INVALID_HASH = std::numeric_limits<uint64_t>::max();
 
+    using DefineMaskType = 
+        std::conditional_t<MaxDefinesCount <= 8,  uint8_t,
+        std::conditional_t<MaxDefinesCount <= 16, uint16_t,
+        std::conditional_t<MaxDefinesCount <= 32, uint32_t,
+        std::conditional_t<MaxDefinesCount <= 64, uint64_t, std::bitset<MaxDefinesCount>>>>>;
+
 public:
-    ShaderID() = default;
-    ShaderID(ds::StrID filepath);
-    ShaderID(ds::StrID filepath, const std::bitset<MAX_SHADER_DEFINES_COUNT>& defineBits);
+    ShaderIDImpl() = default;
+    explicit ShaderIDImpl(ds::StrID filepath, DefineMaskType defineBits = {});
 
-    void SetDefineBit(size_t index, bool value = true) noexcept;
-    void ClearDefineBit(size_t index) noexcept;
-    void ClearBits() noexcept;
+    // Returns a new ID, since ShaderID is immutable
+    ShaderIDImpl WithDefineBit(size_t index, bool value = true) const noexcept;
+    ShaderIDImpl WithoutDefineBits() const noexcept { return ShaderIDImpl(m_filepath); }
 
     bool IsDefineBit(size_t index) const noexcept;
+    DefineMaskType GetDefineBits() const noexcept { return m_defineBits; }
 
-    bool IsHashValid() const noexcept { return Hash() != INVALID_HASH; }
+    bool IsHashValid() const noexcept { return m_hash != INVALID_HASH; }
 
-    uint64_t Hash() const noexcept;
+    uint64_t Hash() const noexcept { return m_hash; }
+
+    // Hash the same shader gets when compiled with another optimization level (ShaderOptimizationLevel value)
+    uint64_t HashForOptimizationLevel(uint32_t optimizationLevel) const noexcept;
 
-    bool operator==(const ShaderID& id) const noexcept { return m_filepath == id.m_filepath && m_defineBits == id.m_defineBits; }
-    bool operator!=(const ShaderID& id) const noexcept { return !operator==(id); }
-    bool operator<(const ShaderID& id) const noexcept { return m_filepath < id.m_filepath; }
-    bool operator>(const ShaderID& id) const noexcept { return m_filepath > id.m_filepath; }
-    bool operator<=(const ShaderID& id) const noexcept { return operator<(id) || operator==(id); }
-    bool operator>=(const ShaderID& id) const noexcept { return operator>(id) || operator==(id); }
+    bool operator==(const ShaderIDImpl& id) const noexcept { return m_hash == id.m_hash && m_filepath == id.m_filepath && m_defineBits == id.m_defineBits; }
+    bool operator!=(const ShaderIDImpl& id) const noexcept { return !operator==(id); }
+    bool operator<(const ShaderIDImpl& id) const noexcept  { return m_hash < id.m_hash; }
+    bool operator>(const ShaderIDImpl& id) const noexcept  { return m_hash > id.m_hash; }
+    bool operator<=(const ShaderIDImpl& id) const noexcept { return operator<(id) || operator==(id); }
+    bool operator>=(const ShaderIDImpl& id) const noexcept { return operator>(id) || operator==(id); }
 
-    void SetFilepath(ds::StrID filepath) noexcept { m_filepath = filepath; }
     ds::StrID GetFilepath() const noexcept { return m_filepath; }
 
 private:
-    std::bitset<MAX_SHADER_DEFINES_COUNT> m_defineBits;
+    static uint64_t ComputeHash(ds::StrID filepath, const DefineMaskType& defineBits, uint32_t optimizationLevel) noexcept;
+
+private:
+    uint64_t m_hash = INVALID_HASH;
     ds::StrID m_filepath;
+    DefineMaskType m_defineBits = {};
 };
 
 
+using ShaderID = ShaderIDImpl<AM_SHADER_MAX_DEFINES_COUNT>;
+
+
 class ShaderIDProxy
 {
 public:
@@ -67,13 +91,16 @@ private:
 
 
 namespace std {
-    template<>
-    struct hash<ShaderID> {
-        uint64_t operator()(const ShaderID& id) const { return id.Hash(); }
+    template<size_t MaxDefinesCount>
+    struct hash<ShaderIDImpl<MaxDefinesCount>> {
+        uint64_t operator()(const ShaderIDImpl<MaxDefinesCount>& id) const { return id.Hash(); }
     };
 
     template<>
     struct hash<ShaderIDProxy> {
+        // Shader ID hashes are already mixed, so flat hash maps can use them as is
+        using is_avalanching = void;
+
         uint64_t operator()(const ShaderIDProxy& idProxy) const { return idProxy.Hash(); }
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace ds
+{
+    // Chunked bump allocator. Chunks are never reallocated, so allocated memory never moves.
+    // Memory isn't zero-filled and is released all together by Reset or on arena destruction. Not thread-safe
+    class ChunkedArena
+    {
+    public:
+        static inline constexpr size_t DEFAULT_CHUNK_SIZE = 64ull * 1024ull;
+
+    public:
+        explicit ChunkedArena(size_t chunkSize = DEFAULT_CHUNK_SIZE) noexcept : m_chunkSize(chunkSize) {}
+
+        ChunkedArena(const ChunkedArena& arena) = delete;
+        ChunkedArena& operator=(const ChunkedArena& arena) = delete;
+
+        ChunkedArena(ChunkedArena&& arena) noexcept = default;
+        ChunkedArena& operator=(ChunkedArena&& arena) noexcept = default;
+
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) noexcept;
+
+        template <typename T>
+        T* AllocateArray(size_t count) noexcept { return static_cast<T*>(Allocate(count * sizeof(T), alignof(T))); }
+
+        void Reset() noexcept;
+
+        size_t GetChunkSize() const noexcept { return m_chunkSize; }
+        size_t GetReservedSize() const noexcept { return m_reservedSize; }
+
+    private:
+        // Allocations bigger than the chunk size get their own chunk, and the current chunk stays in use
+        void* AllocateDedicatedChunk(size_t size, size_t alignment) noexcept;
+
+    private:
+        std::vector<std::unique_ptr<uint8_t[]>> m_chunks;
+
+        uint8_t* m_pCurr = nullptr;
+        uint8_t* m_pEnd = nullptr;
+
+        size_t m_chunkSize = DEFAULT_CHUNK_SIZE;
+        size_t m_reservedSize = 0;
+    };
+}
+
+
+#include "arena.hpp"
@@ -0,0 +1,58 @@
+namespace ds
+{
+    inline void* ChunkedArena::Allocate(size_t size, size_t alignment) noexcept
+    {
+        if (size == 0) {
+            return nullptr;
+        }
+
+        const uintptr_t curr = reinterpret_cast<uintptr_t>(m_pCurr);
+        const uintptr_t alignedCurr = (curr + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+
+        if (m_pCurr != nullptr && alignedCurr + size <= reinterpret_cast<uintptr_t>(m_pEnd)) {
+            m_pCurr = reinterpret_cast<uint8_t*>(alignedCurr + size);
+            return reinterpret_cast<void*>(alignedCurr);
+        }
+
+        if (size + alignment > m_chunkSize) {
+            return AllocateDedicatedChunk(size, alignment);
+        }
+
+        // Chunk memory is default-initialized to skip zero-filling
+        std::unique_ptr<uint8_t[]> pChunk(new uint8_t[m_chunkSize]);
+
+        m_pCurr = pChunk.get();
+        m_pEnd = m_pCurr + m_chunkSize;
+        m_reservedSize += m_chunkSize;
+
+        m_chunks.emplace_back(std::move(pChunk));
+
+        return Allocate(size, alignment);
+    }
+
+
+    inline void ChunkedArena::Reset() noexcept
+    {
+        m_chunks.clear();
+
+        m_pCurr = nullptr;
+        m_pEnd = nullptr;
+        m_reservedSize = 0;
+    }
+
+
+    inline void* ChunkedArena::AllocateDedicatedChunk(size_t size, size_t alignment) noexcept
+    {
+        const size_t chunkSize = size + alignment;
+
+        std::unique_ptr<uint8_t[]> pChunk(new uint8_t[chunkSize]);
+        m_reservedSize += chunkSize;
+
+        const uintptr_t chunkBegin = reinterpret_cast<uintptr_t>(pChunk.get());
+        const uintptr_t alignedBegin = (chunkBegin + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+
+        m_chunks.emplace_back(std::move(pChunk));
+
+        return reinterpret_cast<void*>(alignedBegin);
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <utility>
+#include <memory>
+#include <new>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "utils/debug/assertion.h"
+
+
+namespace ds
+{
+    // Vector with fixed capacity and inline storage only, it never allocates.
+    // Exceeding the capacity is a programmer error and asserts
+    template <typename T, size_t N>
+    class FixedVector
+    {
+        static_assert(N > 0, "FixedVector capacity must be greater than zero");
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+    public:
+        FixedVector() = default;
+        explicit FixedVector(size_t count) noexcept { resize(count); }
+
+        FixedVector(const FixedVector& other) noexcept;
+        FixedVector& operator=(const FixedVector& other) noexcept;
+
+        FixedVector(FixedVector&& other) noexcept;
+        FixedVector& operator=(FixedVector&& other) noexcept;
+
+        ~FixedVector() { clear(); }
+
+        iterator begin() noexcept { return data(); }
+        iterator end() noexcept { return data() + m_size; }
+
+        const_iterator begin() const noexcept { return data(); }
+        const_iterator end() const noexcept { return data() + m_size; }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+
+        T& operator[](size_t idx) noexcept { return data()[idx]; }
+        const T& operator[](size_t idx) const noexcept { return data()[idx]; }
+
+        T& front() noexcept { return data()[0]; }
+        const T& front() const noexcept { return data()[0]; }
+
+        T& back() noexcept { return data()[m_size - 1]; }
+        const T& back() const noexcept { return data()[m_size - 1]; }
+
+        T* data() noexcept { return reinterpret_cast<T*>(m_storage); }
+        const T* data() const noexcept { return reinterpret_cast<const T*>(m_storage); }
+
+        void push_back(const T& value) noexcept { emplace_back(value); }
+        void push_back(T&& value) noexcept { emplace_back(std::move(value)); }
+
+        template <typename... Args>
+        T& emplace_back(Args&&... args) noexcept;
+
+        void pop_back() noexcept;
+
+        void resize(size_t count) noexcept;
+        void resize(size_t count, const T& value) noexcept;
+
+        void clear() noexcept;
+
+        size_t size() const noexcept { return m_size; }
+        static constexpr size_t capacity() noexcept { return N; }
+        bool empty() const noexcept { return m_size == 0; }
+        bool full() const noexcept { return m_size == N; }
+
+    private:
+        alignas(T) uint8_t m_storage[N * sizeof(T)];
+        size_t m_size = 0;
+    };
+}
+
+
+#include "fixed_vector.hpp"
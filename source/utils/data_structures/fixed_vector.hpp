@@ -0,0 +1,108 @@
+namespace ds
+{
+    template <typename T, size_t N>
+    inline FixedVector<T, N>::FixedVector(const FixedVector& other) noexcept
+    {
+        std::uninitialized_copy(other.begin(), other.end(), data());
+        m_size = other.m_size;
+    }
+
+
+    template <typename T, size_t N>
+    inline FixedVector<T, N>& FixedVector<T, N>::operator=(const FixedVector& other) noexcept
+    {
+        if (this != &other) {
+            clear();
+
+            std::uninitialized_copy(other.begin(), other.end(), data());
+            m_size = other.m_size;
+        }
+
+        return *this;
+    }
+
+
+    template <typename T, size_t N>
+    inline FixedVector<T, N>::FixedVector(FixedVector&& other) noexcept
+    {
+        std::uninitialized_move(other.begin(), other.end(), data());
+        m_size = other.m_size;
+
+        other.clear();
+    }
+
+
+    template <typename T, size_t N>
+    inline FixedVector<T, N>& FixedVector<T, N>::operator=(FixedVector&& other) noexcept
+    {
+        if (this != &other) {
+            clear();
+
+            std::uninitialized_move(other.begin(), other.end(), data());
+            m_size = other.m_size;
+
+            other.clear();
+        }
+
+        return *this;
+    }
+
+
+    template <typename T, size_t N>
+    template <typename... Args>
+    inline T& FixedVector<T, N>::emplace_back(Args&&... args) noexcept
+    {
+        AM_ASSERT(m_size < N, "FixedVector capacity ({}) exceeded", N);
+
+        T* pElement = new (data() + m_size) T(std::forward<Args>(args)...);
+        ++m_size;
+
+        return *pElement;
+    }
+
+
+    template <typename T, size_t N>
+    inline void FixedVector<T, N>::pop_back() noexcept
+    {
+        --m_size;
+        std::destroy_at(data() + m_size);
+    }
+
+
+    template <typename T, size_t N>
+    inline void FixedVector<T, N>::resize(size_t count) noexcept
+    {
+        AM_ASSERT(count <= N, "FixedVector capacity ({}) exceeded, requested size: {}", N, count);
+
+        if (count < m_size) {
+            std::destroy(data() + count, data() + m_size);
+        } else if (count > m_size) {
+            std::uninitialized_value_construct(data() + m_size, data() + count);
+        }
+
+        m_size = count;
+    }
+
+
+    template <typename T, size_t N>
+    inline void FixedVector<T, N>::resize(size_t count, const T& value) noexcept
+    {
+        AM_ASSERT(count <= N, "FixedVector capacity ({}) exceeded, requested size: {}", N, count);
+
+        if (count < m_size) {
+            std::destroy(data() + count, data() + m_size);
+        } else if (count > m_size) {
+            std::uninitialized_fill(data() + m_size, data() + count, value);
+        }
+
+        m_size = count;
+    }
+
+
+    template <typename T, size_t N>
+    inline void FixedVector<T, N>::clear() noexcept
+    {
+        std::destroy(data(), data() + m_size);
+        m_size = 0;
+    }
+}
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <utility>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <new>
+#include <tuple>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "hash.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define AM_FLAT_HASH_MAP_SSE2
+    #include <emmintrin.h>
+#endif
+
+
+namespace ds
+{
+    // Hashers which already produce well distributed values (prehashed keys like StrID or ShaderIDProxy)
+    // can declare "using is_avalanching = void;" to skip the additional hash mixing
+    template <typename Hasher, typename = void>
+    struct IsAvalanchingHasher : std::false_type {};
+
+    template <typename Hasher>
+    struct IsAvalanchingHasher<Hasher, std::void_t<typename Hasher::is_avalanching>> : std::true_type {};
+
+
+    namespace detail
+    {
+        // Control byte of every slot: empty, deleted or the low 7 bits of the full slot key hash
+        using FlatHashMapCtrl = int8_t;
+
+        static inline constexpr FlatHashMapCtrl FLAT_HASH_MAP_CTRL_EMPTY = -128;  // 0b10000000
+        static inline constexpr FlatHashMapCtrl FLAT_HASH_MAP_CTRL_DELETED = -2;  // 0b11111110
+
+
+        // Bit set of matched slots in a probed group
+        class FlatHashMapGroupMask
+        {
+        public:
+            FlatHashMapGroupMask(uint64_t mask, uint32_t bitsPerSlotShift) noexcept
+                : m_mask(mask), m_bitsPerSlotShift(bitsPerSlotShift) {}
+
+            bool HasMatches() const noexcept { return m_mask != 0; }
+
+            size_t GetFirstMatchIndex() const noexcept;
+            void RemoveFirstMatch() noexcept { m_mask &= m_mask - 1; }
+
+        private:
+            uint64_t m_mask;
+            uint32_t m_bitsPerSlotShift;
+        };
+
+
+    #if defined(AM_FLAT_HASH_MAP_SSE2)
+        // 16 control bytes probed with single SSE2 compare
+        class FlatHashMapGroup
+        {
+        public:
+            static inline constexpr size_t WIDTH = 16;
+
+        public:
+            explicit FlatHashMapGroup(const FlatHashMapCtrl* pCtrl) noexcept
+                : m_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pCtrl))) {}
+
+            FlatHashMapGroupMask Match(FlatHashMapCtrl h2) const noexcept;
+            FlatHashMapGroupMask MatchEmpty() const noexcept;
+            FlatHashMapGroupMask MatchEmptyOrDeleted() const noexcept;
+
+        private:
+            __m128i m_ctrl;
+        };
+    #else
+        // 8 control bytes probed as one 64-bit word
+        class FlatHashMapGroup
+        {
+        public:
+            static inline constexpr size_t WIDTH = 8;
+
+        public:
+            explicit FlatHashMapGroup(const FlatHashMapCtrl* pCtrl) noexcept { memcpy(&m_ctrl, pCtrl, sizeof(m_ctrl)); }
+
+            // May report false positive matches, which are filtered out by key comparison
+            FlatHashMapGroupMask Match(FlatHashMapCtrl h2) const noexcept;
+            FlatHashMapGroupMask MatchEmpty() const noexcept;
+            FlatHashMapGroupMask MatchEmptyOrDeleted() const noexcept;
+
+        private:
+            uint64_t m_ctrl;
+        };
+    #endif
+    }
+
+
+    // Open addressing hash map with SwissTable layout: separate control bytes array probed by groups with SIMD,
+    // and slots stored inline in one allocation. Has std::unordered_map compatible interface for the used subset,
+    // but unlike it references and iterators are invalidated by rehashing
+    template <typename Key, typename Value, typename Hasher = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+    class FlatHashMap
+    {
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<const Key, Value>;
+        using size_type = size_t;
+        using hasher = Hasher;
+        using key_equal = KeyEqual;
+
+    private:
+        using Ctrl = detail::FlatHashMapCtrl;
+        using Group = detail::FlatHashMapGroup;
+
+        template <bool IsConst>
+        class IteratorImpl
+        {
+            friend class FlatHashMap;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = FlatHashMap::value_type;
+            using difference_type = ptrdiff_t;
+            using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+            using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+
+        public:
+            IteratorImpl() = default;
+
+            // Implicit conversion from iterator to const_iterator
+            template <bool IsOtherConst, typename = std::enable_if_t<IsConst && !IsOtherConst>>
+            IteratorImpl(const IteratorImpl<IsOtherConst>& other) noexcept
+                : m_pCtrl(other.m_pCtrl), m_pSlot(other.m_pSlot), m_pCtrlEnd(other.m_pCtrlEnd) {}
+
+            reference operator*() const noexcept { return *m_pSlot; }
+            pointer operator->() const noexcept { return m_pSlot; }
+
+            IteratorImpl& operator++() noexcept;
+            IteratorImpl operator++(int) noexcept { IteratorImpl it = *this; ++(*this); return it; }
+
+            bool operator==(const IteratorImpl& other) const noexcept { return m_pCtrl == other.m_pCtrl; }
+            bool operator!=(const IteratorImpl& other) const noexcept { return m_pCtrl != other.m_pCtrl; }
+
+        private:
+            IteratorImpl(const Ctrl* pCtrl, pointer pSlot, const Ctrl* pCtrlEnd) noexcept
+                : m_pCtrl(pCtrl), m_pSlot(pSlot), m_pCtrlEnd(pCtrlEnd) {}
+
+            void SkipEmptySlots() noexcept;
+
+        private:
+            const Ctrl* m_pCtrl = nullptr;
+            pointer m_pSlot = nullptr;
+            const Ctrl* m_pCtrlEnd = nullptr;
+        };
+
+    public:
+        using iterator = IteratorImpl<false>;
+        using const_iterator = IteratorImpl<true>;
+
+    public:
+        FlatHashMap() = default;
+        explicit FlatHashMap(size_t capacity) noexcept { reserve(capacity); }
+
+        FlatHashMap(const FlatHashMap& other) noexcept;
+        FlatHashMap& operator=(const FlatHashMap& other) noexcept;
+
+        FlatHashMap(FlatHashMap&& other) noexcept;
+        FlatHashMap& operator=(FlatHashMap&& other) noexcept;
+
+        ~FlatHashMap();
+
+        iterator begin() noexcept;
+        iterator end() noexcept { return iterator(m_pCtrl + m_capacity, nullptr, m_pCtrl + m_capacity); }
+
+        const_iterator begin() const noexcept { return const_cast<FlatHashMap*>(this)->begin(); }
+        const_iterator end() const noexcept { return const_cast<FlatHashMap*>(this)->end(); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+
+        iterator find(const Key& key) noexcept;
+        const_iterator find(const Key& key) const noexcept { return const_cast<FlatHashMap*>(this)->find(key); }
+
+        bool contains(const Key& key) const noexcept { return find(key) != end(); }
+        size_t count(const Key& key) const noexcept { return contains(key) ? 1 : 0; }
+
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) noexcept;
+
+        template <typename... Args>
+        std::pair<iterator, bool> emplace(const Key& key, Args&&... args) noexcept { return try_emplace(key, std::forward<Args>(args)...); }
+
+        std::pair<iterator, bool> insert(const value_type& value) noexcept { return try_emplace(value.first, value.second); }
+
+        template <typename V>
+        std::pair<iterator, bool> insert_or_assign(const Key& key, V&& value) noexcept;
+
+        Value& operator[](const Key& key) noexcept { return try_emplace(key).first->second; }
+
+        size_t erase(const Key& key) noexcept;
+        iterator erase(const_iterator it) noexcept;
+
+        void clear() noexcept;
+        void reserve(size_t count) noexcept;
+
+        size_t size() const noexcept { return m_size; }
+        bool empty() const noexcept { return m_size == 0; }
+        size_t capacity() const noexcept { return m_capacity; }
+
+    private:
+        // Load factor is limited to 7/8
+        static size_t CapacityToGrowth(size_t capacity) noexcept { return capacity - capacity / 8; }
+        static size_t GrowthToCapacity(size_t growth) noexcept;
+
+        static Ctrl GetH2(uint64_t hash) noexcept { return static_cast<Ctrl>(hash & 0x7F); }
+        static uint64_t GetH1(uint64_t hash) noexcept { return hash >> 7; }
+
+        uint64_t HashKey(const Key& key) const noexcept;
+
+        // Probe sequence visits every group exactly once, since groups count is a power of two.
+        // Returns INVALID_SLOT_IDX if there is no such key
+        size_t FindSlot(const Key& key, uint64_t hash) const noexcept;
+        size_t FindInsertSlot(uint64_t hash) const noexcept;
+
+        void SetCtrl(size_t slotIdx, Ctrl ctrl) noexcept { m_pCtrl[slotIdx] = ctrl; }
+        bool IsFull(size_t slotIdx) const noexcept { return m_pCtrl[slotIdx] >= 0; }
+
+        void EraseSlot(size_t slotIdx) noexcept;
+
+        void Rehash(size_t newCapacity) noexcept;
+        void DestroySlots() noexcept;
+        void Deallocate() noexcept;
+
+        iterator MakeIterator(size_t slotIdx) noexcept { return iterator(m_pCtrl + slotIdx, m_pSlots + slotIdx, m_pCtrl + m_capacity); }
+
+        // Control bytes and slots share one allocation, slots follow control bytes
+        static size_t GetSlotsOffset(size_t capacity) noexcept { return (capacity + alignof(value_type) - 1) & ~(alignof(value_type) - 1); }
+
+    private:
+        static inline constexpr size_t INVALID_SLOT_IDX = SIZE_MAX;
+        static inline constexpr size_t ALLOCATION_ALIGNMENT = alignof(value_type) > 16 ? alignof(value_type) : 16;
+
+    private:
+        Ctrl* m_pCtrl = nullptr;
+        value_type* m_pSlots = nullptr;
+
+        size_t m_capacity = 0;
+        size_t m_size = 0;
+        size_t m_growthLeft = 0;
+
+        Hasher m_hasher;
+        KeyEqual m_keyEqual;
+    };
+}
+
+
+#include "flat_hash_map.hpp"
@@ -0,0 +1,450 @@
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+
+namespace ds
+{
+    namespace detail
+    {
+        inline uint32_t CountTrailingZeros64(uint64_t value) noexcept
+        {
+        #if defined(_MSC_VER)
+            unsigned long index = 0;
+            _BitScanForward64(&index, value);
+            return static_cast<uint32_t>(index);
+        #else
+            return static_cast<uint32_t>(__builtin_ctzll(value));
+        #endif
+        }
+
+
+        inline size_t FlatHashMapGroupMask::GetFirstMatchIndex() const noexcept
+        {
+            return CountTrailingZeros64(m_mask) >> m_bitsPerSlotShift;
+        }
+
+
+    #if defined(AM_FLAT_HASH_MAP_SSE2)
+        inline FlatHashMapGroupMask FlatHashMapGroup::Match(FlatHashMapCtrl h2) const noexcept
+        {
+            const __m128i matches = _mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl);
+            return FlatHashMapGroupMask(static_cast<uint32_t>(_mm_movemask_epi8(matches)), 0);
+        }
+
+
+        inline FlatHashMapGroupMask FlatHashMapGroup::MatchEmpty() const noexcept
+        {
+            const __m128i matches = _mm_cmpeq_epi8(_mm_set1_epi8(FLAT_HASH_MAP_CTRL_EMPTY), m_ctrl);
+            return FlatHashMapGroupMask(static_cast<uint32_t>(_mm_movemask_epi8(matches)), 0);
+        }
+
+
+        inline FlatHashMapGroupMask FlatHashMapGroup::MatchEmptyOrDeleted() const noexcept
+        {
+            // Only empty and deleted control bytes have the sign bit set
+            return FlatHashMapGroupMask(static_cast<uint32_t>(_mm_movemask_epi8(m_ctrl)), 0);
+        }
+    #else
+        static inline constexpr uint64_t FLAT_HASH_MAP_GROUP_LSBS = 0x0101010101010101ull;
+        static inline constexpr uint64_t FLAT_HASH_MAP_GROUP_MSBS = 0x8080808080808080ull;
+
+
+        inline FlatHashMapGroupMask FlatHashMapGroup::Match(FlatHashMapCtrl h2) const noexcept
+        {
+            const uint64_t x = m_ctrl ^ (FLAT_HASH_MAP_GROUP_LSBS * static_cast<uint8_t>(h2));
+            return FlatHashMapGroupMask((x - FLAT_HASH_MAP_GROUP_LSBS) & ~x & FLAT_HASH_MAP_GROUP_MSBS, 3);
+        }
+
+
+        inline FlatHashMapGroupMask FlatHashMapGroup::MatchEmpty() const noexcept
+        {
+            // Empty is the only control byte with the sign bit set and bit 1 cleared
+            return FlatHashMapGroupMask(m_ctrl & ~(m_ctrl << 6) & FLAT_HASH_MAP_GROUP_MSBS, 3);
+        }
+
+
+        inline FlatHashMapGroupMask FlatHashMapGroup::MatchEmptyOrDeleted() const noexcept
+        {
+            return FlatHashMapGroupMask(m_ctrl & FLAT_HASH_MAP_GROUP_MSBS, 3);
+        }
+    #endif
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    template <bool IsConst>
+    inline typename FlatHashMap<Key, Value, Hasher, KeyEqual>::template IteratorImpl<IsConst>&
+        FlatHashMap<Key, Value, Hasher, KeyEqual>::IteratorImpl<IsConst>::operator++() noexcept
+    {
+        ++m_pCtrl;
+        ++m_pSlot;
+
+        SkipEmptySlots();
+
+        return *this;
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    template <bool IsConst>
+    inline void FlatHashMap<Key, Value, Hasher, KeyEqual>::IteratorImpl<IsConst>::SkipEmptySlots() noexcept
+    {
+        while (m_pCtrl != m_pCtrlEnd && *m_pCtrl < 0) {
+            ++m_pCtrl;
+            ++m_pSlot;
+        }
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline FlatHashMap<Key, Value, Hasher, KeyEqual>::FlatHashMap(const FlatHashMap& other) noexcept
+        : m_hasher(other.m_hasher), m_keyEqual(other.m_keyEqual)
+    {
+        reserve(other.size());
+
+        for (const value_type& value : other) {
+            try_emplace(value.first, value.second);
+        }
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline FlatHashMap<Key, Value, Hasher, KeyEqual>& FlatHashMap<Key, Value, Hasher, KeyEqual>::operator=(const FlatHashMap& other) noexcept
+    {
+        if (this != &other) {
+            *this = FlatHashMap(other);
+        }
+
+        return *this;
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline FlatHashMap<Key, Value, Hasher, KeyEqual>::FlatHashMap(FlatHashMap&& other) noexcept
+        : m_pCtrl(other.m_pCtrl), m_pSlots(other.m_pSlots), m_capacity(other.m_capacity), m_size(other.m_size), m_growthLeft(other.m_growthLeft),
+        m_hasher(std::move(other.m_hasher)), m_keyEqual(std::move(other.m_keyEqual))
+    {
+        other.m_pCtrl = nullptr;
+        other.m_pSlots = nullptr;
+        other.m_capacity = 0;
+        other.m_size = 0;
+        other.m_growthLeft = 0;
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline FlatHashMap<Key, Value, Hasher, KeyEqual>& FlatHashMap<Key, Value, Hasher, KeyEqual>::operator=(FlatHashMap&& other) noexcept
+    {
+        if (this == &other) {
+            return *this;
+        }
+
+        DestroySlots();
+        Deallocate();
+
+        m_pCtrl = std::exchange(other.m_pCtrl, nullptr);
+        m_pSlots = std::exchange(other.m_pSlots, nullptr);
+        m_capacity = std::exchange(other.m_capacity, 0);
+        m_size = std::exchange(other.m_size, 0);
+        m_growthLeft = std::exchange(other.m_growthLeft, 0);
+
+        m_hasher = std::move(other.m_hasher);
+        m_keyEqual = std::move(other.m_keyEqual);
+
+        return *this;
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline FlatHashMap<Key, Value, Hasher, KeyEqual>::~FlatHashMap()
+    {
+        DestroySlots();
+        Deallocate();
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline typename FlatHashMap<Key, Value, Hasher, KeyEqual>::iterator FlatHashMap<Key, Value, Hasher, KeyEqual>::begin() noexcept
+    {
+        if (m_size == 0) {
+            return end();
+        }
+
+        iterator it = MakeIterator(0);
+        it.SkipEmptySlots();
+
+        return it;
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline typename FlatHashMap<Key, Value, Hasher, KeyEqual>::iterator FlatHashMap<Key, Value, Hasher, KeyEqual>::find(const Key& key) noexcept
+    {
+        const size_t slotIdx = FindSlot(key, HashKey(key));
+        return slotIdx != INVALID_SLOT_IDX ? MakeIterator(slotIdx) : end();
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    template <typename... Args>
+    inline std::pair<typename FlatHashMap<Key, Value, Hasher, KeyEqual>::iterator, bool>
+        FlatHashMap<Key, Value, Hasher, KeyEqual>::try_emplace(const Key& key, Args&&... args) noexcept
+    {
+        const uint64_t hash = HashKey(key);
+
+        const size_t existingSlotIdx = FindSlot(key, hash);
+        if (existingSlotIdx != INVALID_SLOT_IDX) {
+            return std::make_pair(MakeIterator(existingSlotIdx), false);
+        }
+
+        size_t slotIdx = m_capacity > 0 ? FindInsertSlot(hash) : INVALID_SLOT_IDX;
+
+        // Deleted slots can be reused even if there is no growth left
+        if (m_growthLeft == 0 && (slotIdx == INVALID_SLOT_IDX || m_pCtrl[slotIdx] == detail::FLAT_HASH_MAP_CTRL_EMPTY)) {
+            Rehash(GrowthToCapacity(m_size * 2 + 1));
+            slotIdx = FindInsertSlot(hash);
+        }
+
+        if (m_pCtrl[slotIdx] == detail::FLAT_HASH_MAP_CTRL_EMPTY) {
+            --m_growthLeft;
+        }
+
+        SetCtrl(slotIdx, GetH2(hash));
+        new (m_pSlots + slotIdx) value_type(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+
+        ++m_size;
+
+        return std::make_pair(MakeIterator(slotIdx), true);
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    template <typename V>
+    inline std::pair<typename FlatHashMap<Key, Value, Hasher, KeyEqual>::iterator, bool>
+        FlatHashMap<Key, Value, Hasher, KeyEqual>::insert_or_assign(const Key& key, V&& value) noexcept
+    {
+        std::pair<iterator, bool> result = try_emplace(key);
+        result.first->second = std::forward<V>(value);
+
+        return result;
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline size_t FlatHashMap<Key, Value, Hasher, KeyEqual>::erase(const Key& key) noexcept
+    {
+        const size_t slotIdx = FindSlot(key, HashKey(key));
+
+        if (slotIdx == INVALID_SLOT_IDX) {
+            return 0;
+        }
+
+        EraseSlot(slotIdx);
+
+        return 1;
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline typename FlatHashMap<Key, Value, Hasher, KeyEqual>::iterator FlatHashMap<Key, Value, Hasher, KeyEqual>::erase(const_iterator it) noexcept
+    {
+        const size_t slotIdx = static_cast<size_t>(it.m_pCtrl - m_pCtrl);
+
+        EraseSlot(slotIdx);
+
+        iterator nextIt = MakeIterator(slotIdx);
+        nextIt.SkipEmptySlots();
+
+        return nextIt;
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline void FlatHashMap<Key, Value, Hasher, KeyEqual>::clear() noexcept
+    {
+        DestroySlots();
+
+        if (m_capacity > 0) {
+            memset(m_pCtrl, static_cast<uint8_t>(detail::FLAT_HASH_MAP_CTRL_EMPTY), m_capacity);
+        }
+
+        m_size = 0;
+        m_growthLeft = CapacityToGrowth(m_capacity);
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline void FlatHashMap<Key, Value, Hasher, KeyEqual>::reserve(size_t count) noexcept
+    {
+        if (count > m_size + m_growthLeft) {
+            Rehash(GrowthToCapacity(count));
+        }
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline size_t FlatHashMap<Key, Value, Hasher, KeyEqual>::GrowthToCapacity(size_t growth) noexcept
+    {
+        size_t capacity = Group::WIDTH;
+
+        while (CapacityToGrowth(capacity) < growth) {
+            capacity *= 2;
+        }
+
+        return capacity;
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline uint64_t FlatHashMap<Key, Value, Hasher, KeyEqual>::HashKey(const Key& key) const noexcept
+    {
+        const uint64_t hash = static_cast<uint64_t>(m_hasher(key));
+
+        if constexpr (IsAvalanchingHasher<Hasher>::value) {
+            return hash;
+        } else {
+            return detail::HashMul128Fold64(hash, 0x9E3779B97F4A7C15ull);
+        }
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline size_t FlatHashMap<Key, Value, Hasher, KeyEqual>::FindSlot(const Key& key, uint64_t hash) const noexcept
+    {
+        if (m_size == 0) {
+            return INVALID_SLOT_IDX;
+        }
+
+        const size_t groupsMask = m_capacity / Group::WIDTH - 1;
+        const Ctrl h2 = GetH2(hash);
+
+        size_t groupIdx = GetH1(hash) & groupsMask;
+
+        for (size_t step = 1; ; ++step) {
+            const size_t groupBeginSlotIdx = groupIdx * Group::WIDTH;
+            const Group group(m_pCtrl + groupBeginSlotIdx);
+
+            for (detail::FlatHashMapGroupMask matches = group.Match(h2); matches.HasMatches(); matches.RemoveFirstMatch()) {
+                const size_t slotIdx = groupBeginSlotIdx + matches.GetFirstMatchIndex();
+
+                if (m_keyEqual(m_pSlots[slotIdx].first, key)) {
+                    return slotIdx;
+                }
+            }
+
+            // Inserts fill the first free slot of the probe sequence, so the key can't be further than a group with empty slot
+            if (group.MatchEmpty().HasMatches()) {
+                return INVALID_SLOT_IDX;
+            }
+
+            groupIdx = (groupIdx + step) & groupsMask;
+        }
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline size_t FlatHashMap<Key, Value, Hasher, KeyEqual>::FindInsertSlot(uint64_t hash) const noexcept
+    {
+        const size_t groupsMask = m_capacity / Group::WIDTH - 1;
+
+        size_t groupIdx = GetH1(hash) & groupsMask;
+
+        // Load factor limit guarantees that there is always an empty slot, so the loop terminates
+        for (size_t step = 1; ; ++step) {
+            const size_t groupBeginSlotIdx = groupIdx * Group::WIDTH;
+            const detail::FlatHashMapGroupMask freeSlots = Group(m_pCtrl + groupBeginSlotIdx).MatchEmptyOrDeleted();
+
+            if (freeSlots.HasMatches()) {
+                return groupBeginSlotIdx + freeSlots.GetFirstMatchIndex();
+            }
+
+            groupIdx = (groupIdx + step) & groupsMask;
+        }
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline void FlatHashMap<Key, Value, Hasher, KeyEqual>::EraseSlot(size_t slotIdx) noexcept
+    {
+        m_pSlots[slotIdx].~value_type();
+        --m_size;
+
+        // Probe sequences never continue past a group with an empty slot, so such group's slots can become empty
+        // instead of tombstones without breaking lookups
+        const size_t groupBeginSlotIdx = slotIdx - slotIdx % Group::WIDTH;
+
+        if (Group(m_pCtrl + groupBeginSlotIdx).MatchEmpty().HasMatches()) {
+            SetCtrl(slotIdx, detail::FLAT_HASH_MAP_CTRL_EMPTY);
+            ++m_growthLeft;
+        } else {
+            SetCtrl(slotIdx, detail::FLAT_HASH_MAP_CTRL_DELETED);
+        }
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline void FlatHashMap<Key, Value, Hasher, KeyEqual>::Rehash(size_t newCapacity) noexcept
+    {
+        Ctrl* pOldCtrl = m_pCtrl;
+        value_type* pOldSlots = m_pSlots;
+        const size_t oldCapacity = m_capacity;
+
+        const size_t slotsOffset = GetSlotsOffset(newCapacity);
+
+        m_pCtrl = static_cast<Ctrl*>(::operator new(slotsOffset + newCapacity * sizeof(value_type), std::align_val_t(ALLOCATION_ALIGNMENT)));
+        m_pSlots = reinterpret_cast<value_type*>(reinterpret_cast<uint8_t*>(m_pCtrl) + slotsOffset);
+        m_capacity = newCapacity;
+        m_growthLeft = CapacityToGrowth(newCapacity) - m_size;
+
+        memset(m_pCtrl, static_cast<uint8_t>(detail::FLAT_HASH_MAP_CTRL_EMPTY), newCapacity);
+
+        for (size_t i = 0; i < oldCapacity; ++i) {
+            if (pOldCtrl[i] < 0) {
+                continue;
+            }
+
+            value_type& oldSlot = pOldSlots[i];
+
+            const uint64_t hash = HashKey(oldSlot.first);
+            const size_t slotIdx = FindInsertSlot(hash);
+
+            SetCtrl(slotIdx, GetH2(hash));
+            new (m_pSlots + slotIdx) value_type(std::move(oldSlot));
+
+            oldSlot.~value_type();
+        }
+
+        if (pOldCtrl) {
+            ::operator delete(pOldCtrl, std::align_val_t(ALLOCATION_ALIGNMENT));
+        }
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline void FlatHashMap<Key, Value, Hasher, KeyEqual>::DestroySlots() noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_t i = 0; i < m_capacity; ++i) {
+                if (IsFull(i)) {
+                    m_pSlots[i].~value_type();
+                }
+            }
+        }
+    }
+
+
+    template <typename Key, typename Value, typename Hasher, typename KeyEqual>
+    inline void FlatHashMap<Key, Value, Hasher, KeyEqual>::Deallocate() noexcept
+    {
+        if (m_pCtrl) {
+            ::operator delete(m_pCtrl, std::align_val_t(ALLOCATION_ALIGNMENT));
+        }
+
+        m_pCtrl = nullptr;
+        m_pSlots = nullptr;
+        m_capacity = 0;
+        m_size = 0;
+        m_growthLeft = 0;
+    }
+}
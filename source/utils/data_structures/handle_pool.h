@@ -0,0 +1,117 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace ds
+{
+    // 32-bit reference to the HandlePool object: low bits are the slot index, high bits are the slot generation.
+    // Handle becomes stale when the object is removed, even if its slot is reused later
+    template <typename T>
+    class Handle
+    {
+    public:
+        static inline constexpr uint32_t INDEX_BITS = 20;
+        static inline constexpr uint32_t GENERATION_BITS = 32 - INDEX_BITS;
+
+        static inline constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+        static inline constexpr uint32_t GENERATION_MASK = (1u << GENERATION_BITS) - 1;
+
+        static inline constexpr uint32_t INVALID_VALUE = UINT32_MAX;
+
+    public:
+        constexpr Handle() = default;
+        constexpr Handle(uint32_t index, uint32_t generation) noexcept
+            : m_value((index & INDEX_MASK) | ((generation & GENERATION_MASK) << INDEX_BITS)) {}
+
+        constexpr uint32_t GetIndex() const noexcept { return m_value & INDEX_MASK; }
+        constexpr uint32_t GetGeneration() const noexcept { return m_value >> INDEX_BITS; }
+        constexpr uint32_t GetValue() const noexcept { return m_value; }
+
+        // Checks only that the handle was issued by some pool, use HandlePool::IsValid() to check the object is alive
+        constexpr bool IsValid() const noexcept { return m_value != INVALID_VALUE; }
+
+        constexpr bool operator==(const Handle& other) const noexcept { return m_value == other.m_value; }
+        constexpr bool operator!=(const Handle& other) const noexcept { return m_value != other.m_value; }
+
+    private:
+        uint32_t m_value = INVALID_VALUE;
+    };
+
+
+    // Slot map: objects are stored densely and can be iterated as a plain array, handles are resolved
+    // in O(1) through the sparse slots array. Removal moves the last object into the freed place,
+    // so pointers to objects and iteration order are not stable, but handles are.
+    // Slot which ran out of generations is retired and never reused, so a stale handle can't alias a newer object
+    template <typename T>
+    class HandlePool
+    {
+    public:
+        using HandleType = Handle<T>;
+
+        // Slot with all index bits set is never issued, so the invalid handle never resolves
+        static inline constexpr size_t MAX_SIZE = HandleType::INDEX_MASK;
+
+    public:
+        HandlePool() = default;
+        explicit HandlePool(size_t capacity) noexcept { Reserve(capacity); }
+
+        HandleType Add(const T& value) noexcept { return Emplace(value); }
+        HandleType Add(T&& value) noexcept { return Emplace(std::move(value)); }
+
+        template <typename... Args>
+        HandleType Emplace(Args&&... args) noexcept;
+
+        // Returns false if the handle is stale
+        bool Remove(HandleType handle) noexcept;
+
+        // Returns nullptr if the handle is stale
+        T* Get(HandleType handle) noexcept;
+        const T* Get(HandleType handle) const noexcept { return const_cast<HandlePool*>(this)->Get(handle); }
+
+        bool IsValid(HandleType handle) const noexcept { return Get(handle) != nullptr; }
+
+        // Handle of the object at the dense position, for iteration with handles
+        HandleType GetHandle(size_t denseIdx) const noexcept;
+
+        // Invalidates all issued handles
+        void Clear() noexcept;
+        void Reserve(size_t capacity) noexcept;
+
+        T* begin() noexcept { return m_objects.data(); }
+        T* end() noexcept { return m_objects.data() + m_objects.size(); }
+
+        const T* begin() const noexcept { return m_objects.data(); }
+        const T* end() const noexcept { return m_objects.data() + m_objects.size(); }
+
+        size_t Size() const noexcept { return m_objects.size(); }
+        bool IsEmpty() const noexcept { return m_objects.empty(); }
+
+    private:
+        struct Slot
+        {
+            uint32_t denseIdx;
+            uint32_t generation;
+        };
+
+        static inline constexpr uint32_t INVALID_DENSE_IDX = UINT32_MAX;
+
+    private:
+        uint32_t AcquireSlot() noexcept;
+        void ReleaseSlot(uint32_t slotIdx) noexcept;
+
+    private:
+        std::vector<T> m_objects;
+        std::vector<uint32_t> m_denseToSlot;
+
+        std::vector<Slot> m_slots;
+        std::vector<uint32_t> m_freeSlots;
+    };
+}
+
+
+#include "handle_pool.hpp"
@@ -0,0 +1,139 @@
+namespace ds
+{
+    template <typename T>
+    template <typename... Args>
+    inline typename HandlePool<T>::HandleType HandlePool<T>::Emplace(Args&&... args) noexcept
+    {
+        const uint32_t slotIdx = AcquireSlot();
+
+        if (slotIdx == INVALID_DENSE_IDX) {
+            return HandleType();
+        }
+
+        Slot& slot = m_slots[slotIdx];
+        slot.denseIdx = static_cast<uint32_t>(m_objects.size());
+
+        m_objects.emplace_back(std::forward<Args>(args)...);
+        m_denseToSlot.emplace_back(slotIdx);
+
+        return HandleType(slotIdx, slot.generation);
+    }
+
+
+    template <typename T>
+    inline bool HandlePool<T>::Remove(HandleType handle) noexcept
+    {
+        if (!IsValid(handle)) {
+            return false;
+        }
+
+        const uint32_t slotIdx = handle.GetIndex();
+        const uint32_t denseIdx = m_slots[slotIdx].denseIdx;
+        const uint32_t lastDenseIdx = static_cast<uint32_t>(m_objects.size() - 1);
+
+        if (denseIdx != lastDenseIdx) {
+            m_objects[denseIdx] = std::move(m_objects[lastDenseIdx]);
+            m_denseToSlot[denseIdx] = m_denseToSlot[lastDenseIdx];
+            m_slots[m_denseToSlot[denseIdx]].denseIdx = denseIdx;
+        }
+
+        m_objects.pop_back();
+        m_denseToSlot.pop_back();
+
+        ReleaseSlot(slotIdx);
+
+        return true;
+    }
+
+
+    template <typename T>
+    inline T* HandlePool<T>::Get(HandleType handle) noexcept
+    {
+        const uint32_t slotIdx = handle.GetIndex();
+
+        if (slotIdx >= m_slots.size()) {
+            return nullptr;
+        }
+
+        const Slot& slot = m_slots[slotIdx];
+
+        if (slot.denseIdx == INVALID_DENSE_IDX || slot.generation != handle.GetGeneration()) {
+            return nullptr;
+        }
+
+        return &m_objects[slot.denseIdx];
+    }
+
+
+    template <typename T>
+    inline typename HandlePool<T>::HandleType HandlePool<T>::GetHandle(size_t denseIdx) const noexcept
+    {
+        if (denseIdx >= m_denseToSlot.size()) {
+            return HandleType();
+        }
+
+        const uint32_t slotIdx = m_denseToSlot[denseIdx];
+        return HandleType(slotIdx, m_slots[slotIdx].generation);
+    }
+
+
+    template <typename T>
+    inline void HandlePool<T>::Clear() noexcept
+    {
+        for (const uint32_t slotIdx : m_denseToSlot) {
+            ReleaseSlot(slotIdx);
+        }
+
+        m_objects.clear();
+        m_denseToSlot.clear();
+    }
+
+
+    template <typename T>
+    inline void HandlePool<T>::Reserve(size_t capacity) noexcept
+    {
+        capacity = capacity < MAX_SIZE ? capacity : MAX_SIZE;
+
+        m_objects.reserve(capacity);
+        m_denseToSlot.reserve(capacity);
+        m_slots.reserve(capacity);
+        m_freeSlots.reserve(capacity);
+    }
+
+
+    template <typename T>
+    inline uint32_t HandlePool<T>::AcquireSlot() noexcept
+    {
+        if (!m_freeSlots.empty()) {
+            const uint32_t slotIdx = m_freeSlots.back();
+            m_freeSlots.pop_back();
+
+            return slotIdx;
+        }
+
+        if (m_slots.size() >= MAX_SIZE) {
+            return INVALID_DENSE_IDX;
+        }
+
+        m_slots.emplace_back(Slot { INVALID_DENSE_IDX, 0 });
+        return static_cast<uint32_t>(m_slots.size() - 1);
+    }
+
+
+    template <typename T>
+    inline void HandlePool<T>::ReleaseSlot(uint32_t slotIdx) noexcept
+    {
+        Slot& slot = m_slots[slotIdx];
+
+        slot.denseIdx = INVALID_DENSE_IDX;
+
+        // Wrapped generation would make handles of the slot's first object valid again, so the slot is retired instead
+        if (slot.generation == HandleType::GENERATION_MASK) {
+            return;
+        }
+
+        ++slot.generation;
+
+        m_freeSlots.emplace_back(slotIdx);
+    }
+}
@@ -1,7 +1,25 @@
 #pragma once
 
-#include <cstdint>
+#include <array>
 #include <type_traits>
+#include <string_view>
+
+#include <cstdint>
+#include <cstring>
+
+
+namespace ds
+{
+    struct Hash128
+    {
+        uint64_t lo = 0;
+        uint64_t hi = 0;
+
+        constexpr bool operator==(const Hash128& other) const noexcept { return lo == other.lo && hi == other.hi; }
+        constexpr bool operator!=(const Hash128& other) const noexcept { return !(*this == other); }
+        constexpr bool operator<(const Hash128& other) const noexcept { return hi != other.hi ? hi < other.hi : lo < other.lo; }
+    };
+}
 
 
 template <typename T>
@@ -14,37 +32,76 @@ inline uint64_t amHash(const T& value) noexcept
 }
 
 
-inline uint64_t amHashMem(const void* data, size_t size) noexcept
+// FNV-1a over code unit bytes in little-endian order. Usable in constant expressions, so string literals can be hashed at compile time.
+// Matches MSVC std::hash of the same string, so runtime and compile-time hashes of a string are interchangeable
+template <typename CharT>
+constexpr uint64_t amHashConstexpr(const CharT* str, size_t length) noexcept
 {
-    if (!data || size == 0) {
-        return 0;
-    }
+    using UnsignedCharT = std::make_unsigned_t<CharT>;
 
-    const uint64_t* ptr = reinterpret_cast<const uint64_t*>(data);
-
-    uint64_t hash = 0;
-    int64_t remaining = size / sizeof(uint64_t);
-    
-    while (remaining > 0) {
-        hash ^= *ptr++;
-        hash *= 1103515245ull;
-        hash ^= *ptr++;
-        hash *= 1103515245ull;
-        remaining -= (int64_t)sizeof(uint64_t);
+    uint64_t hash = 14695981039346656037ull;
+
+    for (size_t i = 0; i < length; ++i) {
+        const UnsignedCharT ch = static_cast<UnsignedCharT>(str[i]);
+
+        for (size_t byteIdx = 0; byteIdx < sizeof(CharT); ++byteIdx) {
+            hash ^= static_cast<uint8_t>(ch >> (byteIdx * 8));
+            hash *= 1099511628211ull;
+        }
     }
 
-    const uint8_t* tail = reinterpret_cast<const uint8_t*>(ptr);
-    const size_t tailLength = size % sizeof(uint64_t);
+    return hash;
+}
+
+
+constexpr uint64_t amHashConstexpr(std::string_view str) noexcept { return amHashConstexpr(str.data(), str.size()); }
+constexpr uint64_t amHashConstexpr(std::wstring_view str) noexcept { return amHashConstexpr(str.data(), str.size()); }
+
+
+// 128-bit FNV-1a over code unit bytes in little-endian order. Usable in constant expressions
+template <typename CharT>
+constexpr ds::Hash128 amHash128Constexpr(const CharT* str, size_t length) noexcept
+{
+    using UnsignedCharT = std::make_unsigned_t<CharT>;
 
-    for (size_t i = 0; i < tailLength; ++i) {
-        hash ^= static_cast<uint64_t>(tail[i]) << (i * 8);
-        hash *= 1103515245ull;
+    // FNV-128 prime is 2^88 + 0x13B
+    constexpr uint64_t PRIME_LOW_PART = 0x13Bull;
+
+    ds::Hash128 hash = { 0x62B821756295C58Dull, 0x6C62272E07BB0142ull };
+
+    for (size_t i = 0; i < length; ++i) {
+        const UnsignedCharT ch = static_cast<UnsignedCharT>(str[i]);
+
+        for (size_t byteIdx = 0; byteIdx < sizeof(CharT); ++byteIdx) {
+            hash.lo ^= static_cast<uint8_t>(ch >> (byteIdx * 8));
+
+            const uint64_t loLowMul  = (hash.lo & 0xFFFFFFFFull) * PRIME_LOW_PART;
+            const uint64_t loHighMul = (hash.lo >> 32) * PRIME_LOW_PART;
+
+            const uint64_t newLo = loLowMul + (loHighMul << 32);
+            const uint64_t carry = (loHighMul >> 32) + (newLo < loLowMul ? 1ull : 0ull);
+
+            hash.hi = hash.hi * PRIME_LOW_PART + carry + (hash.lo << 24);
+            hash.lo = newLo;
+        }
     }
 
     return hash;
 }
 
 
+constexpr ds::Hash128 amHash128Constexpr(std::string_view str) noexcept { return amHash128Constexpr(str.data(), str.size()); }
+constexpr ds::Hash128 amHash128Constexpr(std::wstring_view str) noexcept { return amHash128Constexpr(str.data(), str.size()); }
+
+
+// XXH3-style memory hash. Inputs longer than 128 bytes are consumed in 64-byte stripes by 8 independent accumulator lanes,
+// vectorized with AVX2, SSE2 or NEON depending on the target. All backends produce identical results
+inline uint64_t amHashMem(const void* data, size_t size) noexcept;
+
+// 128-bit variant of amHashMem. Its low part is equal to amHashMem result
+inline ds::Hash128 amHashMem128(const void* data, size_t size) noexcept;
+
+
 namespace ds
 {
     class HashBuilder
@@ -53,22 +110,58 @@ namespace ds
         HashBuilder() = default;
 
         template <typename T>
-        void AddValue(const T& value) noexcept
-        {
-            m_value *= 31ull;
-            m_value += amHash(value);
-        }
+        void AddValue(const T& value) noexcept { Combine(amHash(value)); }
 
-        void AddMemory(const void* ptr, size_t size) noexcept
-        {
-            m_value *= 31ull;
-            m_value += amHashMem(ptr, size);
-        }
+        void AddMemory(const void* ptr, size_t size) noexcept { Combine(amHashMem(ptr, size)); }
 
         void Clear() noexcept { m_value = 0; }
         uint64_t Value() const noexcept { return m_value; }
 
+    private:
+        void Combine(uint64_t hash) noexcept;
+
     private:
         uint64_t m_value = 0;
     };
-}
\ No newline at end of file
+
+
+    // Incremental version of amHashMem and amHashMem128 for inputs which are read in chunks.
+    // Results don't depend on how the input is split and are equal to the one-shot functions results
+    class StreamHasher
+    {
+    public:
+        StreamHasher() noexcept { Reset(); }
+
+        void Reset() noexcept;
+        void Update(const void* data, size_t size) noexcept;
+
+        uint64_t Finalize() const noexcept;
+        Hash128 Finalize128() const noexcept;
+
+        uint64_t GetTotalSize() const noexcept { return m_totalSize; }
+
+    private:
+        static inline constexpr size_t ACC_LANES_COUNT = 8ull;
+        static inline constexpr size_t STRIPE_SIZE = 64ull;
+
+        // Must be a multiple of the stripe size and bigger than amHashMem short input size
+        static inline constexpr size_t BUFFER_SIZE = 4ull * STRIPE_SIZE;
+
+    private:
+        // Copies accumulators and consumes buffered stripes, except the last one which is merged separately
+        void PrepareFinalAccumulators(uint64_t* pAcc, const uint8_t*& pOutLastStripe, uint8_t* pLastStripeStorage) const noexcept;
+
+        void ConsumeStripes(uint64_t* pAcc, size_t& stripeIdx, const uint8_t* pStripes, size_t stripesCount) const noexcept;
+
+    private:
+        alignas(64) uint64_t m_acc[ACC_LANES_COUNT];
+        alignas(64) uint8_t m_buffer[BUFFER_SIZE];
+
+        uint64_t m_totalSize = 0;
+        size_t m_bufferedSize = 0;
+        size_t m_stripeIdx = 0;
+    };
+}
+
+
+#include "hash.hpp"
@@ -0,0 +1,611 @@
+#if !defined(AM_HASH_SIMD_DISABLED)
+    #if defined(__AVX2__)
+        #define AM_HASH_SIMD_AVX2
+        #include <immintrin.h>
+    #elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define AM_HASH_SIMD_SSE2
+        #include <emmintrin.h>
+    #elif defined(__ARM_NEON) || defined(_M_ARM64)
+        #define AM_HASH_SIMD_NEON
+        #include <arm_neon.h>
+    #endif
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h>
+#endif
+
+
+namespace ds::detail
+{
+    static inline constexpr uint64_t HASH_PRIME32_1 = 0x9E3779B1ull;
+    static inline constexpr uint64_t HASH_PRIME32_2 = 0x85EBCA77ull;
+    static inline constexpr uint64_t HASH_PRIME32_3 = 0xC2B2AE3Dull;
+    static inline constexpr uint64_t HASH_PRIME64_1 = 0x9E3779B185EBCA87ull;
+    static inline constexpr uint64_t HASH_PRIME64_2 = 0xC2B2AE3D27D4EB4Full;
+    static inline constexpr uint64_t HASH_PRIME64_3 = 0x165667B19E3779F9ull;
+    static inline constexpr uint64_t HASH_PRIME64_4 = 0x85EBCA77C2B2AE63ull;
+    static inline constexpr uint64_t HASH_PRIME64_5 = 0x27D4EB2F165667C5ull;
+
+    static inline constexpr size_t HASH_ACC_LANES_COUNT = 8ull;
+    static inline constexpr size_t HASH_STRIPE_SIZE = HASH_ACC_LANES_COUNT * sizeof(uint64_t);
+    static inline constexpr size_t HASH_STRIPES_PER_BLOCK_COUNT = 16ull;
+    static inline constexpr size_t HASH_BLOCK_SIZE = HASH_STRIPE_SIZE * HASH_STRIPES_PER_BLOCK_COUNT;
+    static inline constexpr size_t HASH_SHORT_INPUT_MAX_SIZE = 128ull;
+
+    // Secret word offsets. Each stripe of a block uses its own key window shifted by one word
+    static inline constexpr size_t HASH_SECRET_SCRAMBLE_OFFSET = 24ull;
+    static inline constexpr size_t HASH_SECRET_SHORT128_OFFSET = 24ull;
+    static inline constexpr size_t HASH_SECRET_MERGE128_OFFSET = 32ull;
+    static inline constexpr size_t HASH_SECRET_LAST_STRIPE_OFFSET = 33ull;
+    static inline constexpr size_t HASH_SECRET_MERGE_OFFSET = 40ull;
+    static inline constexpr size_t HASH_SECRET_WORDS_COUNT = 48ull;
+
+
+    constexpr std::array<uint64_t, HASH_SECRET_WORDS_COUNT> MakeHashSecret() noexcept
+    {
+        std::array<uint64_t, HASH_SECRET_WORDS_COUNT> secret = {};
+
+        // SplitMix64 sequence
+        uint64_t state = HASH_PRIME64_1;
+        for (uint64_t& word : secret) {
+            state += 0x9E3779B97F4A7C15ull;
+
+            uint64_t value = state;
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+            word = value ^ (value >> 31);
+        }
+
+        return secret;
+    }
+
+
+    alignas(64) static inline constexpr std::array<uint64_t, HASH_SECRET_WORDS_COUNT> HASH_SECRET = MakeHashSecret();
+
+
+    inline uint64_t HashRead64(const uint8_t* ptr) noexcept
+    {
+        uint64_t value;
+        memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+
+    inline uint32_t HashRead32(const uint8_t* ptr) noexcept
+    {
+        uint32_t value;
+        memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+
+    // Low and high halves of 128-bit product folded together
+    inline uint64_t HashMul128Fold64(uint64_t lhs, uint64_t rhs) noexcept
+    {
+    #if defined(__SIZEOF_INT128__)
+        const __uint128_t product = static_cast<__uint128_t>(lhs) * rhs;
+        return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+    #elif defined(_MSC_VER) && defined(_M_X64)
+        uint64_t productHigh = 0;
+        const uint64_t productLow = _umul128(lhs, rhs, &productHigh);
+        return productLow ^ productHigh;
+    #else
+        const uint64_t loLo = (lhs & 0xFFFFFFFFull) * (rhs & 0xFFFFFFFFull);
+        const uint64_t hiLo = (lhs >> 32) * (rhs & 0xFFFFFFFFull);
+        const uint64_t loHi = (lhs & 0xFFFFFFFFull) * (rhs >> 32);
+        const uint64_t hiHi = (lhs >> 32) * (rhs >> 32);
+
+        const uint64_t cross = (loLo >> 32) + (hiLo & 0xFFFFFFFFull) + loHi;
+        const uint64_t productHigh = (hiLo >> 32) + (cross >> 32) + hiHi;
+        const uint64_t productLow = (cross << 32) | (loLo & 0xFFFFFFFFull);
+
+        return productLow ^ productHigh;
+    #endif
+    }
+
+
+    inline uint64_t HashAvalanche(uint64_t hash) noexcept
+    {
+        hash ^= hash >> 37;
+        hash *= 0x165667919E3779F9ull;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+
+    inline uint64_t HashMix16(const uint8_t* pData, const uint64_t* pKey) noexcept
+    {
+        return HashMul128Fold64(HashRead64(pData) ^ pKey[0], HashRead64(pData + 8) ^ pKey[1]);
+    }
+
+
+    // Reference implementation of stripe accumulation, SIMD backends must match it bit to bit
+    struct HashScalarBackend
+    {
+        static void Accumulate(uint64_t* pAcc, const uint8_t* pData, const uint64_t* pKey) noexcept
+        {
+            for (size_t i = 0; i < HASH_ACC_LANES_COUNT; ++i) {
+                const uint64_t data = HashRead64(pData + i * sizeof(uint64_t));
+                const uint64_t dataKey = data ^ pKey[i];
+
+                pAcc[i ^ 1] += data;
+                pAcc[i] += (dataKey & 0xFFFFFFFFull) * (dataKey >> 32);
+            }
+        }
+
+        static void Scramble(uint64_t* pAcc, const uint64_t* pKey) noexcept
+        {
+            for (size_t i = 0; i < HASH_ACC_LANES_COUNT; ++i) {
+                uint64_t acc = pAcc[i];
+                acc ^= acc >> 47;
+                acc ^= pKey[i];
+                pAcc[i] = acc * HASH_PRIME32_1;
+            }
+        }
+    };
+
+
+#if defined(AM_HASH_SIMD_AVX2)
+    struct HashAVX2Backend
+    {
+        static void Accumulate(uint64_t* pAcc, const uint8_t* pData, const uint64_t* pKey) noexcept
+        {
+            for (size_t i = 0; i < HASH_ACC_LANES_COUNT / 4; ++i) {
+                __m256i* pAccVec = reinterpret_cast<__m256i*>(pAcc) + i;
+
+                const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pData) + i);
+                const __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pKey) + i);
+                const __m256i dataKey = _mm256_xor_si256(data, key);
+
+                const __m256i dataKeyHigh = _mm256_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1));
+                const __m256i product = _mm256_mul_epu32(dataKey, dataKeyHigh);
+                const __m256i dataSwapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+
+                const __m256i acc = _mm256_loadu_si256(pAccVec);
+                _mm256_storeu_si256(pAccVec, _mm256_add_epi64(acc, _mm256_add_epi64(product, dataSwapped)));
+            }
+        }
+
+        static void Scramble(uint64_t* pAcc, const uint64_t* pKey) noexcept
+        {
+            const __m256i prime = _mm256_set1_epi32(static_cast<int32_t>(HASH_PRIME32_1));
+
+            for (size_t i = 0; i < HASH_ACC_LANES_COUNT / 4; ++i) {
+                __m256i* pAccVec = reinterpret_cast<__m256i*>(pAcc) + i;
+
+                __m256i acc = _mm256_loadu_si256(pAccVec);
+                acc = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 47));
+                acc = _mm256_xor_si256(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pKey) + i));
+
+                const __m256i productLow = _mm256_mul_epu32(acc, prime);
+                const __m256i productHigh = _mm256_mul_epu32(_mm256_shuffle_epi32(acc, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+
+                _mm256_storeu_si256(pAccVec, _mm256_add_epi64(productLow, _mm256_slli_epi64(productHigh, 32)));
+            }
+        }
+    };
+
+    using HashDefaultBackend = HashAVX2Backend;
+#elif defined(AM_HASH_SIMD_SSE2)
+    struct HashSSE2Backend
+    {
+        static void Accumulate(uint64_t* pAcc, const uint8_t* pData, const uint64_t* pKey) noexcept
+        {
+            for (size_t i = 0; i < HASH_ACC_LANES_COUNT / 2; ++i) {
+                __m128i* pAccVec = reinterpret_cast<__m128i*>(pAcc) + i;
+
+                const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData) + i);
+                const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pKey) + i);
+                const __m128i dataKey = _mm_xor_si128(data, key);
+
+                const __m128i dataKeyHigh = _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1));
+                const __m128i product = _mm_mul_epu32(dataKey, dataKeyHigh);
+                const __m128i dataSwapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+
+                const __m128i acc = _mm_loadu_si128(pAccVec);
+                _mm_storeu_si128(pAccVec, _mm_add_epi64(acc, _mm_add_epi64(product, dataSwapped)));
+            }
+        }
+
+        static void Scramble(uint64_t* pAcc, const uint64_t* pKey) noexcept
+        {
+            const __m128i prime = _mm_set1_epi32(static_cast<int32_t>(HASH_PRIME32_1));
+
+            for (size_t i = 0; i < HASH_ACC_LANES_COUNT / 2; ++i) {
+                __m128i* pAccVec = reinterpret_cast<__m128i*>(pAcc) + i;
+
+                __m128i acc = _mm_loadu_si128(pAccVec);
+                acc = _mm_xor_si128(acc, _mm_srli_epi64(acc, 47));
+                acc = _mm_xor_si128(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pKey) + i));
+
+                const __m128i productLow = _mm_mul_epu32(acc, prime);
+                const __m128i productHigh = _mm_mul_epu32(_mm_shuffle_epi32(acc, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+
+                _mm_storeu_si128(pAccVec, _mm_add_epi64(productLow, _mm_slli_epi64(productHigh, 32)));
+            }
+        }
+    };
+
+    using HashDefaultBackend = HashSSE2Backend;
+#elif defined(AM_HASH_SIMD_NEON)
+    struct HashNEONBackend
+    {
+        static void Accumulate(uint64_t* pAcc, const uint8_t* pData, const uint64_t* pKey) noexcept
+        {
+            for (size_t i = 0; i < HASH_ACC_LANES_COUNT / 2; ++i) {
+                const uint64x2_t data = vreinterpretq_u64_u8(vld1q_u8(pData + i * 16));
+                const uint64x2_t key = vld1q_u64(pKey + i * 2);
+                const uint64x2_t dataKey = veorq_u64(data, key);
+
+                const uint64x2_t product = vmull_u32(vmovn_u64(dataKey), vshrn_n_u64(dataKey, 32));
+                const uint64x2_t dataSwapped = vextq_u64(data, data, 1);
+
+                const uint64x2_t acc = vld1q_u64(pAcc + i * 2);
+                vst1q_u64(pAcc + i * 2, vaddq_u64(acc, vaddq_u64(product, dataSwapped)));
+            }
+        }
+
+        static void Scramble(uint64_t* pAcc, const uint64_t* pKey) noexcept
+        {
+            const uint32x2_t prime = vdup_n_u32(static_cast<uint32_t>(HASH_PRIME32_1));
+
+            for (size_t i = 0; i < HASH_ACC_LANES_COUNT / 2; ++i) {
+                uint64x2_t acc = vld1q_u64(pAcc + i * 2);
+                acc = veorq_u64(acc, vshrq_n_u64(acc, 47));
+                acc = veorq_u64(acc, vld1q_u64(pKey + i * 2));
+
+                const uint64x2_t productLow = vmull_u32(vmovn_u64(acc), prime);
+                const uint64x2_t productHigh = vmull_u32(vshrn_n_u64(acc, 32), prime);
+
+                vst1q_u64(pAcc + i * 2, vaddq_u64(productLow, vshlq_n_u64(productHigh, 32)));
+            }
+        }
+    };
+
+    using HashDefaultBackend = HashNEONBackend;
+#else
+    using HashDefaultBackend = HashScalarBackend;
+#endif
+
+
+    inline uint64_t HashMemShort(const uint8_t* pData, size_t size, const uint64_t* pSecret) noexcept
+    {
+        if (size <= 3) {
+            const uint64_t combined = (static_cast<uint64_t>(pData[0]) << 16) | (static_cast<uint64_t>(pData[size >> 1]) << 24) |
+                static_cast<uint64_t>(pData[size - 1]) | (static_cast<uint64_t>(size) << 8);
+            return HashAvalanche(HashMul128Fold64(combined ^ pSecret[0], HASH_PRIME64_1));
+        }
+
+        if (size <= 8) {
+            const uint64_t combined = (static_cast<uint64_t>(HashRead32(pData)) << 32) | HashRead32(pData + size - 4);
+            return HashAvalanche(HashMul128Fold64(combined ^ pSecret[1], size ^ pSecret[2]));
+        }
+
+        if (size <= 16) {
+            const uint64_t low = HashRead64(pData) ^ pSecret[3];
+            const uint64_t high = HashRead64(pData + size - 8) ^ pSecret[4];
+            return HashAvalanche(size + low + high + HashMul128Fold64(low, high));
+        }
+
+        uint64_t hash = size * HASH_PRIME64_1;
+
+        if (size > 32) {
+            if (size > 64) {
+                if (size > 96) {
+                    hash += HashMix16(pData + 48, pSecret + 12);
+                    hash += HashMix16(pData + size - 64, pSecret + 14);
+                }
+
+                hash += HashMix16(pData + 32, pSecret + 8);
+                hash += HashMix16(pData + size - 48, pSecret + 10);
+            }
+
+            hash += HashMix16(pData + 16, pSecret + 4);
+            hash += HashMix16(pData + size - 32, pSecret + 6);
+        }
+
+        hash += HashMix16(pData, pSecret + 0);
+        hash += HashMix16(pData + size - 16, pSecret + 2);
+
+        return HashAvalanche(hash);
+    }
+
+
+    inline void HashInitAccumulators(uint64_t* pAcc) noexcept
+    {
+        pAcc[0] = HASH_PRIME32_3;
+        pAcc[1] = HASH_PRIME64_1;
+        pAcc[2] = HASH_PRIME64_2;
+        pAcc[3] = HASH_PRIME64_3;
+        pAcc[4] = HASH_PRIME64_4;
+        pAcc[5] = HASH_PRIME32_2;
+        pAcc[6] = HASH_PRIME64_5;
+        pAcc[7] = HASH_PRIME32_1;
+    }
+
+
+    template <typename Backend>
+    inline void HashAccumulateStripes(uint64_t* pAcc, const uint8_t* pStripes, size_t firstStripeIdx, size_t stripesCount) noexcept
+    {
+        for (size_t i = 0; i < stripesCount; ++i) {
+            Backend::Accumulate(pAcc, pStripes + i * HASH_STRIPE_SIZE, HASH_SECRET.data() + firstStripeIdx + i);
+        }
+    }
+
+
+    template <typename Backend>
+    inline void HashAccumulateBlock(uint64_t* pAcc, const uint8_t* pBlock) noexcept
+    {
+        HashAccumulateStripes<Backend>(pAcc, pBlock, 0, HASH_STRIPES_PER_BLOCK_COUNT);
+        Backend::Scramble(pAcc, HASH_SECRET.data() + HASH_SECRET_SCRAMBLE_OFFSET);
+    }
+
+
+    inline uint64_t HashMergeAccumulators(const uint64_t* pAcc, const uint64_t* pMergeKey, uint64_t initValue) noexcept
+    {
+        uint64_t hash = initValue;
+        for (size_t i = 0; i < HASH_ACC_LANES_COUNT; i += 2) {
+            hash += HashMul128Fold64(pAcc[i] ^ pMergeKey[i], pAcc[i + 1] ^ pMergeKey[i + 1]);
+        }
+
+        return HashAvalanche(hash);
+    }
+
+
+    // pLastStripe points to the last HASH_STRIPE_SIZE bytes of the input, which may overlap already accumulated stripes
+    template <typename Backend>
+    inline void HashAccumulateLastStripe(uint64_t* pAcc, const uint8_t* pLastStripe) noexcept
+    {
+        Backend::Accumulate(pAcc, pLastStripe, HASH_SECRET.data() + HASH_SECRET_LAST_STRIPE_OFFSET);
+    }
+
+
+    inline uint64_t HashFinalizeLong(const uint64_t* pAcc, uint64_t size) noexcept
+    {
+        return HashMergeAccumulators(pAcc, HASH_SECRET.data() + HASH_SECRET_MERGE_OFFSET, size * HASH_PRIME64_1);
+    }
+
+
+    inline Hash128 HashFinalizeLong128(const uint64_t* pAcc, uint64_t size) noexcept
+    {
+        Hash128 hash;
+        hash.lo = HashFinalizeLong(pAcc, size);
+        hash.hi = HashMergeAccumulators(pAcc, HASH_SECRET.data() + HASH_SECRET_MERGE128_OFFSET, ~(size * HASH_PRIME64_2));
+        return hash;
+    }
+
+
+    inline uint64_t HashFinalizeShort(const uint8_t* pData, size_t size) noexcept
+    {
+        return HashMemShort(pData, size, HASH_SECRET.data());
+    }
+
+
+    inline Hash128 HashFinalizeShort128(const uint8_t* pData, size_t size) noexcept
+    {
+        Hash128 hash;
+        hash.lo = HashMemShort(pData, size, HASH_SECRET.data());
+        hash.hi = HashMemShort(pData, size, HASH_SECRET.data() + HASH_SECRET_SHORT128_OFFSET);
+        return hash;
+    }
+
+
+    template <typename Backend>
+    inline void HashAccumulateLong(uint64_t* pAcc, const uint8_t* pData, size_t size) noexcept
+    {
+        HashInitAccumulators(pAcc);
+
+        // The last byte always goes to the last stripe, so the final partial block is never empty
+        const size_t blocksCount = (size - 1) / HASH_BLOCK_SIZE;
+
+        for (size_t i = 0; i < blocksCount; ++i) {
+            HashAccumulateBlock<Backend>(pAcc, pData + i * HASH_BLOCK_SIZE);
+        }
+
+        const size_t tailOffset = blocksCount * HASH_BLOCK_SIZE;
+        const size_t tailStripesCount = (size - 1 - tailOffset) / HASH_STRIPE_SIZE;
+
+        HashAccumulateStripes<Backend>(pAcc, pData + tailOffset, 0, tailStripesCount);
+        HashAccumulateLastStripe<Backend>(pAcc, pData + size - HASH_STRIPE_SIZE);
+    }
+
+
+    template <typename Backend>
+    inline uint64_t HashMem(const void* data, size_t size) noexcept
+    {
+        const uint8_t* pData = static_cast<const uint8_t*>(data);
+
+        if (size <= HASH_SHORT_INPUT_MAX_SIZE) {
+            return HashFinalizeShort(pData, size);
+        }
+
+        alignas(64) uint64_t acc[HASH_ACC_LANES_COUNT];
+        HashAccumulateLong<Backend>(acc, pData, size);
+        
+        return HashFinalizeLong(acc, size);
+    }
+
+
+    template <typename Backend>
+    inline Hash128 HashMem128(const void* data, size_t size) noexcept
+    {
+        const uint8_t* pData = static_cast<const uint8_t*>(data);
+
+        if (size <= HASH_SHORT_INPUT_MAX_SIZE) {
+            return HashFinalizeShort128(pData, size);
+        }
+
+        alignas(64) uint64_t acc[HASH_ACC_LANES_COUNT];
+        HashAccumulateLong<Backend>(acc, pData, size);
+        
+        return HashFinalizeLong128(acc, size);
+    }
+}
+
+
+inline uint64_t amHashMem(const void* data, size_t size) noexcept
+{
+    if (!data || size == 0) {
+        return 0;
+    }
+
+    return ds::detail::HashMem<ds::detail::HashDefaultBackend>(data, size);
+}
+
+
+inline ds::Hash128 amHashMem128(const void* data, size_t size) noexcept
+{
+    if (!data || size == 0) {
+        return {};
+    }
+
+    return ds::detail::HashMem128<ds::detail::HashDefaultBackend>(data, size);
+}
+
+
+namespace ds
+{
+    inline void HashBuilder::Combine(uint64_t hash) noexcept
+    {
+        // Multiplication by odd constant and avalanche are bijective, so no combined state is lost
+        m_value = detail::HashAvalanche(m_value * detail::HASH_PRIME64_1 + hash + detail::HASH_PRIME64_2);
+    }
+
+
+    inline void StreamHasher::Reset() noexcept
+    {
+        static_assert(ACC_LANES_COUNT == detail::HASH_ACC_LANES_COUNT);
+        static_assert(STRIPE_SIZE == detail::HASH_STRIPE_SIZE);
+        static_assert(BUFFER_SIZE % STRIPE_SIZE == 0 && BUFFER_SIZE > detail::HASH_SHORT_INPUT_MAX_SIZE);
+
+        detail::HashInitAccumulators(m_acc);
+
+        m_totalSize = 0;
+        m_bufferedSize = 0;
+        m_stripeIdx = 0;
+    }
+
+
+    inline void StreamHasher::Update(const void* data, size_t size) noexcept
+    {
+        if (!data || size == 0) {
+            return;
+        }
+
+        const uint8_t* pData = static_cast<const uint8_t*>(data);
+        m_totalSize += size;
+
+        // Stripes are consumed only when more input follows them, since the stripe with the last byte is merged in Finalize
+        if (m_bufferedSize + size <= BUFFER_SIZE) {
+            memcpy(m_buffer + m_bufferedSize, pData, size);
+            m_bufferedSize += size;
+            return;
+        }
+
+        if (m_bufferedSize > 0) {
+            const size_t fillSize = BUFFER_SIZE - m_bufferedSize;
+            memcpy(m_buffer + m_bufferedSize, pData, fillSize);
+
+            ConsumeStripes(m_acc, m_stripeIdx, m_buffer, BUFFER_SIZE / STRIPE_SIZE);
+            
+            pData += fillSize;
+            size -= fillSize;
+            m_bufferedSize = 0;
+        }
+
+        if (size > BUFFER_SIZE) {
+            const size_t stripesCount = (size - 1) / STRIPE_SIZE;
+            ConsumeStripes(m_acc, m_stripeIdx, pData, stripesCount);
+
+            const size_t consumedSize = stripesCount * STRIPE_SIZE;
+
+            // Keep the last consumed stripe at the buffer end, since the final stripe may overlap it
+            memcpy(m_buffer + BUFFER_SIZE - STRIPE_SIZE, pData + consumedSize - STRIPE_SIZE, STRIPE_SIZE);
+
+            pData += consumedSize;
+            size -= consumedSize;
+        }
+
+        memcpy(m_buffer, pData, size);
+        m_bufferedSize = size;
+    }
+
+
+    inline uint64_t StreamHasher::Finalize() const noexcept
+    {
+        if (m_totalSize == 0) {
+            return 0;
+        }
+
+        if (m_totalSize <= detail::HASH_SHORT_INPUT_MAX_SIZE) {
+            return detail::HashFinalizeShort(m_buffer, m_bufferedSize);
+        }
+
+        alignas(64) uint64_t acc[ACC_LANES_COUNT];
+        alignas(64) uint8_t lastStripeStorage[STRIPE_SIZE];
+        const uint8_t* pLastStripe = nullptr;
+
+        PrepareFinalAccumulators(acc, pLastStripe, lastStripeStorage);
+        detail::HashAccumulateLastStripe<detail::HashDefaultBackend>(acc, pLastStripe);
+
+        return detail::HashFinalizeLong(acc, m_totalSize);
+    }
+
+
+    inline Hash128 StreamHasher::Finalize128() const noexcept
+    {
+        if (m_totalSize == 0) {
+            return {};
+        }
+
+        if (m_totalSize <= detail::HASH_SHORT_INPUT_MAX_SIZE) {
+            return detail::HashFinalizeShort128(m_buffer, m_bufferedSize);
+        }
+
+        alignas(64) uint64_t acc[ACC_LANES_COUNT];
+        alignas(64) uint8_t lastStripeStorage[STRIPE_SIZE];
+        const uint8_t* pLastStripe = nullptr;
+
+        PrepareFinalAccumulators(acc, pLastStripe, lastStripeStorage);
+        detail::HashAccumulateLastStripe<detail::HashDefaultBackend>(acc, pLastStripe);
+
+        return detail::HashFinalizeLong128(acc, m_totalSize);
+    }
+
+
+    inline void StreamHasher::PrepareFinalAccumulators(uint64_t* pAcc, const uint8_t*& pOutLastStripe, uint8_t* pLastStripeStorage) const noexcept
+    {
+        memcpy(pAcc, m_acc, sizeof(m_acc));
+
+        if (m_bufferedSize >= STRIPE_SIZE) {
+            size_t stripeIdx = m_stripeIdx;
+            ConsumeStripes(pAcc, stripeIdx, m_buffer, (m_bufferedSize - 1) / STRIPE_SIZE);
+
+            pOutLastStripe = m_buffer + m_bufferedSize - STRIPE_SIZE;
+            return;
+        }
+
+        // The last stripe starts in the previously consumed data, which is still stored at the buffer end
+        const size_t previousDataSize = STRIPE_SIZE - m_bufferedSize;
+        memcpy(pLastStripeStorage, m_buffer + BUFFER_SIZE - previousDataSize, previousDataSize);
+        memcpy(pLastStripeStorage + previousDataSize, m_buffer, m_bufferedSize);
+
+        pOutLastStripe = pLastStripeStorage;
+    }
+
+
+    inline void StreamHasher::ConsumeStripes(uint64_t* pAcc, size_t& stripeIdx, const uint8_t* pStripes, size_t stripesCount) const noexcept
+    {
+        using Backend = detail::HashDefaultBackend;
+
+        for (size_t i = 0; i < stripesCount; ++i) {
+            Backend::Accumulate(pAcc, pStripes + i * STRIPE_SIZE, detail::HASH_SECRET.data() + stripeIdx);
+
+            if (++stripeIdx == detail::HASH_STRIPES_PER_BLOCK_COUNT) {
+                Backend::Scramble(pAcc, detail::HASH_SECRET.data() + detail::HASH_SECRET_SCRAMBLE_OFFSET);
+                stripeIdx = 0;
+            }
+        }
+    }
+}
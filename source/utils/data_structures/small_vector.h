@@ -0,0 +1,112 @@
+#pragma once
+
+#include <utility>
+#include <memory>
+#include <new>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "arena.h"
+
+
+namespace ds
+{
+    // Vector with inline storage for the first N elements. When it grows beyond inline capacity it spills
+    // either to the arena passed on construction, or to the global heap if there is no arena.
+    // Arena must outlive the vector, spilled memory is returned to the arena only by its Reset
+    template <typename T, size_t N>
+    class SmallVector
+    {
+        static_assert(N > 0, "SmallVector inline capacity must be greater than zero");
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+    public:
+        SmallVector() = default;
+        explicit SmallVector(ChunkedArena* pArena) noexcept : m_pArena(pArena) {}
+        explicit SmallVector(size_t count, ChunkedArena* pArena = nullptr) noexcept;
+
+        SmallVector(const SmallVector& other) noexcept;
+        SmallVector& operator=(const SmallVector& other) noexcept;
+
+        SmallVector(SmallVector&& other) noexcept;
+        SmallVector& operator=(SmallVector&& other) noexcept;
+
+        ~SmallVector();
+
+        iterator begin() noexcept { return m_pData; }
+        iterator end() noexcept { return m_pData + m_size; }
+
+        const_iterator begin() const noexcept { return m_pData; }
+        const_iterator end() const noexcept { return m_pData + m_size; }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+
+        T& operator[](size_t idx) noexcept { return m_pData[idx]; }
+        const T& operator[](size_t idx) const noexcept { return m_pData[idx]; }
+
+        T& front() noexcept { return m_pData[0]; }
+        const T& front() const noexcept { return m_pData[0]; }
+
+        T& back() noexcept { return m_pData[m_size - 1]; }
+        const T& back() const noexcept { return m_pData[m_size - 1]; }
+
+        T* data() noexcept { return m_pData; }
+        const T* data() const noexcept { return m_pData; }
+
+        void push_back(const T& value) noexcept { emplace_back(value); }
+        void push_back(T&& value) noexcept { emplace_back(std::move(value)); }
+
+        template <typename... Args>
+        T& emplace_back(Args&&... args) noexcept;
+
+        void pop_back() noexcept;
+
+        void resize(size_t count) noexcept;
+        void resize(size_t count, const T& value) noexcept;
+
+        void reserve(size_t count) noexcept;
+        void clear() noexcept;
+
+        size_t size() const noexcept { return m_size; }
+        size_t capacity() const noexcept { return m_capacity; }
+        bool empty() const noexcept { return m_size == 0; }
+
+        // True while elements are stored in the inline buffer
+        bool IsInline() const noexcept { return m_pData == GetInlineData(); }
+
+    private:
+        T* GetInlineData() noexcept { return reinterpret_cast<T*>(m_inlineStorage); }
+        const T* GetInlineData() const noexcept { return reinterpret_cast<const T*>(m_inlineStorage); }
+
+        bool IsHeapAllocated() const noexcept { return !IsInline() && m_pArena == nullptr; }
+
+        size_t GetGrownCapacity(size_t minCapacity) const noexcept;
+        T* AllocateData(size_t capacity) noexcept;
+
+        // Moves elements to the new buffer and releases the old one. New buffer is allocated separately, so elements
+        // which are built from references to the current ones can be constructed in it before the relocation
+        void RelocateData(T* pNewData, size_t newCapacity) noexcept;
+
+        void Grow(size_t minCapacity) noexcept;
+        void Deallocate() noexcept;
+
+    private:
+        alignas(T) uint8_t m_inlineStorage[N * sizeof(T)];
+
+        T* m_pData = GetInlineData();
+        size_t m_size = 0;
+        size_t m_capacity = N;
+
+        ChunkedArena* m_pArena = nullptr;
+    };
+}
+
+
+#include "small_vector.hpp"
@@ -0,0 +1,220 @@
+namespace ds
+{
+    template <typename T, size_t N>
+    inline SmallVector<T, N>::SmallVector(size_t count, ChunkedArena* pArena) noexcept
+        : m_pArena(pArena)
+    {
+        resize(count);
+    }
+
+
+    template <typename T, size_t N>
+    inline SmallVector<T, N>::SmallVector(const SmallVector& other) noexcept
+        : m_pArena(other.m_pArena)
+    {
+        reserve(other.m_size);
+
+        std::uninitialized_copy(other.begin(), other.end(), m_pData);
+        m_size = other.m_size;
+    }
+
+
+    template <typename T, size_t N>
+    inline SmallVector<T, N>& SmallVector<T, N>::operator=(const SmallVector& other) noexcept
+    {
+        if (this == &other) {
+            return *this;
+        }
+
+        // Arena isn't propagated, the vector keeps allocating from the one it was constructed with
+        clear();
+        reserve(other.m_size);
+
+        std::uninitialized_copy(other.begin(), other.end(), m_pData);
+        m_size = other.m_size;
+
+        return *this;
+    }
+
+
+    template <typename T, size_t N>
+    inline SmallVector<T, N>::SmallVector(SmallVector&& other) noexcept
+        : m_pArena(other.m_pArena)
+    {
+        *this = std::move(other);
+    }
+
+
+    template <typename T, size_t N>
+    inline SmallVector<T, N>& SmallVector<T, N>::operator=(SmallVector&& other) noexcept
+    {
+        if (this == &other) {
+            return *this;
+        }
+
+        clear();
+
+        if (!other.IsInline() && other.m_pArena == m_pArena) {
+            Deallocate();
+
+            m_pData = other.m_pData;
+            m_size = other.m_size;
+            m_capacity = other.m_capacity;
+
+            other.m_pData = other.GetInlineData();
+            other.m_size = 0;
+            other.m_capacity = N;
+
+            return *this;
+        }
+
+        reserve(other.m_size);
+
+        std::uninitialized_move(other.begin(), other.end(), m_pData);
+        m_size = other.m_size;
+
+        other.clear();
+
+        return *this;
+    }
+
+
+    template <typename T, size_t N>
+    inline SmallVector<T, N>::~SmallVector()
+    {
+        clear();
+        Deallocate();
+    }
+
+
+    template <typename T, size_t N>
+    template <typename... Args>
+    inline T& SmallVector<T, N>::emplace_back(Args&&... args) noexcept
+    {
+        if (m_size < m_capacity) {
+            T* pElement = new (m_pData + m_size) T(std::forward<Args>(args)...);
+            ++m_size;
+
+            return *pElement;
+        }
+
+        const size_t newCapacity = GetGrownCapacity(m_size + 1);
+        T* pNewData = AllocateData(newCapacity);
+
+        // Args may reference elements of this vector, e.g. push_back(back()), so they must stay alive until the new element is built
+        T* pElement = new (pNewData + m_size) T(std::forward<Args>(args)...);
+
+        RelocateData(pNewData, newCapacity);
+        ++m_size;
+
+        return *pElement;
+    }
+
+
+    template <typename T, size_t N>
+    inline void SmallVector<T, N>::pop_back() noexcept
+    {
+        --m_size;
+        std::destroy_at(m_pData + m_size);
+    }
+
+
+    template <typename T, size_t N>
+    inline void SmallVector<T, N>::resize(size_t count) noexcept
+    {
+        if (count < m_size) {
+            std::destroy(m_pData + count, m_pData + m_size);
+        } else if (count > m_size) {
+            reserve(count);
+            std::uninitialized_value_construct(m_pData + m_size, m_pData + count);
+        }
+
+        m_size = count;
+    }
+
+
+    template <typename T, size_t N>
+    inline void SmallVector<T, N>::resize(size_t count, const T& value) noexcept
+    {
+        if (count < m_size) {
+            std::destroy(m_pData + count, m_pData + m_size);
+        } else if (count > m_capacity) {
+            const size_t newCapacity = GetGrownCapacity(count);
+            T* pNewData = AllocateData(newCapacity);
+
+            // Value may be an element of this vector, so it's copied before the relocation
+            std::uninitialized_fill(pNewData + m_size, pNewData + count, value);
+
+            RelocateData(pNewData, newCapacity);
+        } else if (count > m_size) {
+            std::uninitialized_fill(m_pData + m_size, m_pData + count, value);
+        }
+
+        m_size = count;
+    }
+
+
+    template <typename T, size_t N>
+    inline void SmallVector<T, N>::reserve(size_t count) noexcept
+    {
+        if (count > m_capacity) {
+            Grow(count);
+        }
+    }
+
+
+    template <typename T, size_t N>
+    inline void SmallVector<T, N>::clear() noexcept
+    {
+        std::destroy(m_pData, m_pData + m_size);
+        m_size = 0;
+    }
+
+
+    template <typename T, size_t N>
+    inline size_t SmallVector<T, N>::GetGrownCapacity(size_t minCapacity) const noexcept
+    {
+        return m_capacity * 2 > minCapacity ? m_capacity * 2 : minCapacity;
+    }
+
+
+    template <typename T, size_t N>
+    inline T* SmallVector<T, N>::AllocateData(size_t capacity) noexcept
+    {
+        return m_pArena ? m_pArena->AllocateArray<T>(capacity)
+            : static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t(alignof(T))));
+    }
+
+
+    template <typename T, size_t N>
+    inline void SmallVector<T, N>::RelocateData(T* pNewData, size_t newCapacity) noexcept
+    {
+        std::uninitialized_move(m_pData, m_pData + m_size, pNewData);
+        std::destroy(m_pData, m_pData + m_size);
+
+        Deallocate();
+
+        m_pData = pNewData;
+        m_capacity = newCapacity;
+    }
+
+
+    template <typename T, size_t N>
+    inline void SmallVector<T, N>::Grow(size_t minCapacity) noexcept
+    {
+        const size_t newCapacity = GetGrownCapacity(minCapacity);
+        RelocateData(AllocateData(newCapacity), newCapacity);
+    }
+
+
+    template <typename T, size_t N>
+    inline void SmallVector<T, N>::Deallocate() noexcept
+    {
+        if (IsHeapAllocated()) {
+            ::operator delete(m_pData, std::align_val_t(alignof(T)));
+        }
+
+        m_pData = GetInlineData();
+        m_capacity = N;
+    }
+}
@@ -1,123 +1,335 @@
 #pragma once
 
-#include <unordered_map>
 #include <string_view>
 #include <string>
+#include <vector>
+#include <deque>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <iterator>
 
 #include <cstdint>
+#include <cstring>
 
 #include "hash.h"
+#include "arena.h"
+
+#if defined(AM_STRID_COLLISION_CHECK_ENABLED)
+    #include "utils/debug/assertion.h"
+#endif
 
 
 namespace ds
 {
-    template <typename ElemT>
+    // Id type dependent parts of StrID. 64-bit ids are default, 128-bit ids make collisions practically impossible
+    // for huge string sets at the cost of twice bigger StrID
+    template <typename IdT>
+    struct StrIDTraits;
+
+
+    template <>
+    struct StrIDTraits<uint64_t>
+    {
+        static inline constexpr uint64_t INVALID_ID = std::numeric_limits<uint64_t>::max();
+
+        template <typename CharT>
+        static constexpr uint64_t Compute(const CharT* str, size_t length) noexcept { return amHashConstexpr(str, length); }
+
+        static constexpr uint64_t Fold(uint64_t id) noexcept { return id; }
+    };
+
+
+    template <>
+    struct StrIDTraits<Hash128>
+    {
+        static inline constexpr Hash128 INVALID_ID = { std::numeric_limits<uint64_t>::max(), std::numeric_limits<uint64_t>::max() };
+
+        template <typename CharT>
+        static constexpr Hash128 Compute(const CharT* str, size_t length) noexcept { return amHash128Constexpr(str, length); }
+
+        static constexpr uint64_t Fold(Hash128 id) noexcept { return id.lo ^ id.hi; }
+    };
+
+
+    // Thread-safe string interning storage. 
+    // Lookups are lock-free. Inserts lock only one of the shards, selected by the string hash.
+    // Interned strings are bump-allocated in chunked arenas and never moved, so pointers returned by Load stay valid for the storage lifetime.
+    // With AM_STRID_COLLISION_CHECK_ENABLED every lookup of an existing id also compares the stored string, and asserts on hash collision
+    template <typename ElemT, typename IdT = uint64_t>
     class StrIDDataStorage
     {
-        template <typename T>
+        template <typename T, typename U>
         friend class StrIDImpl;
 
     private:
         using ElementType = ElemT;
+        using IdType = IdT;
+        using Traits = StrIDTraits<IdType>;
         using StringViewType = std::basic_string_view<ElementType>;
         using StringType = std::basic_string<ElementType, std::char_traits<ElementType>, std::allocator<ElementType>>;
 
     public:
         StrIDDataStorage();
 
-        uint64_t Store(const StringViewType& str) noexcept;
-        uint64_t Store(const ElementType* str)    noexcept { return Store(StringViewType(str)); }
-        uint64_t Store(const StringType& str)     noexcept { return Store(StringViewType(str)); }
+        StrIDDataStorage(const StrIDDataStorage& storage) = delete;
+        StrIDDataStorage& operator=(const StrIDDataStorage& storage) = delete;
+
+        IdType Store(const StringViewType& str) noexcept;
+        IdType Store(const ElementType* str)    noexcept { return str ? Store(StringViewType(str)) : INVALID_ID_HASH; }
+        IdType Store(const StringType& str)     noexcept { return Store(StringViewType(str)); }
+
+        const ElementType* Load(IdType id) const noexcept;
+
+        bool IsExist(IdType id) const noexcept { return FindEntry(id) != nullptr; }
+
+        // Packs strings stored during this run into a table of ids and a strings blob, which can be passed to PreloadTable later.
+        // Preloaded strings which were never stored again are skipped, so the table doesn't keep strings of removed assets forever
+        std::vector<uint8_t> SerializeTable() const noexcept;
 
-        const ElementType* Load(uint64_t id) const noexcept;
+        // Registers strings of a serialized table without hashing or copying them, so pData memory must outlive the storage.
+        // Returns false without changing the storage if the table is corrupted or was serialized with a different hash function
+        bool PreloadTable(const void* pData, size_t size) noexcept;
 
-        bool IsExist(uint64_t id) const noexcept { return m_strBufLocations.find(id) != m_strBufLocations.cend(); }
+        size_t GetEntriesCount() const noexcept;
+        size_t GetPreloadedTableEntriesCount() const noexcept { return m_preloadedTableEntriesCount.load(std::memory_order_relaxed); }
+        size_t GetUsedEntriesCount() const noexcept { return m_usedEntriesCount.load(std::memory_order_relaxed); }
 
     private:
-        static inline constexpr uint64_t INVALID_ID_HASH = std::numeric_limits<uint64_t>::max();
+        // id must be Traits::Compute(str). Used to register strings which hash was computed at compile time
+        IdType Store(const StringViewType& str, IdType id) noexcept;
+
+    private:
+        static inline constexpr IdType INVALID_ID_HASH = Traits::INVALID_ID;
         static inline constexpr size_t PREALLOCATED_IDS_COUNT = 8192ull;
+
+        static inline constexpr size_t SHARDS_COUNT = 64ull;
+        static inline constexpr size_t SHARD_INDEX_SHIFT = 58ull; // 64 - log2(SHARDS_COUNT)
         
+        // Shard tables are kept at most half full to keep linear probing sequences short
+        static inline constexpr size_t PREALLOCATED_SHARD_SLOTS_COUNT = 2ull * PREALLOCATED_IDS_COUNT / SHARDS_COUNT;
+
         static inline constexpr size_t AVERAGE_STR_SIZE = 32ull;
-        static inline constexpr size_t PREALLOCATED_STORAGE_SIZE = PREALLOCATED_IDS_COUNT * AVERAGE_STR_SIZE;
+        static inline constexpr size_t SHARD_ARENA_CHUNK_SIZE = PREALLOCATED_IDS_COUNT * AVERAGE_STR_SIZE / SHARDS_COUNT;
+
+        static inline constexpr uint32_t SERIALIZED_TABLE_MAGIC = 0x4C424154; // "TABL"
+        static inline constexpr uint32_t SERIALIZED_TABLE_VERSION = 1;
+
+        // Hashed when table is serialized and preloaded, so tables written with another hash function are rejected
+        static inline constexpr ElementType SERIALIZED_TABLE_HASH_PROBE[] = { 'a', 'm', '_', 's', 't', 'r', 'i', 'd', 0 };
 
     private:
-        // We generate a unique hash in the Store method, and we don't want to hash the already unique value again, 
-        // so we use a proxy hasher
-        struct StringIdHasher
+        struct StringEntry
+        {
+            IdType id;
+            const ElementType* pStr;
+            size_t length;
+
+            // Set once the string is stored during this run. Only preloaded entries start unused
+            mutable std::atomic<bool> isUsed;
+        };
+
+        // Open addressing table of published entries. Slots only go from nullptr to an entry, and are never cleared
+        struct EntryTable
+        {
+            explicit EntryTable(size_t capacity);
+
+            size_t capacity;
+            std::unique_ptr<std::atomic<const StringEntry*>[]> slots;
+        };
+
+        struct SerializedTableHeader
         {
-            inline constexpr uint64_t operator()(uint64_t id) const noexcept { return id; }
+            uint32_t magic;
+            uint32_t version;
+            uint32_t elementSize;
+            uint32_t idSize;
+            uint64_t hashProbe;
+            uint64_t entriesCount;
+            uint64_t blobLength;
         };
 
-        struct StringBufLocation
+        // Offset and length are in elements. Every string in the blob is null terminated
+        struct SerializedTableEntry
         {
-            uint32_t offset;
-            uint32_t length;
+            IdType id;
+            uint64_t offset;
+            uint64_t length;
+        };
+
+        struct alignas(64) Shard
+        {
+            std::atomic<const EntryTable*> pTable = nullptr;
+            std::mutex insertMutex;
+
+            // Previous tables are retired instead of deleted, since lock-free readers may still probe them
+            std::vector<std::unique_ptr<EntryTable>> tables;
+            std::deque<StringEntry> entries;
+            ChunkedArena stringsArena = ChunkedArena(SHARD_ARENA_CHUNK_SIZE * sizeof(ElementType));
         };
 
-        std::unordered_map<uint64_t, StringBufLocation, StringIdHasher> m_strBufLocations;
-        std::vector<ElementType> m_storage;
-        uint64_t m_lastAllocatedID = INVALID_ID_HASH;
+    private:
+        static const StringEntry* FindEntry(const EntryTable& table, IdType id) noexcept;
+        static void PublishEntry(const EntryTable& table, const StringEntry* pEntry) noexcept;
+
+        const StringEntry* FindEntry(IdType id) const noexcept;
+
+        // Must be called with shard insert mutex locked
+        const StringEntry* InsertEntry(Shard& shard, IdType id, const StringViewType& str) noexcept;
+        const StringEntry* InsertEntry(Shard& shard, IdType id, const ElementType* pStr, size_t length, bool isUsed) noexcept;
+
+        void MarkEntryUsed(const StringEntry* pEntry) noexcept;
+
+        static uint64_t GetSerializedTableHashProbe() noexcept;
+
+        const Shard& GetShard(IdType id) const noexcept { return m_shards[Traits::Fold(id) >> SHARD_INDEX_SHIFT]; }
+        Shard& GetShard(IdType id) noexcept { return m_shards[Traits::Fold(id) >> SHARD_INDEX_SHIFT]; }
+
+    #if defined(AM_STRID_COLLISION_CHECK_ENABLED)
+        static void CheckCollision(const StringEntry* pEntry, const StringViewType& str) noexcept;
+    #endif
+
+    private:
+        std::array<Shard, SHARDS_COUNT> m_shards;
+        std::atomic<size_t> m_preloadedTableEntriesCount = 0;
+        std::atomic<size_t> m_usedEntriesCount = 0;
     };
 
 
-    template <typename ElemT>
+    // String literal with its id computed at compile time. It isn't interned until it's converted to StrIDImpl,
+    // so comparisons with StrIDImpl and switch cases on GetId() cost neither hashing nor storage lookups
+    template <typename ElemT, typename IdT = uint64_t>
+    class StrIDLiteralImpl
+    {
+    public:
+        using ElementType = ElemT;
+        using IdType = IdT;
+        using StringViewType = std::basic_string_view<ElementType>;
+
+    public:
+        constexpr StrIDLiteralImpl(const ElementType* str, size_t length) noexcept
+            : m_pStr(str), m_length(length), m_id(StrIDTraits<IdType>::Compute(str, length)) {}
+
+        constexpr const ElementType* CStr() const noexcept { return m_pStr; }
+        constexpr StringViewType View() const noexcept { return StringViewType(m_pStr, m_length); }
+
+        constexpr bool operator==(StrIDLiteralImpl literal) const noexcept { return m_id == literal.m_id; }
+        constexpr bool operator!=(StrIDLiteralImpl literal) const noexcept { return m_id != literal.m_id; }
+
+        constexpr IdType GetId() const noexcept { return m_id; }
+        constexpr uint64_t Hash() const noexcept { return StrIDTraits<IdType>::Fold(m_id); }
+
+    private:
+        const ElementType* m_pStr = nullptr;
+        size_t m_length = 0;
+        IdType m_id = {};
+    };
+
+
+    template <typename ElemT, typename IdT = uint64_t>
     class StrIDImpl
     {
     public:
         using ElementType = ElemT;
+        using IdType = IdT;
         using StringViewType = std::basic_string_view<ElementType>;
         using StringType = std::basic_string<ElementType, std::char_traits<ElementType>, std::allocator<ElementType>>;
 
+        using StrIDLiteralType = StrIDLiteralImpl<ElementType, IdType>;
+
     private:
-        using StrIDDataStorageType = StrIDDataStorage<ElementType>;
+        using StrIDDataStorageType = StrIDDataStorage<ElementType, IdType>;
 
     public:
         StrIDImpl() = default;
         StrIDImpl(const ElementType* str);
         StrIDImpl(const StringType& str);
         StrIDImpl(const StringViewType& str);
+        StrIDImpl(StrIDLiteralType literal);
 
         StrIDImpl& operator=(const ElementType* str)    noexcept;
-        StrIDImpl& operator=(const StringType& str)     noexcept { return operator=(str.c_str()); }
-        StrIDImpl& operator=(const StringViewType& str) noexcept { return operator=(str.data()); }
+        StrIDImpl& operator=(const StringType& str)     noexcept { return operator=(StringViewType(str)); }
+        StrIDImpl& operator=(const StringViewType& str) noexcept;
 
         const ElementType* CStr() const noexcept;
 
         bool operator==(StrIDImpl strId) const noexcept { return m_id == strId.m_id; }
         bool operator!=(StrIDImpl strId) const noexcept { return m_id != strId.m_id; }
         bool operator<(StrIDImpl strId) const noexcept { return m_id < strId.m_id; }
-        bool operator>(StrIDImpl strId) const noexcept { return m_id > strId.m_id; }
-        bool operator<=(StrIDImpl strId) const noexcept { return m_id <= strId.m_id; }
-        bool operator>=(StrIDImpl strId) const noexcept { return m_id >= strId.m_id; }
+        bool operator>(StrIDImpl strId) const noexcept { return strId.m_id < m_id; }
+        bool operator<=(StrIDImpl strId) const noexcept { return !(strId.m_id < m_id); }
+        bool operator>=(StrIDImpl strId) const noexcept { return !(m_id < strId.m_id); }
 
-        uint64_t GetId() const noexcept { return m_id; }
-        uint64_t Hash() const noexcept { return m_id; }
+        constexpr bool operator==(StrIDLiteralType literal) const noexcept { return m_id == literal.GetId(); }
+        constexpr bool operator!=(StrIDLiteralType literal) const noexcept { return m_id != literal.GetId(); }
+
+        IdType GetId() const noexcept { return m_id; }
+        uint64_t Hash() const noexcept { return StrIDTraits<IdType>::Fold(m_id); }
 
         bool IsValid() const noexcept { return m_id != StrIDDataStorageType::INVALID_ID_HASH; }
 
+        // See StrIDDataStorage for serialized table details
+        static std::vector<uint8_t> SerializeTable() noexcept { return GetStorage().SerializeTable(); }
+        static bool PreloadTable(const void* pData, size_t size) noexcept { return GetStorage().PreloadTable(pData, size); }
+
+        static size_t GetInternedCount() noexcept { return GetStorage().GetEntriesCount(); }
+        static size_t GetPreloadedTableEntriesCount() noexcept { return GetStorage().GetPreloadedTableEntriesCount(); }
+        static size_t GetUsedCount() noexcept { return GetStorage().GetUsedEntriesCount(); }
+
     private:
-        static inline StrIDDataStorageType s_storage;
+        // Function local static to be safe to use from other static objects initialization
+        static StrIDDataStorageType& GetStorage() noexcept;
 
     private:
-        uint64_t m_id = StrIDDataStorageType::INVALID_ID_HASH;
+        IdType m_id = StrIDDataStorageType::INVALID_ID_HASH;
     };
 
 
+    template <typename ElemT, typename IdT>
+    constexpr bool operator==(StrIDLiteralImpl<ElemT, IdT> literal, StrIDImpl<ElemT, IdT> strId) noexcept { return strId == literal; }
+
+    template <typename ElemT, typename IdT>
+    constexpr bool operator!=(StrIDLiteralImpl<ElemT, IdT> literal, StrIDImpl<ElemT, IdT> strId) noexcept { return strId != literal; }
+
+
     using StrID = StrIDImpl<char>;
     using WStrID = StrIDImpl<wchar_t>;
+
+    using StrID128 = StrIDImpl<char, Hash128>;
+    using WStrID128 = StrIDImpl<wchar_t, Hash128>;
+
+    using StrIDLiteral = StrIDLiteralImpl<char>;
+    using WStrIDLiteral = StrIDLiteralImpl<wchar_t>;
+
+    using StrID128Literal = StrIDLiteralImpl<char, Hash128>;
+    using WStrID128Literal = StrIDLiteralImpl<wchar_t, Hash128>;
+
+
+    namespace literals
+    {
+        constexpr StrIDLiteral operator""_sid(const char* str, size_t length) noexcept { return StrIDLiteral(str, length); }
+        constexpr WStrIDLiteral operator""_sid(const wchar_t* str, size_t length) noexcept { return WStrIDLiteral(str, length); }
+
+        constexpr StrID128Literal operator""_sid128(const char* str, size_t length) noexcept { return StrID128Literal(str, length); }
+        constexpr WStrID128Literal operator""_sid128(const wchar_t* str, size_t length) noexcept { return WStrID128Literal(str, length); }
+    }
 }
 
 namespace std {
-    template<>
-    struct hash<ds::StrID> {
-        uint64_t operator()(const ds::StrID& id) const { return id.Hash(); }
+    template<typename ElemT, typename IdT>
+    struct hash<ds::StrIDImpl<ElemT, IdT>> {
+        uint64_t operator()(const ds::StrIDImpl<ElemT, IdT>& id) const { return id.Hash(); }
     };
 
-    template<>
-    struct hash<ds::WStrID> {
-        uint64_t operator()(const ds::WStrID& id) const { return id.Hash(); }
+    template<typename ElemT, typename IdT>
+    struct hash<ds::StrIDLiteralImpl<ElemT, IdT>> {
+        uint64_t operator()(const ds::StrIDLiteralImpl<ElemT, IdT>& id) const { return id.Hash(); }
     };
 }
 
 
-#include "strid.hpp"
\ No newline at end of file
+#include "strid.hpp"
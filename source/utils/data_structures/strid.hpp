@@ -1,87 +1,398 @@
 namespace ds 
 {
-    template <typename ElemT>
-    inline StrIDDataStorage<ElemT>::StrIDDataStorage()
+    template <typename ElemT, typename IdT>
+    inline StrIDDataStorage<ElemT, IdT>::EntryTable::EntryTable(size_t capacity)
+        : capacity(capacity), slots(new std::atomic<const StringEntry*>[capacity]())
     {
-        m_strBufLocations.reserve(PREALLOCATED_IDS_COUNT);
-        m_storage.resize(PREALLOCATED_STORAGE_SIZE);
     }
 
 
-    template <typename ElemT>
-    inline uint64_t StrIDDataStorage<ElemT>::Store(const StrIDDataStorage<ElemT>::StringViewType &str) noexcept
+    template <typename ElemT, typename IdT>
+    inline StrIDDataStorage<ElemT, IdT>::StrIDDataStorage()
+    {
+        for (Shard& shard : m_shards) {
+            shard.tables.emplace_back(std::make_unique<EntryTable>(PREALLOCATED_SHARD_SLOTS_COUNT));
+            shard.pTable.store(shard.tables.back().get(), std::memory_order_release);
+        }
+    }
+
+
+    template <typename ElemT, typename IdT>
+    inline IdT StrIDDataStorage<ElemT, IdT>::Store(const StringViewType &str) noexcept
     {
         if (!str.data()) {
             return INVALID_ID_HASH;
         }
 
-        const uint64_t id = amHash(str);
+        return Store(str, Traits::Compute(str.data(), str.length()));
+    }
+
+
+    template <typename ElemT, typename IdT>
+    inline IdT StrIDDataStorage<ElemT, IdT>::Store(const StringViewType &str, IdType id) noexcept
+    {
+        // Fast path: most of the strings are already interned
+        if (const StringEntry* pEntry = FindEntry(id)) {
+        #if defined(AM_STRID_COLLISION_CHECK_ENABLED)
+            CheckCollision(pEntry, str);
+        #endif
+            MarkEntryUsed(pEntry);
+            return id;
+        }
+
+        Shard& shard = GetShard(id);
 
-        if (!IsExist(id)) {
-            StringBufLocation& newStrBufLocation = m_strBufLocations[id];
-            
-            newStrBufLocation.length = str.length() + 1; // including null terminator
+        std::lock_guard<std::mutex> lock(shard.insertMutex);
 
-            if (m_lastAllocatedID != INVALID_ID_HASH) {
-                const StringBufLocation& lastStrBufLocation = m_strBufLocations[m_lastAllocatedID];
+        // Another thread could insert the same string while we were waiting for the lock
+        if (const StringEntry* pEntry = FindEntry(*shard.pTable.load(std::memory_order_acquire), id)) {
+        #if defined(AM_STRID_COLLISION_CHECK_ENABLED)
+            CheckCollision(pEntry, str);
+        #endif
+            MarkEntryUsed(pEntry);
+            return id;
+        }
 
-                newStrBufLocation.offset = lastStrBufLocation.offset + lastStrBufLocation.length;
+        InsertEntry(shard, id, str);
+
+        return id;
+    }
+
+
+    template <typename ElemT, typename IdT>
+    inline const ElemT* StrIDDataStorage<ElemT, IdT>::Load(IdType id) const noexcept
+    {
+        const StringEntry* pEntry = FindEntry(id);
+        return pEntry ? pEntry->pStr : nullptr;
+    }
+
+
+    template <typename ElemT, typename IdT>
+    inline std::vector<uint8_t> StrIDDataStorage<ElemT, IdT>::SerializeTable() const noexcept
+    {
+        Shard* pShards = const_cast<Shard*>(m_shards.data());
+
+        // Shards are always locked in the same order, and Store never holds more than one lock, so there is no deadlock
+        std::array<std::unique_lock<std::mutex>, SHARDS_COUNT> locks;
+        for (size_t i = 0; i < SHARDS_COUNT; ++i) {
+            locks[i] = std::unique_lock<std::mutex>(pShards[i].insertMutex);
+        }
+
+        size_t entriesCount = 0;
+        size_t blobLength = 0;
+
+        for (const Shard& shard : m_shards) {
+            for (const StringEntry& entry : shard.entries) {
+                if (!entry.isUsed.load(std::memory_order_relaxed)) {
+                    continue;
+                }
+
+                ++entriesCount;
+                blobLength += entry.length + 1;
             }
-            
-            if (newStrBufLocation.offset + newStrBufLocation.length > m_storage.size()) {
-                m_storage.resize(m_storage.size() * 2ull);
+        }
+
+        const size_t entriesOffset = sizeof(SerializedTableHeader);
+        const size_t blobOffset = entriesOffset + entriesCount * sizeof(SerializedTableEntry);
+
+        std::vector<uint8_t> data(blobOffset + blobLength * sizeof(ElementType));
+
+        SerializedTableHeader header = {};
+        header.magic = SERIALIZED_TABLE_MAGIC;
+        header.version = SERIALIZED_TABLE_VERSION;
+        header.elementSize = sizeof(ElementType);
+        header.idSize = sizeof(IdType);
+        header.hashProbe = GetSerializedTableHashProbe();
+        header.entriesCount = entriesCount;
+        header.blobLength = blobLength;
+
+        memcpy(data.data(), &header, sizeof(header));
+
+        uint8_t* pEntries = data.data() + entriesOffset;
+        uint8_t* pBlob = data.data() + blobOffset;
+
+        size_t blobPosition = 0;
+
+        for (const Shard& shard : m_shards) {
+            for (const StringEntry& entry : shard.entries) {
+                if (!entry.isUsed.load(std::memory_order_relaxed)) {
+                    continue;
+                }
+
+                SerializedTableEntry serializedEntry = {};
+                serializedEntry.id = entry.id;
+                serializedEntry.offset = blobPosition;
+                serializedEntry.length = entry.length;
+
+                memcpy(pEntries, &serializedEntry, sizeof(serializedEntry));
+                pEntries += sizeof(serializedEntry);
+
+                memcpy(pBlob + blobPosition * sizeof(ElementType), entry.pStr, (entry.length + 1) * sizeof(ElementType));
+                blobPosition += entry.length + 1;
             }
+        }
 
-            std::copy_n(str.begin(), newStrBufLocation.length - 1, m_storage.begin() + newStrBufLocation.offset);
+        return data;
+    }
 
-            m_lastAllocatedID = id;
+
+    template <typename ElemT, typename IdT>
+    inline bool StrIDDataStorage<ElemT, IdT>::PreloadTable(const void* pData, size_t size) noexcept
+    {
+        if (!pData || size < sizeof(SerializedTableHeader)) {
+            return false;
         }
 
-        return id;
+        const uint8_t* pDataU8 = static_cast<const uint8_t*>(pData);
+
+        SerializedTableHeader header = {};
+        memcpy(&header, pDataU8, sizeof(header));
+
+        const bool isHeaderValid = header.magic == SERIALIZED_TABLE_MAGIC && header.version == SERIALIZED_TABLE_VERSION &&
+            header.elementSize == sizeof(ElementType) && header.idSize == sizeof(IdType) && header.hashProbe == GetSerializedTableHashProbe();
+
+        if (!isHeaderValid) {
+            return false;
+        }
+
+        const size_t entriesOffset = sizeof(SerializedTableHeader);
+        const size_t blobOffset = entriesOffset + header.entriesCount * sizeof(SerializedTableEntry);
+
+        if (blobOffset + header.blobLength * sizeof(ElementType) != size) {
+            return false;
+        }
+
+        // Entries are read in place, memory mapped tables are page aligned, so entries and blob are aligned as well
+        const SerializedTableEntry* pEntries = reinterpret_cast<const SerializedTableEntry*>(pDataU8 + entriesOffset);
+        const ElementType* pBlob = reinterpret_cast<const ElementType*>(pDataU8 + blobOffset);
+
+        for (size_t i = 0; i < header.entriesCount; ++i) {
+            const SerializedTableEntry& entry = pEntries[i];
+
+            if (entry.id == INVALID_ID_HASH || entry.offset + entry.length >= header.blobLength || pBlob[entry.offset + entry.length] != ElementType(0)) {
+                return false;
+            }
+        }
+
+        for (size_t i = 0; i < header.entriesCount; ++i) {
+            const SerializedTableEntry& entry = pEntries[i];
+            const ElementType* pStr = pBlob + entry.offset;
+
+        #if defined(AM_STRID_COLLISION_CHECK_ENABLED)
+            if (Traits::Compute(pStr, entry.length) != entry.id) {
+                AM_ASSERT_FAIL("Serialized StrID table entry {} id doesn't match its string", i);
+                continue;
+            }
+        #endif
+
+            Shard& shard = GetShard(entry.id);
+
+            std::lock_guard<std::mutex> lock(shard.insertMutex);
+
+            if (const StringEntry* pEntry = FindEntry(*shard.pTable.load(std::memory_order_acquire), entry.id)) {
+            #if defined(AM_STRID_COLLISION_CHECK_ENABLED)
+                CheckCollision(pEntry, StringViewType(pStr, entry.length));
+            #endif
+                continue;
+            }
+
+            InsertEntry(shard, entry.id, pStr, entry.length, false);
+        }
+
+        m_preloadedTableEntriesCount.store(header.entriesCount, std::memory_order_relaxed);
+
+        return true;
     }
 
 
-    template <typename ElemT>
-    inline const typename StrIDDataStorage<ElemT>::ElementType* StrIDDataStorage<ElemT>::Load(uint64_t id) const noexcept
+    template <typename ElemT, typename IdT>
+    inline size_t StrIDDataStorage<ElemT, IdT>::GetEntriesCount() const noexcept
     {
-        const auto strBufLocationIt = m_strBufLocations.find(id);
+        size_t entriesCount = 0;
+
+        for (const Shard& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(const_cast<Shard&>(shard).insertMutex);
+            entriesCount += shard.entries.size();
+        }
 
-        return strBufLocationIt == m_strBufLocations.cend() ? nullptr : m_storage.data() + strBufLocationIt->second.offset;
+        return entriesCount;
     }
 
 
-    template <typename ElemT>
-    inline StrIDImpl<ElemT>::StrIDImpl(const ElementType *str)
-        : m_id(s_storage.Store(str))
+    template <typename ElemT, typename IdT>
+    inline const typename StrIDDataStorage<ElemT, IdT>::StringEntry* StrIDDataStorage<ElemT, IdT>::FindEntry(const EntryTable& table, IdType id) noexcept
+    {
+        const size_t mask = table.capacity - 1;
+
+        for (size_t i = static_cast<size_t>(Traits::Fold(id)) & mask; ; i = (i + 1) & mask) {
+            const StringEntry* pEntry = table.slots[i].load(std::memory_order_acquire);
+
+            if (pEntry == nullptr || pEntry->id == id) {
+                return pEntry;
+            }
+        }
+    }
+
+
+    template <typename ElemT, typename IdT>
+    inline void StrIDDataStorage<ElemT, IdT>::PublishEntry(const EntryTable& table, const StringEntry* pEntry) noexcept
+    {
+        const size_t mask = table.capacity - 1;
+
+        size_t i = static_cast<size_t>(Traits::Fold(pEntry->id)) & mask;
+        while (table.slots[i].load(std::memory_order_relaxed) != nullptr) {
+            i = (i + 1) & mask;
+        }
+
+        table.slots[i].store(pEntry, std::memory_order_release);
+    }
+
+
+    template <typename ElemT, typename IdT>
+    inline const typename StrIDDataStorage<ElemT, IdT>::StringEntry* StrIDDataStorage<ElemT, IdT>::FindEntry(IdType id) const noexcept
+    {
+        if (id == INVALID_ID_HASH) {
+            return nullptr;
+        }
+
+        return FindEntry(*GetShard(id).pTable.load(std::memory_order_acquire), id);
+    }
+
+
+    template <typename ElemT, typename IdT>
+    inline const typename StrIDDataStorage<ElemT, IdT>::StringEntry* StrIDDataStorage<ElemT, IdT>::InsertEntry(Shard& shard, IdType id, const StringViewType& str) noexcept
+    {
+        ElementType* pStr = shard.stringsArena.template AllocateArray<ElementType>(str.length() + 1);
+        std::copy_n(str.data(), str.length(), pStr);
+        pStr[str.length()] = ElementType(0);
+
+        return InsertEntry(shard, id, pStr, str.length(), true);
+    }
+
+
+    template <typename ElemT, typename IdT>
+    inline const typename StrIDDataStorage<ElemT, IdT>::StringEntry* StrIDDataStorage<ElemT, IdT>::InsertEntry(Shard& shard, IdType id, const ElementType* pStr, size_t length, bool isUsed) noexcept
+    {
+        const EntryTable* pTable = shard.pTable.load(std::memory_order_relaxed);
+
+        if ((shard.entries.size() + 1) * 2 > pTable->capacity) {
+            std::unique_ptr<EntryTable> pNewTable = std::make_unique<EntryTable>(pTable->capacity * 2);
+
+            for (const StringEntry& entry : shard.entries) {
+                PublishEntry(*pNewTable, &entry);
+            }
+
+            pTable = pNewTable.get();
+            shard.tables.emplace_back(std::move(pNewTable));
+            shard.pTable.store(pTable, std::memory_order_release);
+        }
+
+        StringEntry& entry = shard.entries.emplace_back();
+        entry.id = id;
+        entry.pStr = pStr;
+        entry.length = length;
+        entry.isUsed.store(isUsed, std::memory_order_relaxed);
+
+        if (isUsed) {
+            m_usedEntriesCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        PublishEntry(*pTable, &entry);
+
+        return &entry;
+    }
+
+
+    template <typename ElemT, typename IdT>
+    inline void StrIDDataStorage<ElemT, IdT>::MarkEntryUsed(const StringEntry* pEntry) noexcept
+    {
+        // Plain load first, so lookups of already used strings don't write to the shared cache line
+        if (!pEntry->isUsed.load(std::memory_order_relaxed) && !pEntry->isUsed.exchange(true, std::memory_order_relaxed)) {
+            m_usedEntriesCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+
+    template <typename ElemT, typename IdT>
+    inline uint64_t StrIDDataStorage<ElemT, IdT>::GetSerializedTableHashProbe() noexcept
+    {
+        const IdType probeId = Traits::Compute(SERIALIZED_TABLE_HASH_PROBE, std::size(SERIALIZED_TABLE_HASH_PROBE) - 1);
+        return Traits::Fold(probeId);
+    }
+
+
+#if defined(AM_STRID_COLLISION_CHECK_ENABLED)
+    template <typename ElemT, typename IdT>
+    inline void StrIDDataStorage<ElemT, IdT>::CheckCollision(const StringEntry* pEntry, const StringViewType& str) noexcept
+    {
+        if (StringViewType(pEntry->pStr, pEntry->length) == str) {
+            return;
+        }
+
+        if constexpr (std::is_same_v<ElementType, char>) {
+            AM_ASSERT_FAIL("StrID hash collision: \"{}\" and \"{}\" have the same id", pEntry->pStr, str);
+        } else {
+            AM_ASSERT_FAIL("StrID hash collision: strings of length {} and {} have the same id", pEntry->length, str.length());
+        }
+    }
+#endif
+
+
+    template <typename ElemT, typename IdT>
+    inline StrIDImpl<ElemT, IdT>::StrIDImpl(const ElementType *str)
+        : m_id(GetStorage().Store(str))
     {
     }
     
     
-    template <typename ElemT>
-    inline StrIDImpl<ElemT>::StrIDImpl(const StringType &str)
-        : m_id(s_storage.Store(str))
+    template <typename ElemT, typename IdT>
+    inline StrIDImpl<ElemT, IdT>::StrIDImpl(const StringType &str)
+        : m_id(GetStorage().Store(str))
     {
     }
     
     
-    template <typename ElemT>
-    inline StrIDImpl<ElemT>::StrIDImpl(const StringViewType &str)
-        : m_id(s_storage.Store(str))
+    template <typename ElemT, typename IdT>
+    inline StrIDImpl<ElemT, IdT>::StrIDImpl(const StringViewType &str)
+        : m_id(GetStorage().Store(str))
     {
     }
 
 
-    template <typename ElemT>
-    inline StrIDImpl<ElemT>& StrIDImpl<ElemT>::operator=(const typename StrIDImpl<ElemT>::ElementType *str) noexcept
+    template <typename ElemT, typename IdT>
+    inline StrIDImpl<ElemT, IdT>::StrIDImpl(StrIDLiteralType literal)
+        : m_id(GetStorage().Store(literal.View(), literal.GetId()))
     {
-        m_id = s_storage.Store(str);
+    }
+
+
+    template <typename ElemT, typename IdT>
+    inline StrIDImpl<ElemT, IdT>& StrIDImpl<ElemT, IdT>::operator=(const ElementType *str) noexcept
+    {
+        m_id = GetStorage().Store(str);
+        return *this;
+    }
+
+
+    template <typename ElemT, typename IdT>
+    inline StrIDImpl<ElemT, IdT>& StrIDImpl<ElemT, IdT>::operator=(const StringViewType &str) noexcept
+    {
+        m_id = GetStorage().Store(str);
         return *this;
     }
     
     
-    template <typename ElemT>
-    inline const ElemT* StrIDImpl<ElemT>::CStr() const noexcept
+    template <typename ElemT, typename IdT>
+    inline const ElemT* StrIDImpl<ElemT, IdT>::CStr() const noexcept
+    {
+        return GetStorage().Load(m_id);
+    }
+
+
+    template <typename ElemT, typename IdT>
+    inline typename StrIDImpl<ElemT, IdT>::StrIDDataStorageType& StrIDImpl<ElemT, IdT>::GetStorage() noexcept
     {
-        return s_storage.Load(m_id);
+        static StrIDDataStorageType storage;
+        return storage;
     }
-}
\ No newline at end of file
+}
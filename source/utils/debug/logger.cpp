@@ -106,6 +106,18 @@ Logger::Logger()
 }
 
 
+void Logger::SetLevel(spdlog::level::level_enum level) noexcept
+{
+    for (const std::shared_ptr<spdlog::logger>& pLogger : m_loggers) {
+        pLogger->set_level(level);
+    }
+
+    if (s_pDefaultLogger) {
+        s_pDefaultLogger->set_level(level);
+    }
+}
+
+
 bool Logger::IsCustomLogger(Type type) const noexcept
 {
     return (size_t)type < m_loggers.size() && m_loggers[(size_t)type] != nullptr;
@@ -138,3 +150,13 @@ bool amIsLogSystemInitialized() noexcept
     return true;
 #endif
 }
+
+
+void amSetLogLevel(spdlog::level::level_enum level) noexcept
+{
+#if defined(AM_LOGGING_ENABLED)
+    if (Logger* pLogger = Logger::Instance()) {
+        pLogger->SetLevel(level);
+    }
+#endif
+}
@@ -46,6 +46,9 @@ public:
     Logger(Logger&& app) = delete;
     Logger& operator=(Logger&& app) = delete;
 
+    // Messages below the level are dropped by all loggers including the default one
+    void SetLevel(spdlog::level::level_enum level) noexcept;
+
     template <typename... Args>
     void Info(Type type, bool printMessageOnly, const char* file, const char* function, uint32_t line, const char* additionalInfo, const char* format, Args&&... args);
 
@@ -91,6 +94,8 @@ void amTerminateLogSystem() noexcept;
 
 bool amIsLogSystemInitialized() noexcept;
 
+void amSetLogLevel(spdlog::level::level_enum level) noexcept;
+
 
 #if defined(AM_LOGGING_ENABLED)
     #define AM_LOG_ERROR(format, ...) LoggerError(Logger::Type::APPLICATION, false, __FILE__, __FUNCTION__, __LINE__, nullptr, format, __VA_ARGS__)
@@ -0,0 +1,217 @@
+#include "pch.h"
+
+#include "async_file_io.h"
+#include "virtual_file_system.h"
+
+#include "utils/debug/assertion.h"
+
+
+// File reads are IO bound, so more workers than this only add contention on the storage device queue
+static constexpr uint32_t AM_ASYNC_FILE_IO_MAX_DEFAULT_WORKERS_COUNT = 4;
+
+
+AsyncFileIO& AsyncFileIO::Instance() noexcept
+{
+    AM_ASSERT(s_pAsyncFileIOInstance != nullptr, "AsyncFileIO is not initialized, call AsyncFileIO::Init first");
+
+    return *s_pAsyncFileIOInstance;
+}
+
+
+bool AsyncFileIO::Init(uint32_t workersCount) noexcept
+{
+    if (IsInitialized()) {
+        AM_LOG_WARN("AsyncFileIO is already initialized");
+        return true;
+    }
+
+    if (workersCount == 0) {
+        const uint32_t hardwareThreadsCount = std::thread::hardware_concurrency();
+        workersCount = std::clamp(hardwareThreadsCount / 2, 1u, AM_ASYNC_FILE_IO_MAX_DEFAULT_WORKERS_COUNT);
+    }
+
+    s_pAsyncFileIOInstance = std::unique_ptr<AsyncFileIO>(new AsyncFileIO(workersCount));
+    if (!s_pAsyncFileIOInstance) {
+        AM_ASSERT_FAIL("Failed to allocate AsyncFileIO");
+        return false;
+    }
+
+    AM_LOG_INFO("AsyncFileIO initialized with {} workers", workersCount);
+
+    return true;
+}
+
+
+void AsyncFileIO::Terminate() noexcept
+{
+    s_pAsyncFileIOInstance = nullptr;
+}
+
+
+AsyncFileIO::AsyncFileIO(uint32_t workersCount)
+{
+    m_workers.reserve(workersCount);
+
+    for (uint32_t i = 0; i < workersCount; ++i) {
+        m_workers.emplace_back(&AsyncFileIO::RunWorker, this);
+    }
+}
+
+
+AsyncFileIO::~AsyncFileIO()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_requestsMutex);
+        m_isStopRequested = true;
+    }
+
+    m_requestsCV.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+
+std::future<AsyncFileReadResult> AsyncFileIO::ReadFileAsync(const fs::path& filepath) noexcept
+{
+    ReadRequest request = {};
+    request.filepath = filepath;
+
+    std::future<AsyncFileReadResult> future = request.promise.get_future();
+
+    SubmitRequest(std::move(request));
+
+    return future;
+}
+
+
+void AsyncFileIO::ReadFileAsync(const fs::path& filepath, AsyncFileReadCallback callback) noexcept
+{
+    AM_ASSERT(callback, "Async file read callback is empty");
+
+    ReadRequest request = {};
+    request.filepath = filepath;
+    request.callback = std::move(callback);
+
+    SubmitRequest(std::move(request));
+}
+
+
+std::vector<std::future<AsyncFileReadResult>> AsyncFileIO::ReadFilesAsync(const std::vector<fs::path>& filepaths) noexcept
+{
+    std::vector<std::future<AsyncFileReadResult>> futures;
+    futures.reserve(filepaths.size());
+
+    {
+        std::lock_guard<std::mutex> lock(m_requestsMutex);
+
+        for (const fs::path& filepath : filepaths) {
+            ReadRequest& request = m_requests.emplace_back();
+            request.filepath = filepath;
+
+            futures.emplace_back(request.promise.get_future());
+        }
+
+        m_requestsInFlightCount += filepaths.size();
+    }
+
+    m_requestsCV.notify_all();
+
+    return futures;
+}
+
+
+void AsyncFileIO::WaitIdle() noexcept
+{
+    std::unique_lock<std::mutex> lock(m_requestsMutex);
+    m_idleCV.wait(lock, [this]() { return m_requestsInFlightCount == 0; });
+}
+
+
+void AsyncFileIO::SubmitRequest(ReadRequest&& request) noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(m_requestsMutex);
+
+        m_requests.emplace_back(std::move(request));
+        ++m_requestsInFlightCount;
+    }
+
+    m_requestsCV.notify_one();
+}
+
+
+void AsyncFileIO::RunWorker() noexcept
+{
+    while (true) {
+        ReadRequest request;
+
+        {
+            std::unique_lock<std::mutex> lock(m_requestsMutex);
+            m_requestsCV.wait(lock, [this]() { return m_isStopRequested || !m_requests.empty(); });
+
+            // Pending requests are still served on stop, so no future is left without a value
+            if (m_requests.empty()) {
+                return;
+            }
+
+            request = std::move(m_requests.front());
+            m_requests.pop_front();
+        }
+
+        AsyncFileReadResult result = ReadFile(request.filepath);
+
+        if (request.callback) {
+            request.callback(result);
+        } else {
+            request.promise.set_value(std::move(result));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_requestsMutex);
+            --m_requestsInFlightCount;
+        }
+
+        m_idleCV.notify_all();
+    }
+}
+
+
+AsyncFileReadResult AsyncFileIO::ReadFile(const fs::path& filepath) noexcept
+{
+    AsyncFileReadResult result = {};
+    result.filepath = filepath;
+
+    if (VirtualFileSystem::IsInitialized()) {
+        result.succeeded = VirtualFileSystem::Instance().ReadFile(filepath, result.data);
+
+        if (!result.succeeded) {
+            AM_LOG_WARN("Async file reading error. Failed to read {} file.", filepath.string().c_str());
+        }
+
+        return result;
+    }
+
+    std::ifstream file(filepath, std::ios_base::ate | std::ios_base::binary);
+    if (!file.is_open()) {
+        AM_LOG_WARN("Async file reading error. Failed to open {} file.", filepath.string().c_str());
+        return result;
+    }
+
+    const size_t fileSize = static_cast<size_t>(file.tellg());
+
+    result.data.resize(fileSize);
+
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(result.data.data()), fileSize);
+
+    result.succeeded = !file.fail();
+
+    if (!result.succeeded) {
+        AM_LOG_WARN("Async file reading error. Failed to read {} file.", filepath.string().c_str());
+        result.data.clear();
+    }
+
+    return result;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+#include <deque>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+
+#include <cstdint>
+
+#include "path_system/path_system.h"
+
+
+struct AsyncFileReadResult
+{
+    fs::path filepath;
+    std::vector<uint8_t> data;
+    bool succeeded = false;
+};
+
+
+// Invoked on one of the IO worker threads
+using AsyncFileReadCallback = std::function<void(AsyncFileReadResult& result)>;
+
+
+// Reads files on a pool of IO worker threads, so callers can overlap file reading with processing of already read files.
+// Requests are served in submission order. Terminate waits until all submitted requests are completed
+class AsyncFileIO
+{
+public:
+    static AsyncFileIO& Instance() noexcept;
+
+    // workersCount = 0 selects the default workers count
+    static bool Init(uint32_t workersCount = 0) noexcept;
+    static void Terminate() noexcept;
+
+    static bool IsInitialized() noexcept { return s_pAsyncFileIOInstance != nullptr; }
+
+    AsyncFileIO(const AsyncFileIO& fileIO) = delete;
+    AsyncFileIO& operator=(const AsyncFileIO& fileIO) = delete;
+
+    AsyncFileIO(AsyncFileIO&& fileIO) = delete;
+    AsyncFileIO& operator=(AsyncFileIO&& fileIO) = delete;
+
+    ~AsyncFileIO();
+
+    std::future<AsyncFileReadResult> ReadFileAsync(const fs::path& filepath) noexcept;
+    void ReadFileAsync(const fs::path& filepath, AsyncFileReadCallback callback) noexcept;
+
+    // Submits the whole batch under one lock and wakes workers once. Futures are in the filepaths order
+    std::vector<std::future<AsyncFileReadResult>> ReadFilesAsync(const std::vector<fs::path>& filepaths) noexcept;
+
+    // Blocks until all submitted requests are completed
+    void WaitIdle() noexcept;
+
+    size_t GetWorkersCount() const noexcept { return m_workers.size(); }
+
+private:
+    struct ReadRequest
+    {
+        fs::path filepath;
+        std::promise<AsyncFileReadResult> promise;
+        AsyncFileReadCallback callback;
+    };
+
+private:
+    explicit AsyncFileIO(uint32_t workersCount);
+
+    void SubmitRequest(ReadRequest&& request) noexcept;
+    void RunWorker() noexcept;
+
+    static AsyncFileReadResult ReadFile(const fs::path& filepath) noexcept;
+
+private:
+    static inline std::unique_ptr<AsyncFileIO> s_pAsyncFileIOInstance = nullptr;
+
+private:
+    std::vector<std::thread> m_workers;
+
+    std::deque<ReadRequest> m_requests;
+    size_t m_requestsInFlightCount = 0;
+
+    std::mutex m_requestsMutex;
+    std::condition_variable m_requestsCV;
+    std::condition_variable m_idleCV;
+
+    bool m_isStopRequested = false;
+};
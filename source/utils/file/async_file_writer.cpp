@@ -0,0 +1,117 @@
+#include "pch.h"
+
+#include "async_file_writer.h"
+#include "file.h"
+
+#include "utils/debug/assertion.h"
+
+
+AsyncFileWriter& AsyncFileWriter::Instance() noexcept
+{
+    AM_ASSERT(s_pAsyncFileWriterInstance != nullptr, "AsyncFileWriter is not initialized, call AsyncFileWriter::Init first");
+
+    return *s_pAsyncFileWriterInstance;
+}
+
+
+bool AsyncFileWriter::Init() noexcept
+{
+    if (IsInitialized()) {
+        AM_LOG_WARN("AsyncFileWriter is already initialized");
+        return true;
+    }
+
+    s_pAsyncFileWriterInstance = std::unique_ptr<AsyncFileWriter>(new AsyncFileWriter());
+    if (!s_pAsyncFileWriterInstance) {
+        AM_ASSERT_FAIL("Failed to allocate AsyncFileWriter");
+        return false;
+    }
+
+    return true;
+}
+
+
+void AsyncFileWriter::Terminate() noexcept
+{
+    s_pAsyncFileWriterInstance = nullptr;
+}
+
+
+AsyncFileWriter::AsyncFileWriter()
+{
+    // Started after all members are constructed
+    m_worker = std::thread(&AsyncFileWriter::RunWorker, this);
+}
+
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_requestsMutex);
+        m_isStopRequested = true;
+    }
+
+    m_requestsCV.notify_all();
+    m_worker.join();
+}
+
+
+void AsyncFileWriter::WriteFileAsync(const fs::path& filepath, std::vector<uint8_t>&& data) noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(m_requestsMutex);
+
+        const auto pendingRequestIt = std::find_if(m_requests.begin(), m_requests.end(),
+            [&filepath](const WriteRequest& request) { return request.filepath == filepath; });
+
+        if (pendingRequestIt != m_requests.end()) {
+            pendingRequestIt->data = std::move(data);
+            return;
+        }
+
+        WriteRequest& request = m_requests.emplace_back();
+        request.filepath = filepath;
+        request.data = std::move(data);
+    }
+
+    m_requestsCV.notify_one();
+}
+
+
+void AsyncFileWriter::Flush() noexcept
+{
+    std::unique_lock<std::mutex> lock(m_requestsMutex);
+    m_flushCV.wait(lock, [this]() { return m_requests.empty() && !m_isWriting; });
+}
+
+
+void AsyncFileWriter::RunWorker() noexcept
+{
+    while (true) {
+        WriteRequest request;
+
+        {
+            std::unique_lock<std::mutex> lock(m_requestsMutex);
+            m_requestsCV.wait(lock, [this]() { return m_isStopRequested || !m_requests.empty(); });
+
+            // Queued writes are still committed on stop, nothing is lost on shutdown
+            if (m_requests.empty()) {
+                return;
+            }
+
+            request = std::move(m_requests.front());
+            m_requests.pop_front();
+
+            m_isWriting = true;
+        }
+
+        WriteBinaryFileAtomic(request.filepath, request.data.data(), request.data.size());
+
+        {
+            std::lock_guard<std::mutex> lock(m_requestsMutex);
+            m_isWriting = false;
+        }
+
+        m_flushCV.notify_all();
+    }
+}
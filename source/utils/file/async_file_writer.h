@@ -0,0 +1,69 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+
+#include <cstdint>
+
+#include "path_system/path_system.h"
+
+
+// Write-behind queue. Buffers are written on a background thread, so callers don't wait for the disk.
+// Every file is committed atomically (temporary file + rename). A queued write which hasn't started yet is replaced
+// by a newer write to the same file. Terminate flushes all queued writes
+class AsyncFileWriter
+{
+public:
+    static AsyncFileWriter& Instance() noexcept;
+
+    static bool Init() noexcept;
+    static void Terminate() noexcept;
+
+    static bool IsInitialized() noexcept { return s_pAsyncFileWriterInstance != nullptr; }
+
+    AsyncFileWriter(const AsyncFileWriter& writer) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter& writer) = delete;
+
+    AsyncFileWriter(AsyncFileWriter&& writer) = delete;
+    AsyncFileWriter& operator=(AsyncFileWriter&& writer) = delete;
+
+    ~AsyncFileWriter();
+
+    // Takes ownership of the data, so the caller may reuse or free its own copy right away
+    void WriteFileAsync(const fs::path& filepath, std::vector<uint8_t>&& data) noexcept;
+
+    // Blocks until all queued writes are committed
+    void Flush() noexcept;
+
+private:
+    struct WriteRequest
+    {
+        fs::path filepath;
+        std::vector<uint8_t> data;
+    };
+
+private:
+    AsyncFileWriter();
+
+    void RunWorker() noexcept;
+
+private:
+    static inline std::unique_ptr<AsyncFileWriter> s_pAsyncFileWriterInstance = nullptr;
+
+private:
+    std::thread m_worker;
+
+    std::deque<WriteRequest> m_requests;
+    bool m_isWriting = false;
+
+    std::mutex m_requestsMutex;
+    std::condition_variable m_requestsCV;
+    std::condition_variable m_flushCV;
+
+    bool m_isStopRequested = false;
+};
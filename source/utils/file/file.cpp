@@ -1,9 +1,75 @@
 #include "pch.h"
 
 #include "file.h"
+#include "file_stream_reader.h"
 
 #include "utils/debug/assertion.h"
 
+#if !defined(AM_OS_WINDOWS)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+
+static constexpr size_t AM_FILE_HASH_CHUNK_SIZE = 64 << 10;
+
+// Smaller files are hashed faster inline than with a read-ahead thread
+static constexpr uint64_t AM_FILE_HASH_STREAMING_MIN_FILE_SIZE = 4ull << 20;
+
+
+// Data is flushed to the disk before returning, so a following rename can't expose a file with missing content after a crash
+#if defined(AM_OS_WINDOWS)
+static bool WriteFileDurable(const fs::path& filepath, const uint8_t* data, size_t size) noexcept
+{
+    HANDLE fileHandle = CreateFileW(filepath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    bool isWritten = true;
+
+    for (size_t offset = 0; offset < size && isWritten;) {
+        const DWORD chunkSize = static_cast<DWORD>(std::min<size_t>(size - offset, MAXDWORD));
+        DWORD writtenSize = 0;
+
+        isWritten = WriteFile(fileHandle, data + offset, chunkSize, &writtenSize, nullptr) && writtenSize == chunkSize;
+        offset += writtenSize;
+    }
+
+    isWritten = isWritten && FlushFileBuffers(fileHandle);
+    isWritten = CloseHandle(fileHandle) && isWritten;
+
+    return isWritten;
+}
+#else
+static bool WriteFileDurable(const fs::path& filepath, const uint8_t* data, size_t size) noexcept
+{
+    const int fileDescriptor = open(filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fileDescriptor < 0) {
+        return false;
+    }
+
+    bool isWritten = true;
+
+    for (size_t offset = 0; offset < size && isWritten;) {
+        const ssize_t writtenSize = write(fileDescriptor, data + offset, size - offset);
+
+        if (writtenSize < 0) {
+            isWritten = errno == EINTR;
+            continue;
+        }
+
+        offset += static_cast<size_t>(writtenSize);
+    }
+
+    isWritten = isWritten && fsync(fileDescriptor) == 0;
+    isWritten = close(fileDescriptor) == 0 && isWritten;
+
+    return isWritten;
+}
+#endif
+
 
 template <typename BufferElemType>
 static void ReadFileInternal(const std::filesystem::path &filepath, std::ios_base::openmode mode, std::vector<BufferElemType>& outData) noexcept
@@ -103,6 +169,83 @@ void WriteBinaryFile(const fs::path &filepath, const uint8_t *data, size_t size)
 }
 
 
+bool WriteBinaryFileAtomic(const fs::path& filepath, const uint8_t* data, size_t size) noexcept
+{
+    AM_ASSERT(data || size == 0, "data is nullptr");
+
+    fs::path tempFilepath = filepath;
+    tempFilepath += ".tmp";
+
+    if (!WriteFileDurable(tempFilepath, data, size)) {
+        AM_LOG_WARN("File writing error. Failed to write {} file.", tempFilepath.string().c_str());
+
+        std::error_code error;
+        fs::remove(tempFilepath, error);
+
+        return false;
+    }
+
+    std::error_code error;
+    fs::rename(tempFilepath, filepath, error);
+
+    if (error) {
+        AM_LOG_WARN("File writing error. Failed to replace {} file: {}", filepath.string().c_str(), error.message().c_str());
+        fs::remove(tempFilepath, error);
+        return false;
+    }
+
+    return true;
+}
+
+
+std::optional<ds::Hash128> CalculateFileHash(const fs::path &filepath) noexcept
+{
+    std::error_code error;
+    const uintmax_t fileSize = fs::file_size(filepath, error);
+
+    if (!error && fileSize >= AM_FILE_HASH_STREAMING_MIN_FILE_SIZE) {
+        FileStreamReader reader;
+        if (!reader.Open(filepath)) {
+            return {};
+        }
+
+        ds::StreamHasher hasher;
+
+        for (FileView chunk = reader.ReadNextChunk(); !chunk.empty(); chunk = reader.ReadNextChunk()) {
+            hasher.Update(chunk.data(), chunk.size());
+        }
+
+        if (reader.HasFailed()) {
+            AM_LOG_WARN("File hashing error. Failed to read {} file.", filepath.string().c_str());
+            return {};
+        }
+
+        return hasher.Finalize128();
+    }
+
+    std::ifstream file(filepath, std::ios_base::binary);
+    if (!file.is_open()) {
+        AM_LOG_WARN("File hashing error. Failed to open {} file.", filepath.string().c_str());
+        return {};
+    }
+
+    std::vector<char> chunk(AM_FILE_HASH_CHUNK_SIZE);
+    ds::StreamHasher hasher;
+
+    while (file) {
+        file.read(chunk.data(), chunk.size());
+        hasher.Update(chunk.data(), static_cast<size_t>(file.gcount()));
+    }
+
+    if (file.bad()) {
+        AM_LOG_WARN("File hashing error. Failed to read {} file.", filepath.string().c_str());
+        return {};
+    }
+
+    return hasher.Finalize128();
+}
+
+
 size_t CalculateFilesCount(const fs::path &directoryPath) noexcept
 {
     size_t fileCount = 0;
@@ -3,10 +3,14 @@
 #include <filesystem>
 #include <vector>
 #include <optional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include <limits>
 
 #include "path_system/path_system.h"
+#include "utils/data_structures/hash.h"
 
 
 std::vector<char> ReadTextFile(const fs::path& filepath) noexcept;
@@ -18,21 +22,37 @@ void ReadBinaryFile(const fs::path& filepath, std::vector<uint8_t>& outData) noe
 void WriteTextFile(const fs::path& filepath, const char* data, size_t size) noexcept;
 void WriteBinaryFile(const fs::path& filepath, const uint8_t* data, size_t size) noexcept;
 
+// Writes data to a temporary file next to filepath, flushes it to the disk and renames it over filepath, so readers never see
+// a partially written file, even after a crash
+bool WriteBinaryFileAtomic(const fs::path& filepath, const uint8_t* data, size_t size) noexcept;
+
+// Hashes file content chunk by chunk without buffering the whole file. Result is equal to amHashMem128 of the file content
+std::optional<ds::Hash128> CalculateFileHash(const fs::path& filepath) noexcept;
+
 size_t CalculateFilesCount(const fs::path& directoryPath) noexcept;
 size_t CalculateDirectoriesCount(const fs::path& directoryPath) noexcept;
 
 
-// If dirTreeDepth < 0 than go throw all subdirectories
+// Walkers visit every entry once. dirTreeDepth is the number of nested subdirectory levels below rootDir to walk into:
+// 0 visits only rootDir entries, UINT32_MAX walks the whole tree. Unreadable directories are skipped.
+// Non-empty extension (".vert") limits visited files to the ones with that extension
 template <typename Func>
 void ForEachDirectory(const fs::path& rootDir, const Func& func, uint32_t dirTreeDepth = UINT32_MAX) noexcept;
 
 
 template <typename Func>
-void ForEachFile(const fs::path& rootDir, const Func& func, uint32_t dirTreeDepth = UINT32_MAX) noexcept;
+void ForEachFile(const fs::path& rootDir, const Func& func, uint32_t dirTreeDepth = UINT32_MAX, const fs::path& extension = fs::path()) noexcept;
+
+
+// Directories are distributed between workersCount threads (0 means hardware threads count),
+// so func is called concurrently and must be thread-safe. Visit order is unspecified
+template <typename Func>
+void ParallelForEachFile(const fs::path& rootDir, const Func& func, uint32_t dirTreeDepth = UINT32_MAX,
+    const fs::path& extension = fs::path(), uint32_t workersCount = 0) noexcept;
 
 
 template <typename Func>
-std::optional<fs::path> FindFirstFileIf(const fs::path& rootDir, const Func& func, uint32_t dirTreeDepth = UINT32_MAX) noexcept;
+std::optional<fs::path> FindFirstFileIf(const fs::path& rootDir, const Func& func, uint32_t dirTreeDepth = UINT32_MAX, const fs::path& extension = fs::path()) noexcept;
 
 
 #include "file.hpp"
\ No newline at end of file
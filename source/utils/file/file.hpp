@@ -1,42 +1,165 @@
+namespace detail
+{
+    inline bool IsFileWithExtension(const fs::directory_entry& entry, const fs::path& extension) noexcept
+    {
+        std::error_code error;
+        return !entry.is_directory(error) && (extension.empty() || entry.path().extension() == extension);
+    }
+
+
+    // Single pass over the tree: recursion into a directory is disabled once the depth limit is reached
+    template <typename Func>
+    inline void WalkDirectoryTree(const fs::path& rootDir, uint32_t dirTreeDepth, const Func& func) noexcept
+    {
+        std::error_code error;
+        fs::recursive_directory_iterator it(rootDir, fs::directory_options::skip_permission_denied, error);
+
+        for (; !error && it != fs::recursive_directory_iterator(); it.increment(error)) {
+            const fs::directory_entry& entry = *it;
+
+            std::error_code entryError;
+            if (entry.is_directory(entryError) && static_cast<uint32_t>(it.depth()) >= dirTreeDepth) {
+                it.disable_recursion_pending();
+            }
+
+            // Returning true stops the walk
+            if (func(entry)) {
+                return;
+            }
+        }
+    }
+}
+
+
 template <typename Func>
 inline void ForEachDirectory(const fs::path& rootDir, const Func& func, uint32_t dirTreeDepth) noexcept
 {
-    for (const fs::directory_entry& entry : fs::recursive_directory_iterator(rootDir)) {
-        if (entry.is_directory()) {
+    detail::WalkDirectoryTree(rootDir, dirTreeDepth, [&func](const fs::directory_entry& entry)
+    {
+        std::error_code error;
+        if (entry.is_directory(error)) {
             func(entry);
+        }
 
-            if (dirTreeDepth != 0) {
-                ForEachDirectory(entry.path(), func, dirTreeDepth - 1);
-            }
+        return false;
+    });
+}
+
+
+template <typename Func>
+inline void ForEachFile(const fs::path &rootDir, const Func &func, uint32_t dirTreeDepth, const fs::path& extension) noexcept
+{
+    detail::WalkDirectoryTree(rootDir, dirTreeDepth, [&func, &extension](const fs::directory_entry& entry)
+    {
+        if (detail::IsFileWithExtension(entry, extension)) {
+            func(entry);
         }
-    }
+
+        return false;
+    });
 }
 
 
 template <typename Func>
-inline void ForEachFile(const fs::path &rootDir, const Func &func, uint32_t dirTreeDepth) noexcept
+inline void ParallelForEachFile(const fs::path& rootDir, const Func& func, uint32_t dirTreeDepth, const fs::path& extension, uint32_t workersCount) noexcept
 {
-    for (const fs::directory_entry& entry : fs::recursive_directory_iterator(rootDir)) {
-        if (entry.is_directory() && (dirTreeDepth != 0)) {
-            ForEachFile(entry.path(), func, dirTreeDepth - 1);
-            continue;
+    struct DirectoryTask
+    {
+        fs::path dirpath;
+        uint32_t depth;
+    };
+
+    std::vector<DirectoryTask> tasks = { DirectoryTask { rootDir, 0 } };
+    size_t busyWorkersCount = 0;
+
+    std::mutex tasksMutex;
+    std::condition_variable tasksCV;
+
+    // Every worker lists one directory at a time and hands its subdirectories back to the queue,
+    // so big subtrees are split between all workers. Workers finish once the queue is empty and nobody can refill it
+    const auto RunWorker = [&]()
+    {
+        std::vector<DirectoryTask> subdirTasks;
+
+        while (true) {
+            DirectoryTask task;
+
+            {
+                std::unique_lock<std::mutex> lock(tasksMutex);
+                tasksCV.wait(lock, [&]() { return !tasks.empty() || busyWorkersCount == 0; });
+
+                if (tasks.empty()) {
+                    return;
+                }
+
+                task = std::move(tasks.back());
+                tasks.pop_back();
+
+                ++busyWorkersCount;
+            }
+
+            std::error_code error;
+            fs::directory_iterator it(task.dirpath, fs::directory_options::skip_permission_denied, error);
+
+            for (; !error && it != fs::directory_iterator(); it.increment(error)) {
+                const fs::directory_entry& entry = *it;
+
+                std::error_code entryError;
+                if (entry.is_directory(entryError)) {
+                    // Directory symlinks aren't followed, same as in the single-threaded walkers
+                    if (task.depth < dirTreeDepth && !entry.is_symlink(entryError)) {
+                        subdirTasks.emplace_back(DirectoryTask { entry.path(), task.depth + 1 });
+                    }
+                } else if (detail::IsFileWithExtension(entry, extension)) {
+                    func(entry);
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(tasksMutex);
+
+                std::move(subdirTasks.begin(), subdirTasks.end(), std::back_inserter(tasks));
+                --busyWorkersCount;
+            }
+
+            subdirTasks.clear();
+            tasksCV.notify_all();
         }
-        
-        func(entry);
+    };
+
+    if (workersCount == 0) {
+        workersCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(workersCount - 1);
+
+    for (uint32_t i = 1; i < workersCount; ++i) {
+        workers.emplace_back(RunWorker);
+    }
+
+    RunWorker();
+
+    for (std::thread& worker : workers) {
+        worker.join();
     }
 }
 
 
 template <typename Func>
-inline std::optional<fs::path> FindFirstFileIf(const fs::path &rootDir, const Func &func, uint32_t dirTreeDepth) noexcept
+inline std::optional<fs::path> FindFirstFileIf(const fs::path &rootDir, const Func &func, uint32_t dirTreeDepth, const fs::path& extension) noexcept
 {
-    for (const fs::directory_entry& entry : fs::recursive_directory_iterator(rootDir)) {
-        if (!entry.is_directory() && func(entry)) {
-            return entry.path();
-        } else if (entry.is_directory() && (dirTreeDepth != 0)) {
-            return FindFirstFileIf(entry.path(), func, dirTreeDepth - 1);
+    std::optional<fs::path> result = std::nullopt;
+
+    detail::WalkDirectoryTree(rootDir, dirTreeDepth, [&func, &extension, &result](const fs::directory_entry& entry)
+    {
+        if (detail::IsFileWithExtension(entry, extension) && func(entry)) {
+            result = entry.path();
+            return true;
         }
-    }
 
-    return std::nullopt;
-}
\ No newline at end of file
+        return false;
+    });
+
+    return result;
+}
@@ -0,0 +1,327 @@
+#include "pch.h"
+
+#include "file_fingerprint_db.h"
+#include "mapped_file.h"
+#include "file.h"
+#include "async_file_writer.h"
+
+#include "utils/debug/assertion.h"
+
+#if !defined(AM_OS_WINDOWS)
+    #include <sys/stat.h>
+    #include <time.h>
+#endif
+
+
+static constexpr uint32_t AM_FILE_FINGERPRINT_DB_MAGIC   = 0x50464D41; // 'AMFP'
+static constexpr uint32_t AM_FILE_FINGERPRINT_DB_VERSION = 2;
+
+// Coarsest file write time resolution the database is used with (FAT keeps 2 seconds), in FileStat::writeTime units
+#if defined(AM_OS_WINDOWS)
+    static constexpr int64_t AM_FILE_WRITE_TIME_RESOLUTION = 2ll * 10'000'000ll;
+#else
+    static constexpr int64_t AM_FILE_WRITE_TIME_RESOLUTION = 2ll * 1'000'000'000ll;
+#endif
+
+
+// File fingerprint database structure:
+//      4 bytes - magic
+//      4 bytes - version
+//      8 bytes - entries count
+//      8 bytes - save time
+//      Entries (FileFingerprintDBEntry):
+//          8 bytes - path StrID id
+//          8 bytes - write time
+//          8 bytes - size
+//          8 bytes - file id
+//         16 bytes - content hash
+struct FileFingerprintDBHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t entriesCount;
+    int64_t  saveTime;
+};
+
+
+struct FileFingerprintDBEntry
+{
+    uint64_t    pathId;
+    int64_t     writeTime;
+    uint64_t    size;
+    uint64_t    fileId;
+    ds::Hash128 contentHash;
+};
+
+
+static_assert(std::is_same_v<ds::StrID::IdType, uint64_t>, "File fingerprint database stores 64-bit path StrID ids");
+static_assert(sizeof(FileFingerprintDBHeader) == 24, "File fingerprint database header layout changed, update AM_FILE_FINGERPRINT_DB_VERSION");
+static_assert(sizeof(FileFingerprintDBEntry) == 48, "File fingerprint database entry layout changed, update AM_FILE_FINGERPRINT_DB_VERSION");
+
+
+#if defined(AM_OS_WINDOWS)
+std::optional<FileStat> QueryFileStat(const fs::path& filepath) noexcept
+{
+    // Zero access rights are enough to query attributes, and don't conflict with writers holding the file
+    HANDLE fileHandle = CreateFileW(filepath.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+        OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        return std::nullopt;
+    }
+
+    BY_HANDLE_FILE_INFORMATION fileInfo = {};
+    const BOOL succeeded = GetFileInformationByHandle(fileHandle, &fileInfo);
+
+    CloseHandle(fileHandle);
+
+    if (!succeeded) {
+        return std::nullopt;
+    }
+
+    FileStat fileStat = {};
+    fileStat.writeTime = static_cast<int64_t>((static_cast<uint64_t>(fileInfo.ftLastWriteTime.dwHighDateTime) << 32) | fileInfo.ftLastWriteTime.dwLowDateTime);
+    fileStat.size      = (static_cast<uint64_t>(fileInfo.nFileSizeHigh) << 32) | fileInfo.nFileSizeLow;
+    fileStat.fileId    = (static_cast<uint64_t>(fileInfo.nFileIndexHigh) << 32) | fileInfo.nFileIndexLow;
+
+    return fileStat;
+}
+
+
+// Current time in FileStat::writeTime units
+static int64_t QueryCurrentFileTime() noexcept
+{
+    FILETIME fileTime = {};
+    GetSystemTimeAsFileTime(&fileTime);
+
+    return static_cast<int64_t>((static_cast<uint64_t>(fileTime.dwHighDateTime) << 32) | fileTime.dwLowDateTime);
+}
+#else
+std::optional<FileStat> QueryFileStat(const fs::path& filepath) noexcept
+{
+    struct stat fileInfo = {};
+    if (stat(filepath.c_str(), &fileInfo) != 0) {
+        return std::nullopt;
+    }
+
+    FileStat fileStat = {};
+    fileStat.writeTime = static_cast<int64_t>(fileInfo.st_mtim.tv_sec) * 1'000'000'000ll + fileInfo.st_mtim.tv_nsec;
+    fileStat.size      = static_cast<uint64_t>(fileInfo.st_size);
+    fileStat.fileId    = static_cast<uint64_t>(fileInfo.st_ino);
+
+    return fileStat;
+}
+
+
+// Current time in FileStat::writeTime units
+static int64_t QueryCurrentFileTime() noexcept
+{
+    struct timespec currentTime = {};
+    clock_gettime(CLOCK_REALTIME, &currentTime);
+
+    return static_cast<int64_t>(currentTime.tv_sec) * 1'000'000'000ll + currentTime.tv_nsec;
+}
+#endif
+
+
+FileFingerprintDB& FileFingerprintDB::Instance() noexcept
+{
+    AM_ASSERT(s_pFileFingerprintDBInstance != nullptr, "FileFingerprintDB is not initialized, call FileFingerprintDB::Init first");
+
+    return *s_pFileFingerprintDBInstance;
+}
+
+
+bool FileFingerprintDB::Init(const fs::path& dbFilepath) noexcept
+{
+    if (IsInitialized()) {
+        AM_LOG_WARN("FileFingerprintDB is already initialized");
+        return true;
+    }
+
+    s_pFileFingerprintDBInstance = std::unique_ptr<FileFingerprintDB>(new FileFingerprintDB(dbFilepath));
+    if (!s_pFileFingerprintDBInstance) {
+        AM_ASSERT_FAIL("Failed to allocate FileFingerprintDB");
+        return false;
+    }
+
+    s_pFileFingerprintDBInstance->Load();
+
+    return true;
+}
+
+
+void FileFingerprintDB::Terminate() noexcept
+{
+    s_pFileFingerprintDBInstance = nullptr;
+}
+
+
+FileFingerprintDB::FileFingerprintDB(const fs::path& dbFilepath)
+    : m_dbFilepath(dbFilepath)
+{
+}
+
+
+FileFingerprintDB::~FileFingerprintDB()
+{
+    Store();
+}
+
+
+std::optional<FileFingerprint> FileFingerprintDB::GetFingerprint(ds::StrID filepath) noexcept
+{
+    AM_ASSERT(filepath.IsValid(), "Invalid filepath StrID");
+
+    const std::optional<FileStat> fileStat = QueryFileStat(filepath.CStr());
+    if (!fileStat.has_value()) {
+        return std::nullopt;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_fingerprintsMutex);
+
+        const auto fingerprintIt = m_fingerprints.find(filepath.GetId());
+        if (fingerprintIt != m_fingerprints.end() && fingerprintIt->second.stat == fileStat.value()) {
+            return fingerprintIt->second;
+        }
+    }
+
+    // Hashing is done outside of the lock, so different files can be rehashed in parallel
+    const std::optional<ds::Hash128> contentHash = CalculateFileHash(filepath.CStr());
+    if (!contentHash.has_value()) {
+        return std::nullopt;
+    }
+
+    FileFingerprint fingerprint = {};
+    fingerprint.stat = fileStat.value();
+    fingerprint.contentHash = contentHash.value();
+
+    {
+        std::lock_guard<std::mutex> lock(m_fingerprintsMutex);
+
+        m_fingerprints.insert_or_assign(filepath.GetId(), fingerprint);
+        m_isDirty = true;
+    }
+
+    return fingerprint;
+}
+
+
+std::optional<ds::Hash128> FileFingerprintDB::GetContentHash(ds::StrID filepath) noexcept
+{
+    const std::optional<FileFingerprint> fingerprint = GetFingerprint(filepath);
+    return fingerprint.has_value() ? std::optional<ds::Hash128>(fingerprint->contentHash) : std::nullopt;
+}
+
+
+void FileFingerprintDB::Store() noexcept
+{
+    std::vector<uint8_t> buffer;
+
+    {
+        std::lock_guard<std::mutex> lock(m_fingerprintsMutex);
+
+        if (!m_isDirty) {
+            return;
+        }
+
+        FileFingerprintDBHeader header = {};
+        header.magic = AM_FILE_FINGERPRINT_DB_MAGIC;
+        header.version = AM_FILE_FINGERPRINT_DB_VERSION;
+        header.entriesCount = m_fingerprints.size();
+        header.saveTime = QueryCurrentFileTime();
+
+        buffer.resize(sizeof(FileFingerprintDBHeader) + m_fingerprints.size() * sizeof(FileFingerprintDBEntry));
+        memcpy_s(buffer.data(), buffer.size(), &header, sizeof(header));
+
+        uint8_t* pEntryData = buffer.data() + sizeof(FileFingerprintDBHeader);
+
+        for (const auto& [pathId, fingerprint] : m_fingerprints) {
+            FileFingerprintDBEntry entry = {};
+            entry.pathId      = pathId;
+            entry.writeTime   = fingerprint.stat.writeTime;
+            entry.size        = fingerprint.stat.size;
+            entry.fileId      = fingerprint.stat.fileId;
+            entry.contentHash = fingerprint.contentHash;
+
+            memcpy_s(pEntryData, buffer.size() - (pEntryData - buffer.data()), &entry, sizeof(entry));
+            pEntryData += sizeof(FileFingerprintDBEntry);
+        }
+
+        m_isDirty = false;
+    }
+
+    if (AsyncFileWriter::IsInitialized()) {
+        AsyncFileWriter::Instance().WriteFileAsync(m_dbFilepath, std::move(buffer));
+    } else {
+        WriteBinaryFileAtomic(m_dbFilepath, buffer.data(), buffer.size());
+    }
+}
+
+
+size_t FileFingerprintDB::GetEntriesCount() const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_fingerprintsMutex);
+    return m_fingerprints.size();
+}
+
+
+void FileFingerprintDB::Load() noexcept
+{
+    std::error_code error;
+    if (!fs::exists(m_dbFilepath, error)) {
+        return;
+    }
+
+    MappedFile dbFile;
+    if (!dbFile.Open(m_dbFilepath, MAPPED_FILE_ACCESS_SEQUENTIAL)) {
+        return;
+    }
+
+    FileFingerprintDBHeader header = {};
+
+    if (dbFile.GetSize() < sizeof(header)) {
+        AM_LOG_WARN("File fingerprint database {} is corrupted and will be rebuilt", m_dbFilepath.string().c_str());
+        return;
+    }
+
+    memcpy_s(&header, sizeof(header), dbFile.GetData(), sizeof(header));
+
+    const size_t entriesSize = dbFile.GetSize() - sizeof(header);
+
+    if (header.magic != AM_FILE_FINGERPRINT_DB_MAGIC || header.version != AM_FILE_FINGERPRINT_DB_VERSION ||
+        entriesSize != header.entriesCount * sizeof(FileFingerprintDBEntry)) {
+        AM_LOG_WARN("File fingerprint database {} is outdated or corrupted and will be rebuilt", m_dbFilepath.string().c_str());
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_fingerprintsMutex);
+
+    m_fingerprints.reserve(header.entriesCount);
+
+    const uint8_t* pEntryData = dbFile.GetData() + sizeof(header);
+
+    // A file written within the write time resolution before the save may have been modified again after it was hashed
+    // without changing its stat. Such entries are skipped, so the files are rehashed on the first query
+    const int64_t racyWriteTimeBegin = header.saveTime - AM_FILE_WRITE_TIME_RESOLUTION;
+    size_t racyEntriesCount = 0;
+
+    for (uint64_t i = 0; i < header.entriesCount; ++i, pEntryData += sizeof(FileFingerprintDBEntry)) {
+        FileFingerprintDBEntry entry = {};
+        memcpy_s(&entry, sizeof(entry), pEntryData, sizeof(entry));
+
+        if (entry.writeTime >= racyWriteTimeBegin) {
+            ++racyEntriesCount;
+            continue;
+        }
+
+        FileFingerprint& fingerprint = m_fingerprints[entry.pathId];
+        fingerprint.stat.writeTime = entry.writeTime;
+        fingerprint.stat.size      = entry.size;
+        fingerprint.stat.fileId    = entry.fileId;
+        fingerprint.contentHash    = entry.contentHash;
+    }
+
+    AM_LOG_INFO("Loaded {} file fingerprints from {}, {} will be rehashed", m_fingerprints.size(), m_dbFilepath.string().c_str(), racyEntriesCount);
+}
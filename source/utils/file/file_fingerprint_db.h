@@ -0,0 +1,93 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <mutex>
+#include <memory>
+
+#include <cstdint>
+
+#include "path_system/path_system.h"
+
+#include "utils/data_structures/strid.h"
+#include "utils/data_structures/hash.h"
+#include "utils/data_structures/flat_hash_map.h"
+
+
+// File stat metadata. Equal stats mean the file wasn't modified, so its content doesn't need to be read
+struct FileStat
+{
+    bool operator==(const FileStat& other) const noexcept { return writeTime == other.writeTime && size == other.size && fileId == other.fileId; }
+    bool operator!=(const FileStat& other) const noexcept { return !(*this == other); }
+
+    int64_t  writeTime = 0;
+    uint64_t size = 0;
+    uint64_t fileId = 0;    // Inode on POSIX systems, NTFS file index on Windows
+};
+
+
+struct FileFingerprint
+{
+    FileStat    stat;
+    ds::Hash128 contentHash;
+};
+
+
+// Queries file stat with a single system call, without reading the file content
+std::optional<FileStat> QueryFileStat(const fs::path& filepath) noexcept;
+
+
+// Persistent map of file path StrID to the file stat and content hash. Content is rehashed only when the file stat
+// differs from the stored one or the file was written right before the database was saved, so checking an unchanged file
+// costs one stat call. Thread-safe
+class FileFingerprintDB
+{
+public:
+    static FileFingerprintDB& Instance() noexcept;
+
+    // Loads the database from dbFilepath if it exists. Terminate stores it back if any fingerprint changed
+    static bool Init(const fs::path& dbFilepath) noexcept;
+    static void Terminate() noexcept;
+
+    static bool IsInitialized() noexcept { return s_pFileFingerprintDBInstance != nullptr; }
+
+    FileFingerprintDB(const FileFingerprintDB& db) = delete;
+    FileFingerprintDB& operator=(const FileFingerprintDB& db) = delete;
+
+    FileFingerprintDB(FileFingerprintDB&& db) = delete;
+    FileFingerprintDB& operator=(FileFingerprintDB&& db) = delete;
+
+    ~FileFingerprintDB();
+
+    // Returns up to date fingerprint of the file or nullopt if the file can't be read
+    std::optional<FileFingerprint> GetFingerprint(ds::StrID filepath) noexcept;
+    std::optional<ds::Hash128> GetContentHash(ds::StrID filepath) noexcept;
+
+    void Store() noexcept;
+
+    size_t GetEntriesCount() const noexcept;
+
+private:
+    struct FingerprintKeyHasher
+    {
+        using is_avalanching = void;
+        uint64_t operator()(ds::StrID::IdType id) const noexcept { return id; }
+    };
+
+private:
+    explicit FileFingerprintDB(const fs::path& dbFilepath);
+
+    void Load() noexcept;
+
+private:
+    static inline std::unique_ptr<FileFingerprintDB> s_pFileFingerprintDBInstance = nullptr;
+
+private:
+    fs::path m_dbFilepath;
+
+    // StrID ids are hashes of the path strings, so they stay valid between runs
+    ds::FlatHashMap<ds::StrID::IdType, FileFingerprint, FingerprintKeyHasher> m_fingerprints;
+    mutable std::mutex m_fingerprintsMutex;
+
+    bool m_isDirty = false;
+};
@@ -0,0 +1,165 @@
+#include "pch.h"
+
+#include "file_stream_reader.h"
+
+#include "utils/debug/assertion.h"
+
+
+FileStreamReader::~FileStreamReader()
+{
+    Close();
+}
+
+
+bool FileStreamReader::Open(const fs::path& filepath, size_t chunkSize, uint32_t buffersCount) noexcept
+{
+    AM_ASSERT(chunkSize > 0, "Stream chunk size must be greater than zero");
+    AM_ASSERT(buffersCount > 0, "Stream buffers count must be greater than zero");
+
+    Close();
+
+    m_file.open(filepath, std::ios_base::binary | std::ios_base::ate);
+    if (!m_file.is_open()) {
+        AM_LOG_WARN("File streaming error. Failed to open {} file.", filepath.string().c_str());
+        return false;
+    }
+
+    m_fileSize = static_cast<uint64_t>(m_file.tellg());
+    m_file.seekg(0);
+
+    // There is no point to allocate more buffers than the file has chunks
+    const uint64_t chunksCount = (m_fileSize + chunkSize - 1) / chunkSize;
+    buffersCount = static_cast<uint32_t>(std::clamp<uint64_t>(chunksCount, 1, buffersCount));
+
+    m_chunkSize = chunkSize;
+    m_buffersStorage.resize(m_chunkSize * buffersCount);
+
+    m_freeBufferIndices.reserve(buffersCount);
+    for (uint32_t i = 0; i < buffersCount; ++i) {
+        m_freeBufferIndices.push_back(i);
+    }
+
+    m_reader = std::thread(&FileStreamReader::RunReader, this);
+
+    return true;
+}
+
+
+void FileStreamReader::Close() noexcept
+{
+    if (m_reader.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_chunksMutex);
+            m_isStopRequested = true;
+        }
+
+        m_freeBufferCV.notify_all();
+        m_reader.join();
+    }
+
+    m_file.close();
+    m_file.clear();
+    m_fileSize = 0;
+
+    m_buffersStorage.clear();
+    m_buffersStorage.shrink_to_fit();
+    m_chunkSize = 0;
+
+    m_readChunks.clear();
+    m_freeBufferIndices.clear();
+    m_acquiredBufferIdx = INVALID_BUFFER_IDX;
+    m_chunkOffset = 0;
+
+    m_isReadFinished = false;
+    m_hasFailed = false;
+    m_isStopRequested = false;
+}
+
+
+FileView FileStreamReader::ReadNextChunk() noexcept
+{
+    AM_ASSERT(IsOpened(), "FileStreamReader is not opened");
+
+    std::unique_lock<std::mutex> lock(m_chunksMutex);
+
+    if (m_acquiredBufferIdx != INVALID_BUFFER_IDX) {
+        m_freeBufferIndices.push_back(m_acquiredBufferIdx);
+        m_acquiredBufferIdx = INVALID_BUFFER_IDX;
+
+        m_freeBufferCV.notify_one();
+    }
+
+    m_readChunkCV.wait(lock, [this]() { return !m_readChunks.empty() || m_isReadFinished; });
+
+    if (m_readChunks.empty()) {
+        return FileView();
+    }
+
+    const Chunk chunk = m_readChunks.front();
+    m_readChunks.pop_front();
+
+    m_acquiredBufferIdx = chunk.bufferIdx;
+    m_chunkOffset = chunk.offset;
+
+    return FileView(GetBuffer(chunk.bufferIdx), chunk.size);
+}
+
+
+bool FileStreamReader::HasFailed() const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_chunksMutex);
+    return m_hasFailed;
+}
+
+
+void FileStreamReader::RunReader() noexcept
+{
+    uint64_t offset = 0;
+
+    while (true) {
+        uint32_t bufferIdx = INVALID_BUFFER_IDX;
+
+        {
+            std::unique_lock<std::mutex> lock(m_chunksMutex);
+            m_freeBufferCV.wait(lock, [this]() { return m_isStopRequested || !m_freeBufferIndices.empty(); });
+
+            if (m_isStopRequested) {
+                return;
+            }
+
+            bufferIdx = m_freeBufferIndices.back();
+            m_freeBufferIndices.pop_back();
+        }
+
+        // The file stream is touched only by this thread until Close joins it, so reading doesn't need the lock
+        const size_t sizeToRead = static_cast<size_t>(std::min<uint64_t>(m_chunkSize, m_fileSize - offset));
+
+        if (sizeToRead > 0) {
+            m_file.read(reinterpret_cast<char*>(GetBuffer(bufferIdx)), static_cast<std::streamsize>(sizeToRead));
+        }
+
+        const bool isReadFailed = static_cast<size_t>(m_file.gcount()) != sizeToRead;
+        const bool isLastChunk = offset + sizeToRead >= m_fileSize;
+
+        {
+            std::lock_guard<std::mutex> lock(m_chunksMutex);
+
+            if (sizeToRead > 0 && !isReadFailed) {
+                m_readChunks.push_back(Chunk{ offset, sizeToRead, bufferIdx });
+            } else {
+                m_freeBufferIndices.push_back(bufferIdx);
+            }
+
+            m_hasFailed = isReadFailed;
+            m_isReadFinished = isReadFailed || isLastChunk;
+        }
+
+        m_readChunkCV.notify_one();
+
+        if (isReadFailed || isLastChunk) {
+            return;
+        }
+
+        offset += sizeToRead;
+    }
+}
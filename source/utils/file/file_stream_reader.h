@@ -0,0 +1,91 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <cstdint>
+
+#include "mapped_file.h"
+
+#include "path_system/path_system.h"
+
+
+// Reads a file from begin to end in fixed-size chunks. A read-ahead thread fills a small ring of reusable chunk buffers
+// while the consumer processes already read chunks, so peak memory is chunkSize * buffersCount regardless of the file size
+// and decoding overlaps with IO. Single consumer only
+class FileStreamReader
+{
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 1 << 20;
+    static constexpr uint32_t DEFAULT_BUFFERS_COUNT = 3;
+
+public:
+    FileStreamReader() = default;
+    ~FileStreamReader();
+
+    FileStreamReader(const FileStreamReader& reader) = delete;
+    FileStreamReader& operator=(const FileStreamReader& reader) = delete;
+
+    FileStreamReader(FileStreamReader&& reader) = delete;
+    FileStreamReader& operator=(FileStreamReader&& reader) = delete;
+
+    // buffersCount includes the chunk held by the consumer, so at least 2 buffers are needed to read ahead
+    bool Open(const fs::path& filepath, size_t chunkSize = DEFAULT_CHUNK_SIZE, uint32_t buffersCount = DEFAULT_BUFFERS_COUNT) noexcept;
+    void Close() noexcept;
+
+    bool IsOpened() const noexcept { return m_reader.joinable(); }
+
+    // Blocks until the next chunk is read. The view is valid until the next ReadNextChunk or Close call.
+    // Returns empty view when the whole file is read or reading failed, use HasFailed to tell them apart
+    FileView ReadNextChunk() noexcept;
+
+    bool HasFailed() const noexcept;
+
+    uint64_t GetFileSize() const noexcept { return m_fileSize; }
+
+    // File offset of the chunk returned by the last ReadNextChunk call
+    uint64_t GetChunkOffset() const noexcept { return m_chunkOffset; }
+
+private:
+    struct Chunk
+    {
+        uint64_t offset;
+        size_t size;
+        uint32_t bufferIdx;
+    };
+
+private:
+    void RunReader() noexcept;
+
+    uint8_t* GetBuffer(uint32_t bufferIdx) noexcept { return m_buffersStorage.data() + bufferIdx * m_chunkSize; }
+
+private:
+    static constexpr uint32_t INVALID_BUFFER_IDX = UINT32_MAX;
+
+private:
+    std::thread m_reader;
+
+    std::ifstream m_file;
+    uint64_t m_fileSize = 0;
+
+    std::vector<uint8_t> m_buffersStorage;
+    size_t m_chunkSize = 0;
+
+    std::deque<Chunk> m_readChunks;
+    std::vector<uint32_t> m_freeBufferIndices;
+    uint32_t m_acquiredBufferIdx = INVALID_BUFFER_IDX;
+    uint64_t m_chunkOffset = 0;
+
+    mutable std::mutex m_chunksMutex;
+    std::condition_variable m_readChunkCV;
+    std::condition_variable m_freeBufferCV;
+
+    bool m_isReadFinished = false;
+    bool m_hasFailed = false;
+    bool m_isStopRequested = false;
+};
@@ -0,0 +1,123 @@
+#include "pch.h"
+
+#include "file_watcher.h"
+
+#include "utils/debug/assertion.h"
+
+
+FileWatcher::~FileWatcher()
+{
+    Stop();
+}
+
+
+bool FileWatcher::Start(uint32_t pollIntervalMs) noexcept
+{
+    AM_ASSERT(pollIntervalMs > 0, "File watcher poll interval must be greater than zero");
+
+    if (IsStarted()) {
+        AM_LOG_WARN("File watcher is already started");
+        return true;
+    }
+
+    m_pollIntervalMs = pollIntervalMs;
+    m_isStopRequested = false;
+
+    m_watcher = std::thread(&FileWatcher::RunWatcher, this);
+
+    return true;
+}
+
+
+void FileWatcher::Stop() noexcept
+{
+    if (!m_watcher.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_filesMutex);
+        m_isStopRequested = true;
+    }
+
+    m_stopCV.notify_all();
+    m_watcher.join();
+}
+
+
+void FileWatcher::AddFile(const fs::path& filepath) noexcept
+{
+    WatchedFile file = {};
+    file.filepath = filepath;
+    file.stat = QueryFileStat(filepath).value_or(FileStat());
+    file.pendingStat = file.stat;
+    file.isChanged = false;
+
+    std::lock_guard<std::mutex> lock(m_filesMutex);
+    m_files.emplace_back(std::move(file));
+}
+
+
+std::vector<fs::path> FileWatcher::TakeChangedFiles() noexcept
+{
+    std::vector<fs::path> changedFiles;
+
+    std::lock_guard<std::mutex> lock(m_filesMutex);
+
+    for (WatchedFile& file : m_files) {
+        if (file.isChanged) {
+            changedFiles.emplace_back(file.filepath);
+            file.isChanged = false;
+        }
+    }
+
+    m_hasChangedFiles.store(false, std::memory_order_release);
+
+    return changedFiles;
+}
+
+
+void FileWatcher::RunWatcher() noexcept
+{
+    std::unique_lock<std::mutex> lock(m_filesMutex);
+
+    while (true) {
+        m_stopCV.wait_for(lock, std::chrono::milliseconds(m_pollIntervalMs), [this]() { return m_isStopRequested; });
+
+        if (m_isStopRequested) {
+            break;
+        }
+
+        PollFiles();
+    }
+}
+
+
+void FileWatcher::PollFiles() noexcept
+{
+    bool hasChangedFiles = false;
+
+    for (WatchedFile& file : m_files) {
+        // Missing file keeps its last stat, so it's reported when it's written again
+        const std::optional<FileStat> stat = QueryFileStat(file.filepath);
+
+        if (!stat.has_value() || stat.value() == file.stat) {
+            file.pendingStat = file.stat;
+            continue;
+        }
+
+        if (stat.value() != file.pendingStat) {
+            file.pendingStat = stat.value();
+            continue;
+        }
+
+        file.stat = stat.value();
+        file.isChanged = true;
+
+        hasChangedFiles = true;
+    }
+
+    if (hasChangedFiles) {
+        m_hasChangedFiles.store(true, std::memory_order_release);
+    }
+}
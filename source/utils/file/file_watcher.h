@@ -0,0 +1,76 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include <cstdint>
+
+#include "file_fingerprint_db.h"
+
+#include "path_system/path_system.h"
+
+
+// Watches files for edits by polling their stats on a background thread. A change is reported once the file stat stays
+// the same for a whole poll interval, so files which are still being written aren't picked up. Removed files aren't reported,
+// which makes temp file + rename saves look like a single edit. Changes are accumulated until the owner takes them,
+// so they can be applied at a convenient point, e.g. a frame boundary
+class FileWatcher
+{
+public:
+    static constexpr uint32_t DEFAULT_POLL_INTERVAL_MS = 250;
+
+public:
+    FileWatcher() = default;
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher& watcher) = delete;
+    FileWatcher& operator=(const FileWatcher& watcher) = delete;
+
+    FileWatcher(FileWatcher&& watcher) = delete;
+    FileWatcher& operator=(FileWatcher&& watcher) = delete;
+
+    bool Start(uint32_t pollIntervalMs = DEFAULT_POLL_INTERVAL_MS) noexcept;
+    void Stop() noexcept;
+
+    bool IsStarted() const noexcept { return m_watcher.joinable(); }
+
+    // Current file stat is the baseline, so only further edits are reported. Can be called before or after Start
+    void AddFile(const fs::path& filepath) noexcept;
+
+    // Cheap enough to be called every frame
+    bool HasChangedFiles() const noexcept { return m_hasChangedFiles.load(std::memory_order_acquire); }
+
+    // Returns files changed since the previous call
+    std::vector<fs::path> TakeChangedFiles() noexcept;
+
+private:
+    struct WatchedFile
+    {
+        fs::path filepath;
+        FileStat stat;
+        FileStat pendingStat;
+        bool isChanged;
+    };
+
+private:
+    void RunWatcher() noexcept;
+
+    // Expects m_filesMutex to be locked
+    void PollFiles() noexcept;
+
+private:
+    std::thread m_watcher;
+
+    std::vector<WatchedFile> m_files;
+    uint32_t m_pollIntervalMs = DEFAULT_POLL_INTERVAL_MS;
+
+    mutable std::mutex m_filesMutex;
+    std::condition_variable m_stopCV;
+
+    std::atomic<bool> m_hasChangedFiles = false;
+    bool m_isStopRequested = false;
+};
@@ -0,0 +1,184 @@
+#include "pch.h"
+
+#include "mapped_file.h"
+
+#include "utils/debug/assertion.h"
+
+#if !defined(AM_OS_WINDOWS)
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+
+MappedFile::MappedFile(MappedFile&& file) noexcept
+    : m_pData(file.m_pData), m_size(file.m_size), m_pFileHandle(file.m_pFileHandle), m_pMappingHandle(file.m_pMappingHandle)
+{
+    file.m_pData = nullptr;
+    file.m_size = 0;
+    file.m_pFileHandle = nullptr;
+    file.m_pMappingHandle = nullptr;
+}
+
+
+MappedFile& MappedFile::operator=(MappedFile&& file) noexcept
+{
+    if (this != &file) {
+        Close();
+
+        std::swap(m_pData, file.m_pData);
+        std::swap(m_size, file.m_size);
+        std::swap(m_pFileHandle, file.m_pFileHandle);
+        std::swap(m_pMappingHandle, file.m_pMappingHandle);
+    }
+
+    return *this;
+}
+
+
+#if defined(AM_OS_WINDOWS)
+static DWORD GetFileAccessFlags(MappedFileAccess access) noexcept
+{
+    switch (access) {
+        case MAPPED_FILE_ACCESS_SEQUENTIAL: return FILE_FLAG_SEQUENTIAL_SCAN;
+        case MAPPED_FILE_ACCESS_RANDOM:     return FILE_FLAG_RANDOM_ACCESS;
+        default:                            return FILE_ATTRIBUTE_NORMAL;
+    }
+}
+
+
+bool MappedFile::Open(const fs::path& filepath, MappedFileAccess access) noexcept
+{
+    Close();
+
+    HANDLE fileHandle = CreateFileW(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, GetFileAccessFlags(access), nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        AM_LOG_WARN("File mapping error. Failed to open {} file.", filepath.string().c_str());
+        return false;
+    }
+
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+        AM_LOG_WARN("File mapping error. {} file is empty or its size can't be queried.", filepath.string().c_str());
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr) {
+        AM_LOG_WARN("File mapping error. Failed to create {} file mapping.", filepath.string().c_str());
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    const void* pData = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (pData == nullptr) {
+        AM_LOG_WARN("File mapping error. Failed to map {} file view.", filepath.string().c_str());
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    m_pData = static_cast<const uint8_t*>(pData);
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+    m_pFileHandle = fileHandle;
+    m_pMappingHandle = mappingHandle;
+
+    // Mapped views don't read ahead on page faults, so the whole sequentially read file is requested at once
+    if (access == MAPPED_FILE_ACCESS_SEQUENTIAL) {
+        WIN32_MEMORY_RANGE_ENTRY range = {};
+        range.VirtualAddress = const_cast<void*>(pData);
+        range.NumberOfBytes = m_size;
+
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+
+    return true;
+}
+
+
+void MappedFile::Close() noexcept
+{
+    if (m_pData) {
+        UnmapViewOfFile(m_pData);
+    }
+
+    if (m_pMappingHandle) {
+        CloseHandle(static_cast<HANDLE>(m_pMappingHandle));
+    }
+
+    if (m_pFileHandle) {
+        CloseHandle(static_cast<HANDLE>(m_pFileHandle));
+    }
+
+    m_pData = nullptr;
+    m_size = 0;
+    m_pFileHandle = nullptr;
+    m_pMappingHandle = nullptr;
+}
+#else
+static int GetMemoryAdvice(MappedFileAccess access) noexcept
+{
+    switch (access) {
+        case MAPPED_FILE_ACCESS_SEQUENTIAL: return MADV_SEQUENTIAL;
+        case MAPPED_FILE_ACCESS_RANDOM:     return MADV_RANDOM;
+        default:                            return MADV_NORMAL;
+    }
+}
+
+
+bool MappedFile::Open(const fs::path& filepath, MappedFileAccess access) noexcept
+{
+    Close();
+
+    const int fileDescriptor = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fileDescriptor < 0) {
+        AM_LOG_WARN("File mapping error. Failed to open {} file.", filepath.string().c_str());
+        return false;
+    }
+
+    struct stat fileStat = {};
+    if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0) {
+        AM_LOG_WARN("File mapping error. {} file is empty or its size can't be queried.", filepath.string().c_str());
+        close(fileDescriptor);
+        return false;
+    }
+
+    const size_t fileSize = static_cast<size_t>(fileStat.st_size);
+
+    void* pData = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    close(fileDescriptor);
+
+    if (pData == MAP_FAILED) {
+        AM_LOG_WARN("File mapping error. Failed to map {} file view.", filepath.string().c_str());
+        return false;
+    }
+
+    madvise(pData, fileSize, GetMemoryAdvice(access));
+
+    m_pData = static_cast<const uint8_t*>(pData);
+    m_size = fileSize;
+
+    return true;
+}
+
+
+void MappedFile::Close() noexcept
+{
+    if (m_pData) {
+        munmap(const_cast<uint8_t*>(m_pData), m_size);
+    }
+
+    m_pData = nullptr;
+    m_size = 0;
+    m_pFileHandle = nullptr;
+    m_pMappingHandle = nullptr;
+}
+#endif
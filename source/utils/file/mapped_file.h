@@ -0,0 +1,77 @@
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+
+#include <cstdint>
+
+#include "path_system/path_system.h"
+
+
+enum MappedFileAccess
+{
+    MAPPED_FILE_ACCESS_DEFAULT,
+    MAPPED_FILE_ACCESS_SEQUENTIAL,  // File is read once from begin to end, pages are read ahead aggressively
+    MAPPED_FILE_ACCESS_RANDOM,      // Read ahead is disabled, only touched pages are read
+    MAPPED_FILE_ACCESS_COUNT
+};
+
+
+// Read-only span-like view of file content. Doesn't own the memory
+class FileView
+{
+public:
+    FileView() = default;
+    FileView(const uint8_t* pData, size_t size) noexcept
+        : m_pData(pData), m_size(size) {}
+
+    const uint8_t* begin() const noexcept { return m_pData; }
+    const uint8_t* end() const noexcept { return m_pData + m_size; }
+
+    const uint8_t* data() const noexcept { return m_pData; }
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    const uint8_t& operator[](size_t idx) const noexcept { return m_pData[idx]; }
+
+    // Content isn't null-terminated
+    std::string_view AsText() const noexcept { return std::string_view(reinterpret_cast<const char*>(m_pData), m_size); }
+
+private:
+    const uint8_t* m_pData = nullptr;
+    size_t m_size = 0;
+};
+
+
+// Read-only memory mapping of a whole file. Pages are read on first access, so opening doesn't copy the content
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile& file) = delete;
+    MappedFile& operator=(const MappedFile& file) = delete;
+
+    MappedFile(MappedFile&& file) noexcept;
+    MappedFile& operator=(MappedFile&& file) noexcept;
+
+    // Empty files can't be mapped, so Open fails for them
+    bool Open(const fs::path& filepath, MappedFileAccess access = MAPPED_FILE_ACCESS_DEFAULT) noexcept;
+    void Close() noexcept;
+
+    bool IsOpened() const noexcept { return m_pData != nullptr; }
+
+    const uint8_t* GetData() const noexcept { return m_pData; }
+    size_t GetSize() const noexcept { return m_size; }
+
+    FileView GetView() const noexcept { return FileView(m_pData, m_size); }
+
+private:
+    const uint8_t* m_pData = nullptr;
+    size_t m_size = 0;
+
+    // Mapping keeps the file referenced on POSIX systems, so handles are only kept on Windows
+    void* m_pFileHandle = nullptr;
+    void* m_pMappingHandle = nullptr;
+};
@@ -0,0 +1,408 @@
+#include "pch.h"
+
+#include "pack_file.h"
+
+#include "utils/debug/assertion.h"
+
+
+static constexpr uint32_t AM_PACK_FILE_MAGIC   = 0x4B504D41; // 'AMPK'
+static constexpr uint32_t AM_PACK_FILE_VERSION = 1;
+
+// Keeps entries suitable for direct SIMD and uint32_t (SPIR-V) reads from the mapped archive
+static constexpr uint64_t AM_PACK_FILE_DATA_ALIGNMENT = 16;
+
+static constexpr size_t AM_LZ_MIN_MATCH_LENGTH = 4;
+static constexpr size_t AM_LZ_MAX_OFFSET       = UINT16_MAX;
+static constexpr size_t AM_LZ_HASH_TABLE_BITS  = 14;
+static constexpr uint8_t AM_LZ_LENGTH_MASK     = 0xF;
+
+
+struct PackFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t entriesCount;
+    uint64_t tocOffset;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+};
+
+
+static_assert(sizeof(PackFileEntry) == 64, "Pack file entry layout changed, update AM_PACK_FILE_VERSION");
+
+
+static uint64_t AlignPackFileOffset(uint64_t offset, uint64_t alignment) noexcept
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+
+static uint64_t HashPackFileEntryName(std::string_view name) noexcept
+{
+    return amHashMem(name.data(), name.size());
+}
+
+
+// LZ block is a sequence of (token, literals, offset, match) groups. Token keeps 4-bit literals length and 4-bit match length,
+// lengths which don't fit are continued with 255-valued bytes. The last group has literals only
+static void WriteLZLengthTail(std::vector<uint8_t>& outData, size_t length) noexcept
+{
+    if (length < AM_LZ_LENGTH_MASK) {
+        return;
+    }
+
+    length -= AM_LZ_LENGTH_MASK;
+
+    for (; length >= UINT8_MAX; length -= UINT8_MAX) {
+        outData.emplace_back(UINT8_MAX);
+    }
+
+    outData.emplace_back(static_cast<uint8_t>(length));
+}
+
+
+static void WriteLZSequence(std::vector<uint8_t>& outData, const uint8_t* pLiterals, size_t literalsLength, size_t offset, size_t matchLength) noexcept
+{
+    const size_t matchLengthCode = matchLength != 0 ? matchLength - AM_LZ_MIN_MATCH_LENGTH : 0;
+
+    const uint8_t token = static_cast<uint8_t>((std::min<size_t>(literalsLength, AM_LZ_LENGTH_MASK) << 4) | std::min<size_t>(matchLengthCode, AM_LZ_LENGTH_MASK));
+    outData.emplace_back(token);
+
+    WriteLZLengthTail(outData, literalsLength);
+    outData.insert(outData.end(), pLiterals, pLiterals + literalsLength);
+
+    if (matchLength == 0) {
+        return;
+    }
+
+    outData.emplace_back(static_cast<uint8_t>(offset));
+    outData.emplace_back(static_cast<uint8_t>(offset >> 8));
+
+    WriteLZLengthTail(outData, matchLengthCode);
+}
+
+
+static std::vector<uint8_t> CompressLZ(const uint8_t* pData, size_t size) noexcept
+{
+    std::vector<uint8_t> compressedData;
+    compressedData.reserve(size + size / UINT8_MAX + 16);
+
+    // Positions are stored +1, so zero means an empty slot
+    std::vector<uint32_t> hashTable(1ull << AM_LZ_HASH_TABLE_BITS, 0);
+
+    size_t anchor = 0;
+    size_t pos = 0;
+
+    while (pos + AM_LZ_MIN_MATCH_LENGTH <= size) {
+        uint32_t sequence = 0;
+        memcpy(&sequence, pData + pos, sizeof(sequence));
+
+        const uint32_t hash = (sequence * 2654435761u) >> (32 - AM_LZ_HASH_TABLE_BITS);
+        const size_t candidate = hashTable[hash];
+
+        hashTable[hash] = static_cast<uint32_t>(pos + 1);
+
+        if (candidate == 0 || pos - (candidate - 1) > AM_LZ_MAX_OFFSET || memcmp(pData + candidate - 1, pData + pos, AM_LZ_MIN_MATCH_LENGTH) != 0) {
+            ++pos;
+            continue;
+        }
+
+        const size_t matchPos = candidate - 1;
+        size_t matchLength = AM_LZ_MIN_MATCH_LENGTH;
+
+        while (pos + matchLength < size && pData[matchPos + matchLength] == pData[pos + matchLength]) {
+            ++matchLength;
+        }
+
+        WriteLZSequence(compressedData, pData + anchor, pos - anchor, pos - matchPos, matchLength);
+
+        pos += matchLength;
+        anchor = pos;
+    }
+
+    WriteLZSequence(compressedData, pData + anchor, size - anchor, 0, 0);
+
+    return compressedData;
+}
+
+
+static bool ReadLZLengthTail(const uint8_t*& pCurr, const uint8_t* pEnd, size_t& length) noexcept
+{
+    if (length != AM_LZ_LENGTH_MASK) {
+        return true;
+    }
+
+    uint8_t byte = UINT8_MAX;
+
+    while (byte == UINT8_MAX) {
+        if (pCurr == pEnd) {
+            return false;
+        }
+
+        byte = *pCurr++;
+        length += byte;
+    }
+
+    return true;
+}
+
+
+static bool DecompressLZ(const uint8_t* pData, size_t size, uint8_t* pOutData, size_t outSize) noexcept
+{
+    const uint8_t* pCurr = pData;
+    const uint8_t* pEnd = pData + size;
+
+    uint8_t* pOut = pOutData;
+    uint8_t* pOutEnd = pOutData + outSize;
+
+    while (pCurr < pEnd) {
+        const uint8_t token = *pCurr++;
+
+        size_t literalsLength = token >> 4;
+        if (!ReadLZLengthTail(pCurr, pEnd, literalsLength) || literalsLength > size_t(pEnd - pCurr) || literalsLength > size_t(pOutEnd - pOut)) {
+            return false;
+        }
+
+        memcpy(pOut, pCurr, literalsLength);
+        pCurr += literalsLength;
+        pOut += literalsLength;
+
+        if (pCurr == pEnd) {
+            break;
+        }
+
+        if (pEnd - pCurr < 2) {
+            return false;
+        }
+
+        const size_t offset = size_t(pCurr[0]) | (size_t(pCurr[1]) << 8);
+        pCurr += 2;
+
+        size_t matchLength = token & AM_LZ_LENGTH_MASK;
+        if (!ReadLZLengthTail(pCurr, pEnd, matchLength)) {
+            return false;
+        }
+
+        matchLength += AM_LZ_MIN_MATCH_LENGTH;
+
+        if (offset == 0 || offset > size_t(pOut - pOutData) || matchLength > size_t(pOutEnd - pOut)) {
+            return false;
+        }
+
+        // Match may overlap the bytes it produces, so it's copied byte by byte
+        const uint8_t* pMatch = pOut - offset;
+
+        for (size_t i = 0; i < matchLength; ++i) {
+            pOut[i] = pMatch[i];
+        }
+
+        pOut += matchLength;
+    }
+
+    return pOut == pOutEnd;
+}
+
+
+void PackFileWriter::AddEntry(std::string_view name, const uint8_t* pData, size_t size, PackFileCompression compression) noexcept
+{
+    AM_ASSERT(pData || size == 0, "Pack file entry {} data is nullptr", std::string(name).c_str());
+    AM_ASSERT(compression < PACK_FILE_COMPRESSION_COUNT, "Invalid pack file entry {} compression", std::string(name).c_str());
+
+    PendingEntry& entry = m_entries.emplace_back();
+    entry.name = name;
+    entry.size = size;
+    entry.contentHash = amHashMem128(pData, size);
+    entry.compression = PACK_FILE_COMPRESSION_NONE;
+
+    // LZ match positions are 32-bit
+    if (compression == PACK_FILE_COMPRESSION_LZ && size != 0 && size < UINT32_MAX) {
+        std::vector<uint8_t> compressedData = CompressLZ(pData, size);
+
+        if (compressedData.size() < size) {
+            entry.data = std::move(compressedData);
+            entry.compression = PACK_FILE_COMPRESSION_LZ;
+            return;
+        }
+    }
+
+    entry.data.assign(pData, pData + size);
+}
+
+
+bool PackFileWriter::Write(const fs::path& filepath) const noexcept
+{
+    std::vector<PackFileEntry> toc(m_entries.size());
+    std::vector<uint8_t> buffer(sizeof(PackFileHeader));
+    std::string names;
+
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        const PendingEntry& pendingEntry = m_entries[i];
+
+        buffer.resize(AlignPackFileOffset(buffer.size(), AM_PACK_FILE_DATA_ALIGNMENT));
+
+        PackFileEntry& entry = toc[i];
+        entry.nameHash    = HashPackFileEntryName(pendingEntry.name);
+        entry.dataOffset  = buffer.size();
+        entry.storedSize  = pendingEntry.data.size();
+        entry.size        = pendingEntry.size;
+        entry.contentHash = pendingEntry.contentHash;
+        entry.nameOffset  = static_cast<uint32_t>(names.size());
+        entry.nameLength  = static_cast<uint32_t>(pendingEntry.name.size());
+        entry.compression = pendingEntry.compression;
+        entry.reserved    = 0;
+
+        buffer.insert(buffer.end(), pendingEntry.data.begin(), pendingEntry.data.end());
+        names += pendingEntry.name;
+    }
+
+    std::sort(toc.begin(), toc.end(), [](const PackFileEntry& left, const PackFileEntry& right) { return left.nameHash < right.nameHash; });
+
+    PackFileHeader header = {};
+    header.magic        = AM_PACK_FILE_MAGIC;
+    header.version      = AM_PACK_FILE_VERSION;
+    header.entriesCount = toc.size();
+    header.tocOffset    = AlignPackFileOffset(buffer.size(), alignof(PackFileEntry));
+    header.namesOffset  = header.tocOffset + toc.size() * sizeof(PackFileEntry);
+    header.namesSize    = names.size();
+
+    buffer.resize(header.tocOffset);
+    buffer.insert(buffer.end(), reinterpret_cast<const uint8_t*>(toc.data()), reinterpret_cast<const uint8_t*>(toc.data() + toc.size()));
+    buffer.insert(buffer.end(), names.begin(), names.end());
+
+    memcpy_s(buffer.data(), buffer.size(), &header, sizeof(header));
+
+    std::ofstream file(filepath, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file.is_open()) {
+        AM_LOG_WARN("Pack file writing error. Failed to open {} file.", filepath.string().c_str());
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+
+    if (file.fail()) {
+        AM_LOG_WARN("Pack file writing error. Failed to write {} file.", filepath.string().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+
+bool PackFile::Open(const fs::path& filepath) noexcept
+{
+    Close();
+
+    if (!m_file.Open(filepath, MAPPED_FILE_ACCESS_RANDOM)) {
+        return false;
+    }
+
+    const uint8_t* pData = m_file.GetData();
+    const uint64_t size = m_file.GetSize();
+
+    const auto FailOpening = [this, &filepath]() -> bool
+    {
+        AM_LOG_WARN("Pack file {} is outdated or corrupted", filepath.string().c_str());
+        Close();
+        return false;
+    };
+
+    if (size < sizeof(PackFileHeader)) {
+        return FailOpening();
+    }
+
+    PackFileHeader header = {};
+    memcpy_s(&header, sizeof(header), pData, sizeof(header));
+
+    if (header.magic != AM_PACK_FILE_MAGIC || header.version != AM_PACK_FILE_VERSION) {
+        return FailOpening();
+    }
+
+    if (header.tocOffset % alignof(PackFileEntry) != 0 || header.tocOffset > size || header.entriesCount > (size - header.tocOffset) / sizeof(PackFileEntry) ||
+        header.namesOffset != header.tocOffset + header.entriesCount * sizeof(PackFileEntry) || header.namesSize > size - header.namesOffset) {
+        return FailOpening();
+    }
+
+    m_pEntries = reinterpret_cast<const PackFileEntry*>(pData + header.tocOffset);
+    m_entriesCount = header.entriesCount;
+    m_pNames = reinterpret_cast<const char*>(pData + header.namesOffset);
+    m_namesSize = header.namesSize;
+
+    // Everything is validated once, so lookups and reads don't need bounds checks
+    for (const PackFileEntry& entry : *this) {
+        const bool isDataValid = entry.dataOffset <= header.tocOffset && entry.storedSize <= header.tocOffset - entry.dataOffset;
+        const bool isNameValid = uint64_t(entry.nameOffset) + entry.nameLength <= m_namesSize;
+        const bool isCompressionValid = entry.compression < PACK_FILE_COMPRESSION_COUNT &&
+            (entry.compression != PACK_FILE_COMPRESSION_NONE || entry.storedSize == entry.size);
+
+        if (!isDataValid || !isNameValid || !isCompressionValid) {
+            return FailOpening();
+        }
+    }
+
+    return true;
+}
+
+
+void PackFile::Close() noexcept
+{
+    m_file.Close();
+
+    m_pEntries = nullptr;
+    m_entriesCount = 0;
+    m_pNames = nullptr;
+    m_namesSize = 0;
+}
+
+
+const PackFileEntry* PackFile::FindEntry(std::string_view name) const noexcept
+{
+    const uint64_t nameHash = HashPackFileEntryName(name);
+
+    const PackFileEntry* pEntry = std::lower_bound(begin(), end(), nameHash,
+        [](const PackFileEntry& entry, uint64_t hash) { return entry.nameHash < hash; });
+
+    for (; pEntry != end() && pEntry->nameHash == nameHash; ++pEntry) {
+        if (GetEntryName(*pEntry) == name) {
+            return pEntry;
+        }
+    }
+
+    return nullptr;
+}
+
+
+std::optional<FileView> PackFile::GetEntryView(const PackFileEntry& entry) const noexcept
+{
+    if (entry.compression != PACK_FILE_COMPRESSION_NONE) {
+        return std::nullopt;
+    }
+
+    return FileView(m_file.GetData() + entry.dataOffset, entry.size);
+}
+
+
+bool PackFile::ReadEntry(const PackFileEntry& entry, std::vector<uint8_t>& outData) const noexcept
+{
+    const uint8_t* pStoredData = m_file.GetData() + entry.dataOffset;
+
+    if (entry.compression == PACK_FILE_COMPRESSION_NONE) {
+        outData.assign(pStoredData, pStoredData + entry.size);
+        return true;
+    }
+
+    outData.resize(entry.size);
+
+    if (!DecompressLZ(pStoredData, entry.storedSize, outData.data(), outData.size())) {
+        AM_LOG_WARN("Pack file entry {} is corrupted", std::string(GetEntryName(entry)).c_str());
+        outData.clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+std::string_view PackFile::GetEntryName(const PackFileEntry& entry) const noexcept
+{
+    return std::string_view(m_pNames + entry.nameOffset, entry.nameLength);
+}
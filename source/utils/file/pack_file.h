@@ -0,0 +1,102 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+
+#include <cstdint>
+
+#include "mapped_file.h"
+
+#include "path_system/path_system.h"
+#include "utils/data_structures/hash.h"
+
+
+enum PackFileCompression
+{
+    PACK_FILE_COMPRESSION_NONE,
+    PACK_FILE_COMPRESSION_LZ,   // Byte-oriented LZ77 blocks, decompression is a memcpy-bound loop
+    PACK_FILE_COMPRESSION_COUNT
+};
+
+
+struct PackFileEntry
+{
+    uint64_t    nameHash;
+    uint64_t    dataOffset;
+    uint64_t    storedSize;
+    uint64_t    size;
+    ds::Hash128 contentHash;    // amHashMem128 of the uncompressed content
+    uint32_t    nameOffset;
+    uint32_t    nameLength;
+    uint32_t    compression;
+    uint32_t    reserved;
+};
+
+
+// Builds a pack file in memory. Entry names are virtual paths ("source/shaders/base/base.vert"), see VirtualFileSystem
+class PackFileWriter
+{
+public:
+    // Compression is kept only for entries which become smaller
+    void AddEntry(std::string_view name, const uint8_t* pData, size_t size, PackFileCompression compression = PACK_FILE_COMPRESSION_NONE) noexcept;
+
+    bool Write(const fs::path& filepath) const noexcept;
+
+    size_t GetEntriesCount() const noexcept { return m_entries.size(); }
+
+private:
+    struct PendingEntry
+    {
+        std::string name;
+        std::vector<uint8_t> data;
+        uint64_t size;
+        ds::Hash128 contentHash;
+        PackFileCompression compression;
+    };
+
+private:
+    std::vector<PendingEntry> m_entries;
+};
+
+
+// Read-only pack file. The whole archive is memory mapped once and the table of contents is sorted by name hash,
+// so a lookup is a binary search without any system calls and uncompressed entries are read without copying.
+//
+// Pack file structure:
+//      Header (PackFileHeader)
+//      Entries data, every entry is aligned to AM_PACK_FILE_DATA_ALIGNMENT
+//      Table of contents (PackFileEntry array sorted by name hash)
+//      Entry names (not null-terminated)
+class PackFile
+{
+public:
+    bool Open(const fs::path& filepath) noexcept;
+    void Close() noexcept;
+
+    bool IsOpened() const noexcept { return m_file.IsOpened(); }
+
+    const PackFileEntry* FindEntry(std::string_view name) const noexcept;
+
+    // Uncompressed entries only, the view points to the mapped archive
+    std::optional<FileView> GetEntryView(const PackFileEntry& entry) const noexcept;
+    bool ReadEntry(const PackFileEntry& entry, std::vector<uint8_t>& outData) const noexcept;
+
+    std::string_view GetEntryName(const PackFileEntry& entry) const noexcept;
+
+    const PackFileEntry* begin() const noexcept { return m_pEntries; }
+    const PackFileEntry* end() const noexcept { return m_pEntries + m_entriesCount; }
+
+    size_t GetEntriesCount() const noexcept { return m_entriesCount; }
+
+private:
+    MappedFile m_file;
+
+    const PackFileEntry* m_pEntries = nullptr;
+    size_t m_entriesCount = 0;
+
+    const char* m_pNames = nullptr;
+    size_t m_namesSize = 0;
+};
@@ -0,0 +1,71 @@
+#include "pch.h"
+
+#include "strid_table_file.h"
+#include "mapped_file.h"
+#include "file.h"
+
+#include "utils/debug/assertion.h"
+#include "utils/data_structures/strid.h"
+
+
+static MappedFile s_strIDTableFile;
+
+
+static fs::path GetPendingStrIDTableFilepath(const fs::path& filepath) noexcept
+{
+    fs::path pendingFilepath = filepath;
+    pendingFilepath += ".pending";
+
+    return pendingFilepath;
+}
+
+
+bool LoadStrIDTable(const fs::path& filepath) noexcept
+{
+    AM_ASSERT(!s_strIDTableFile.IsOpened(), "StrID table is already loaded");
+
+    const fs::path pendingFilepath = GetPendingStrIDTableFilepath(filepath);
+
+    std::error_code error;
+    if (fs::exists(pendingFilepath, error)) {
+        fs::rename(pendingFilepath, filepath, error);
+
+        if (error) {
+            AM_LOG_WARN("Failed to replace StrID table {} with pending one: {}", filepath.string().c_str(), error.message().c_str());
+        }
+    }
+
+    if (!fs::exists(filepath, error)) {
+        return false;
+    }
+
+    if (!s_strIDTableFile.Open(filepath)) {
+        return false;
+    }
+
+    if (!ds::StrID::PreloadTable(s_strIDTableFile.GetData(), s_strIDTableFile.GetSize())) {
+        AM_LOG_WARN("StrID table {} is outdated or corrupted and will be rebuilt", filepath.string().c_str());
+        s_strIDTableFile.Close();
+        return false;
+    }
+
+    AM_LOG_INFO("Preloaded {} StrID strings from {}", ds::StrID::GetPreloadedTableEntriesCount(), filepath.string().c_str());
+
+    return true;
+}
+
+
+void StoreStrIDTable(const fs::path& filepath) noexcept
+{
+    const size_t internedCount = ds::StrID::GetInternedCount();
+
+    // Table is rewritten if new strings were interned or some preloaded ones weren't used, so it doesn't only grow
+    if (internedCount == ds::StrID::GetPreloadedTableEntriesCount() && internedCount == ds::StrID::GetUsedCount()) {
+        return;
+    }
+
+    const std::vector<uint8_t> tableData = ds::StrID::SerializeTable();
+
+    // Torn pending table would replace the valid one on the next load
+    WriteBinaryFileAtomic(GetPendingStrIDTableFilepath(filepath), tableData.data(), tableData.size());
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <filesystem>
+
+#include "path_system/path_system.h"
+
+
+// Maps the serialized StrID table and preloads it into StrID storage. The table stays mapped until process exit,
+// since preloaded strings aren't copied and point to the mapped memory
+bool LoadStrIDTable(const fs::path& filepath) noexcept;
+
+// Serializes the StrID table if new strings were interned or preloaded ones weren't used since it was loaded. Only strings
+// used during this run are stored. Mapped table can't be overwritten, so the new one is written next to it and replaces it
+// on the next LoadStrIDTable call
+void StoreStrIDTable(const fs::path& filepath) noexcept;
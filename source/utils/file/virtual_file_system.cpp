@@ -0,0 +1,245 @@
+#include "pch.h"
+
+#include "virtual_file_system.h"
+#include "file_fingerprint_db.h"
+#include "file.h"
+
+#include "utils/debug/assertion.h"
+#include "utils/data_structures/strid.h"
+
+
+// Returns root relative generic path or empty string if the filepath is outside of the root directory
+static std::string MakeVirtualPath(const fs::path& rootDir, const fs::path& filepath) noexcept
+{
+    const fs::path relativePath = filepath.lexically_normal().lexically_relative(rootDir);
+
+    if (relativePath.empty() || relativePath == "." || *relativePath.begin() == "..") {
+        return std::string();
+    }
+
+    return relativePath.generic_string();
+}
+
+
+VirtualFileSystem& VirtualFileSystem::Instance() noexcept
+{
+    AM_ASSERT(s_pVirtualFileSystemInstance != nullptr, "VirtualFileSystem is not initialized, call VirtualFileSystem::Init first");
+
+    return *s_pVirtualFileSystemInstance;
+}
+
+
+bool VirtualFileSystem::Init(const fs::path& rootDir) noexcept
+{
+    if (IsInitialized()) {
+        AM_LOG_WARN("VirtualFileSystem is already initialized");
+        return true;
+    }
+
+    s_pVirtualFileSystemInstance = std::unique_ptr<VirtualFileSystem>(new VirtualFileSystem(rootDir));
+    if (!s_pVirtualFileSystemInstance) {
+        AM_ASSERT_FAIL("Failed to allocate VirtualFileSystem");
+        return false;
+    }
+
+    return true;
+}
+
+
+void VirtualFileSystem::Terminate() noexcept
+{
+    s_pVirtualFileSystemInstance = nullptr;
+}
+
+
+bool VirtualFileSystem::BuildPack(const fs::path& packFilepath, const fs::path& rootDir, const std::vector<fs::path>& dirsToPack) noexcept
+{
+    const fs::path normalizedRootDir = rootDir.lexically_normal();
+
+    PackFileWriter writer;
+    std::vector<uint8_t> fileData;
+
+    for (const fs::path& dirpath : dirsToPack) {
+        ::ForEachFile(dirpath, [&](const fs::directory_entry& entry)
+        {
+            const std::string virtualPath = MakeVirtualPath(normalizedRootDir, entry.path());
+            AM_ASSERT(!virtualPath.empty(), "{} is outside of pack root directory {}", entry.path().string().c_str(), rootDir.string().c_str());
+
+            fileData.clear();
+            ReadBinaryFile(entry.path(), fileData);
+
+            writer.AddEntry(virtualPath, fileData.data(), fileData.size(), PACK_FILE_COMPRESSION_LZ);
+        });
+    }
+
+    if (!writer.Write(packFilepath)) {
+        return false;
+    }
+
+    AM_LOG_INFO("Packed {} files into {}", writer.GetEntriesCount(), packFilepath.string().c_str());
+
+    return true;
+}
+
+
+bool VirtualFileSystem::IsPackOutdated(const fs::path& packFilepath, const std::vector<fs::path>& dirsToPack) noexcept
+{
+    std::error_code error;
+
+    const fs::file_time_type packWriteTime = fs::last_write_time(packFilepath, error);
+    if (error) {
+        return true;
+    }
+
+    bool isOutdated = false;
+
+    for (const fs::path& dirpath : dirsToPack) {
+        ::ForEachFile(dirpath, [&](const fs::directory_entry& entry)
+        {
+            std::error_code entryError;
+            const fs::file_time_type fileWriteTime = entry.last_write_time(entryError);
+
+            if (!entryError && fileWriteTime > packWriteTime) {
+                AM_LOG_INFO("{} was changed after {} was built", entry.path().string().c_str(), packFilepath.string().c_str());
+                isOutdated = true;
+            }
+        });
+    }
+
+    return isOutdated;
+}
+
+
+VirtualFileSystem::VirtualFileSystem(const fs::path& rootDir)
+    : m_rootDir(rootDir.lexically_normal())
+{
+}
+
+
+bool VirtualFileSystem::Mount(const fs::path& packFilepath) noexcept
+{
+    if (!m_pack.Open(packFilepath)) {
+        AM_LOG_WARN("Failed to mount {} pack, loose files are used", packFilepath.string().c_str());
+        return false;
+    }
+
+    AM_LOG_INFO("Mounted {} pack with {} files", packFilepath.string().c_str(), m_pack.GetEntriesCount());
+
+    return true;
+}
+
+
+bool VirtualFileSystem::Open(const fs::path& filepath, VirtualFile& outFile, MappedFileAccess access) const noexcept
+{
+    outFile = VirtualFile();
+
+    if (const PackFileEntry* pEntry = FindPackEntry(filepath)) {
+        if (std::optional<FileView> view = m_pack.GetEntryView(*pEntry)) {
+            outFile.m_view = view.value();
+        } else if (m_pack.ReadEntry(*pEntry, outFile.m_buffer)) {
+            outFile.m_view = FileView(outFile.m_buffer.data(), outFile.m_buffer.size());
+        } else {
+            return false;
+        }
+
+        outFile.m_isOpened = true;
+        return true;
+    }
+
+    if (!outFile.m_mappedFile.Open(filepath, access)) {
+        return false;
+    }
+
+    outFile.m_view = outFile.m_mappedFile.GetView();
+    outFile.m_isOpened = true;
+
+    return true;
+}
+
+
+bool VirtualFileSystem::ReadFile(const fs::path& filepath, std::vector<uint8_t>& outData) const noexcept
+{
+    outData.clear();
+
+    if (const PackFileEntry* pEntry = FindPackEntry(filepath)) {
+        return m_pack.ReadEntry(*pEntry, outData);
+    }
+
+    std::error_code error;
+    if (!fs::exists(filepath, error)) {
+        return false;
+    }
+
+    ReadBinaryFile(filepath, outData);
+
+    return true;
+}
+
+
+bool VirtualFileSystem::Exists(const fs::path& filepath) const noexcept
+{
+    std::error_code error;
+    return FindPackEntry(filepath) != nullptr || fs::exists(filepath, error);
+}
+
+
+std::optional<ds::Hash128> VirtualFileSystem::GetContentHash(const fs::path& filepath) const noexcept
+{
+    if (const PackFileEntry* pEntry = FindPackEntry(filepath)) {
+        return pEntry->contentHash;
+    }
+
+    if (FileFingerprintDB::IsInitialized()) {
+        return FileFingerprintDB::Instance().GetContentHash(ds::StrID(filepath.string()));
+    }
+
+    return CalculateFileHash(filepath);
+}
+
+
+void VirtualFileSystem::ForEachFile(const fs::path& rootDir, const VirtualFileVisitor& func, uint32_t dirTreeDepth) const noexcept
+{
+    if (!IsPackMounted()) {
+        ::ForEachFile(rootDir, [&func](const fs::directory_entry& entry) { func(entry.path()); }, dirTreeDepth);
+        return;
+    }
+
+    std::string dirPrefix;
+
+    if (rootDir.lexically_normal() != m_rootDir) {
+        dirPrefix = MakeVirtualPath(m_rootDir, rootDir);
+
+        if (dirPrefix.empty()) {
+            return;
+        }
+
+        dirPrefix += '/';
+    }
+
+    for (const PackFileEntry& entry : m_pack) {
+        const std::string_view name = m_pack.GetEntryName(entry);
+
+        if (name.compare(0, dirPrefix.size(), dirPrefix) != 0) {
+            continue;
+        }
+
+        const std::string_view nameInDir = name.substr(dirPrefix.size());
+
+        if (std::count(nameInDir.begin(), nameInDir.end(), '/') > static_cast<ptrdiff_t>(dirTreeDepth)) {
+            continue;
+        }
+
+        func((m_rootDir / fs::path(name)).make_preferred());
+    }
+}
+
+
+const PackFileEntry* VirtualFileSystem::FindPackEntry(const fs::path& filepath) const noexcept
+{
+    if (!IsPackMounted()) {
+        return nullptr;
+    }
+
+    const std::string virtualPath = MakeVirtualPath(m_rootDir, filepath);
+    return virtualPath.empty() ? nullptr : m_pack.FindEntry(virtualPath);
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <optional>
+#include <functional>
+#include <memory>
+
+#include <cstdint>
+
+#include "mapped_file.h"
+#include "pack_file.h"
+
+#include "path_system/path_system.h"
+#include "utils/data_structures/hash.h"
+
+
+// Content of a file opened through VirtualFileSystem. Keeps the loose file mapping or the decompressed pack entry alive
+class VirtualFile
+{
+public:
+    VirtualFile() = default;
+
+    VirtualFile(const VirtualFile& file) = delete;
+    VirtualFile& operator=(const VirtualFile& file) = delete;
+
+    VirtualFile(VirtualFile&& file) noexcept = default;
+    VirtualFile& operator=(VirtualFile&& file) noexcept = default;
+
+    FileView GetView() const noexcept { return m_view; }
+
+    bool IsOpened() const noexcept { return m_isOpened; }
+
+private:
+    friend class VirtualFileSystem;
+
+    MappedFile m_mappedFile;
+    std::vector<uint8_t> m_buffer;
+    FileView m_view;
+
+    bool m_isOpened = false;
+};
+
+
+using VirtualFileVisitor = std::function<void(const fs::path& filepath)>;
+
+
+// Single entry point for reading project assets. Files are addressed by their regular paths, and paths under the root directory
+// are looked up in the mounted pack first (by root relative generic path), so callers don't depend on where the content lives.
+// Files which are absent in the pack are read from disk. Mounting isn't thread-safe, reading is
+class VirtualFileSystem
+{
+public:
+    static VirtualFileSystem& Instance() noexcept;
+
+    static bool Init(const fs::path& rootDir) noexcept;
+    static void Terminate() noexcept;
+
+    static bool IsInitialized() noexcept { return s_pVirtualFileSystemInstance != nullptr; }
+
+    // Packs all files of dirsToPack under their rootDir relative paths, so the pack can be mounted instead of the loose files
+    static bool BuildPack(const fs::path& packFilepath, const fs::path& rootDir, const std::vector<fs::path>& dirsToPack) noexcept;
+
+    // True if the pack is missing or any file of dirsToPack was written after it. Missing directories are ignored,
+    // so shipped builds without loose files keep using the pack
+    static bool IsPackOutdated(const fs::path& packFilepath, const std::vector<fs::path>& dirsToPack) noexcept;
+
+    VirtualFileSystem(const VirtualFileSystem& vfs) = delete;
+    VirtualFileSystem& operator=(const VirtualFileSystem& vfs) = delete;
+
+    VirtualFileSystem(VirtualFileSystem&& vfs) = delete;
+    VirtualFileSystem& operator=(VirtualFileSystem&& vfs) = delete;
+
+    bool Mount(const fs::path& packFilepath) noexcept;
+    bool IsPackMounted() const noexcept { return m_pack.IsOpened(); }
+
+    bool Open(const fs::path& filepath, VirtualFile& outFile, MappedFileAccess access = MAPPED_FILE_ACCESS_DEFAULT) const noexcept;
+    bool ReadFile(const fs::path& filepath, std::vector<uint8_t>& outData) const noexcept;
+
+    bool Exists(const fs::path& filepath) const noexcept;
+
+    // Pack entries have precomputed hashes, loose files are hashed through FileFingerprintDB if it's initialized
+    std::optional<ds::Hash128> GetContentHash(const fs::path& filepath) const noexcept;
+
+    // Same traversal rules as ForEachFile from file.h. Only pack entries are visited if the pack is mounted
+    void ForEachFile(const fs::path& rootDir, const VirtualFileVisitor& func, uint32_t dirTreeDepth = UINT32_MAX) const noexcept;
+
+private:
+    explicit VirtualFileSystem(const fs::path& rootDir);
+
+    const PackFileEntry* FindPackEntry(const fs::path& filepath) const noexcept;
+
+private:
+    static inline std::unique_ptr<VirtualFileSystem> s_pVirtualFileSystemInstance = nullptr;
+
+private:
+    fs::path m_rootDir;
+    PackFile m_pack;
+};
@@ -1,27 +1,92 @@
 #include "pch.h"
 
 #include "json.h"
+#include "json_cache.h"
 
 #include "utils/debug/assertion.h"
+#include "utils/file/virtual_file_system.h"
+#include "utils/data_structures/strid.h"
 
 
 namespace amjson
 {
     std::optional<nlohmann::json> ParseJson(const fs::path& pathToJson) noexcept
     {
-        if (!fs::exists(pathToJson)) {
-            AM_LOG_WARN("Json parsing error. File {} doesn't exist.", pathToJson.string());
-            return {};
+        // Utilities may parse JSON before the application sets VFS up
+        if (!VirtualFileSystem::IsInitialized()) {
+            MappedFile jsonFile;
+            if (!jsonFile.Open(pathToJson, MAPPED_FILE_ACCESS_SEQUENTIAL)) {
+                AM_LOG_WARN("Json parsing error. Failed to open {} file.", pathToJson.string());
+                return {};
+            }
+
+            return ParseJson(jsonFile.GetData(), jsonFile.GetSize());
+        }
+
+        const VirtualFileSystem& vfs = VirtualFileSystem::Instance();
+
+        // Content hash of an unchanged loose file comes from its fingerprint, so a cache hit doesn't touch the file content
+        std::optional<ds::Hash128> contentHash;
+
+        if (JsonBinaryCache::IsInitialized()) {
+            contentHash = vfs.GetContentHash(pathToJson);
+
+            if (contentHash.has_value()) {
+                std::optional<nlohmann::json> cachedJson = JsonBinaryCache::Instance().Load(ds::StrID(pathToJson.string()), contentHash.value());
+                if (cachedJson.has_value()) {
+                    return cachedJson;
+                }
+            }
         }
 
-        std::ifstream jsonFile(pathToJson);
-        if (!jsonFile.is_open()) {
+        VirtualFile jsonFile;
+        if (!vfs.Open(pathToJson, jsonFile, MAPPED_FILE_ACCESS_SEQUENTIAL)) {
             AM_LOG_WARN("Json parsing error. Failed to open {} file.", pathToJson.string());
             return {};
         }
 
+        std::optional<nlohmann::json> json = ParseJson(jsonFile.GetView().data(), jsonFile.GetView().size());
+
+        if (json.has_value() && contentHash.has_value()) {
+            JsonBinaryCache::Instance().Add(ds::StrID(pathToJson.string()), contentHash.value(), json.value());
+        }
+
+        return json;
+    }
+
+
+    std::optional<nlohmann::json> ParseJson(const fs::path& pathToJson, const uint8_t* pJsonText, size_t size) noexcept
+    {
+        if (!JsonBinaryCache::IsInitialized()) {
+            return ParseJson(pJsonText, size);
+        }
+
+        JsonBinaryCache& cache = JsonBinaryCache::Instance();
+
+        const ds::StrID jsonFilepath = ds::StrID(pathToJson.string());
+        const ds::Hash128 contentHash = amHashMem128(pJsonText, size);
+
+        std::optional<nlohmann::json> json = cache.Load(jsonFilepath, contentHash);
+        if (json.has_value()) {
+            return json;
+        }
+
+        json = ParseJson(pJsonText, size);
+
+        if (json.has_value()) {
+            cache.Add(jsonFilepath, contentHash, json.value());
+        }
+
+        return json;
+    }
+
+
+    std::optional<nlohmann::json> ParseJson(const uint8_t* pJsonText, size_t size) noexcept
+    {
+        AM_ASSERT(pJsonText || size == 0, "pJsonText is nullptr");
+
         try {
-            return nlohmann::json::parse(jsonFile);
+            return nlohmann::json::parse(pJsonText, pJsonText + size);
         } catch(const nlohmann::json::parse_error& e) {
             AM_LOG_WARN("Json parsing error. Error: {}", e.what());
             return {};
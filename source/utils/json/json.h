@@ -12,7 +12,11 @@
 
 namespace amjson
 {
+    // Unchanged files are decoded from JsonBinaryCache if it's initialized, so their text isn't read and parsed
     std::optional<nlohmann::json> ParseJson(const fs::path& pathToJson) noexcept;
+    // Same as above for already read file content
+    std::optional<nlohmann::json> ParseJson(const fs::path& pathToJson, const uint8_t* pJsonText, size_t size) noexcept;
+    std::optional<nlohmann::json> ParseJson(const uint8_t* pJsonText, size_t size) noexcept;
 
     nlohmann::json& GetJsonSubNode(nlohmann::json& rootNode, const char* pNodeName) noexcept;
     nlohmann::json& GetJsonSubNode(nlohmann::json& rootNode, const std::string& nodeName) noexcept;
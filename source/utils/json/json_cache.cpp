@@ -0,0 +1,306 @@
+#include "pch.h"
+
+#include "json_cache.h"
+
+#include "utils/debug/assertion.h"
+#include "utils/file/file.h"
+#include "utils/file/async_file_writer.h"
+
+
+static constexpr uint32_t AM_JSON_CACHE_MAGIC   = 0x434A4D41; // 'AMJC'
+static constexpr uint32_t AM_JSON_CACHE_VERSION = 1;
+
+
+// JSON binary cache structure:
+//      4 bytes - magic
+//      4 bytes - version
+//      8 bytes - entries count
+//      Entries (JsonCacheEntry):
+//          8 bytes - path StrID id
+//         16 bytes - JSON file content hash
+//          8 bytes - CBOR data offset from the cache file begin
+//          8 bytes - CBOR data size
+//      CBOR data of all entries
+struct JsonCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t entriesCount;
+};
+
+
+struct JsonCacheEntry
+{
+    uint64_t    pathId;
+    ds::Hash128 contentHash;
+    uint64_t    dataOffset;
+    uint64_t    dataSize;
+};
+
+
+static_assert(std::is_same_v<ds::StrID::IdType, uint64_t>, "JSON binary cache stores 64-bit path StrID ids");
+static_assert(sizeof(JsonCacheEntry) == 40, "JSON binary cache entry layout changed, update AM_JSON_CACHE_VERSION");
+
+
+JsonBinaryCache& JsonBinaryCache::Instance() noexcept
+{
+    AM_ASSERT(s_pJsonBinaryCacheInstance != nullptr, "JsonBinaryCache is not initialized, call JsonBinaryCache::Init first");
+
+    return *s_pJsonBinaryCacheInstance;
+}
+
+
+bool JsonBinaryCache::Init(const fs::path& cacheFilepath) noexcept
+{
+    if (IsInitialized()) {
+        AM_LOG_WARN("JsonBinaryCache is already initialized");
+        return true;
+    }
+
+    s_pJsonBinaryCacheInstance = std::unique_ptr<JsonBinaryCache>(new JsonBinaryCache(cacheFilepath));
+    if (!s_pJsonBinaryCacheInstance) {
+        AM_ASSERT_FAIL("Failed to allocate JsonBinaryCache");
+        return false;
+    }
+
+    s_pJsonBinaryCacheInstance->OpenCacheFile();
+
+    return true;
+}
+
+
+void JsonBinaryCache::Terminate() noexcept
+{
+    s_pJsonBinaryCacheInstance = nullptr;
+}
+
+
+JsonBinaryCache::JsonBinaryCache(const fs::path& cacheFilepath)
+    : m_cacheFilepath(cacheFilepath)
+{
+}
+
+
+JsonBinaryCache::~JsonBinaryCache()
+{
+    StoreCacheFile();
+}
+
+
+std::optional<nlohmann::json> JsonBinaryCache::Load(ds::StrID jsonFilepath, const ds::Hash128& contentHash) noexcept
+{
+    // Found data keeps the entry data alive, so it's decoded outside of the lock
+    const CacheData cacheData = FindEntryData(jsonFilepath, contentHash);
+    if (cacheData.IsEmpty()) {
+        return std::nullopt;
+    }
+
+    nlohmann::json json = nlohmann::json::from_cbor(cacheData.data.begin(), cacheData.data.end(), true, false);
+    if (json.is_discarded()) {
+        AM_LOG_WARN("JSON binary cache entry of {} is corrupted", jsonFilepath.CStr());
+        return std::nullopt;
+    }
+
+    return json;
+}
+
+
+JsonBinaryCache::CacheData JsonBinaryCache::FindData(ds::StrID jsonFilepath, const ds::Hash128& contentHash) noexcept
+{
+    return FindEntryData(jsonFilepath, contentHash);
+}
+
+
+JsonBinaryCache::CacheData JsonBinaryCache::Add(ds::StrID jsonFilepath, const ds::Hash128& contentHash, const nlohmann::json& json) noexcept
+{
+    AM_ASSERT(jsonFilepath.IsValid(), "Invalid JSON filepath StrID");
+
+    std::vector<uint8_t> data;
+
+    try {
+        data = nlohmann::json::to_cbor(json);
+    } catch (const nlohmann::json::exception& e) {
+        AM_LOG_WARN("Failed to encode {} to CBOR. Error: {}", jsonFilepath.CStr(), e.what());
+        return CacheData();
+    }
+
+    return Add(jsonFilepath, contentHash, std::move(data));
+}
+
+
+JsonBinaryCache::CacheData JsonBinaryCache::Add(ds::StrID jsonFilepath, const ds::Hash128& contentHash, std::vector<uint8_t>&& cborData) noexcept
+{
+    AM_ASSERT(jsonFilepath.IsValid(), "Invalid JSON filepath StrID");
+
+    CacheEntry entry = {};
+    entry.contentHash = contentHash;
+    entry.pOwnedData = std::make_shared<const std::vector<uint8_t>>(std::move(cborData));
+    entry.data = FileView(entry.pOwnedData->data(), entry.pOwnedData->size());
+    entry.isUsed = true;
+
+    CacheData entryData = {};
+    entryData.data = entry.data;
+    entryData.pOwnedData = entry.pOwnedData;
+
+    std::lock_guard<std::mutex> lock(m_entriesMutex);
+
+    // Replaced entry releases its data unless it points into the cache file mapping
+    m_entries.insert_or_assign(jsonFilepath.GetId(), std::move(entry));
+    m_isDirty = true;
+
+    return entryData;
+}
+
+
+JsonBinaryCache::CacheData JsonBinaryCache::FindEntryData(ds::StrID jsonFilepath, const ds::Hash128& contentHash) noexcept
+{
+    AM_ASSERT(jsonFilepath.IsValid(), "Invalid JSON filepath StrID");
+
+    std::lock_guard<std::mutex> lock(m_entriesMutex);
+
+    const auto entryIt = m_entries.find(jsonFilepath.GetId());
+    if (entryIt == m_entries.end() || entryIt->second.contentHash != contentHash) {
+        return CacheData();
+    }
+
+    CacheEntry& entry = entryIt->second;
+    entry.isUsed = true;
+
+    CacheData entryData = {};
+    entryData.data = entry.data;
+    entryData.pOwnedData = entry.pOwnedData;
+
+    return entryData;
+}
+
+
+size_t JsonBinaryCache::GetEntriesCount() const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_entriesMutex);
+    return m_entries.size();
+}
+
+
+void JsonBinaryCache::OpenCacheFile() noexcept
+{
+    std::error_code error;
+    if (!fs::exists(m_cacheFilepath, error)) {
+        return;
+    }
+
+    if (!m_cacheFile.Open(m_cacheFilepath, MAPPED_FILE_ACCESS_RANDOM)) {
+        return;
+    }
+
+    const size_t cacheFileSize = m_cacheFile.GetSize();
+
+    JsonCacheHeader header = {};
+
+    if (cacheFileSize < sizeof(header)) {
+        AM_LOG_WARN("JSON binary cache {} is corrupted and will be rebuilt", m_cacheFilepath.string().c_str());
+        m_cacheFile.Close();
+        return;
+    }
+
+    memcpy_s(&header, sizeof(header), m_cacheFile.GetData(), sizeof(header));
+
+    const size_t maxEntriesCount = (cacheFileSize - sizeof(header)) / sizeof(JsonCacheEntry);
+
+    if (header.magic != AM_JSON_CACHE_MAGIC || header.version != AM_JSON_CACHE_VERSION || header.entriesCount > maxEntriesCount) {
+        AM_LOG_WARN("JSON binary cache {} is outdated or corrupted and will be rebuilt", m_cacheFilepath.string().c_str());
+        m_cacheFile.Close();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_entriesMutex);
+
+    m_entries.reserve(header.entriesCount);
+
+    const uint8_t* pEntryData = m_cacheFile.GetData() + sizeof(header);
+
+    for (uint64_t i = 0; i < header.entriesCount; ++i, pEntryData += sizeof(JsonCacheEntry)) {
+        JsonCacheEntry fileEntry = {};
+        memcpy_s(&fileEntry, sizeof(fileEntry), pEntryData, sizeof(fileEntry));
+
+        if (fileEntry.dataOffset > cacheFileSize || fileEntry.dataSize > cacheFileSize - fileEntry.dataOffset) {
+            AM_LOG_WARN("JSON binary cache {} is corrupted and will be rebuilt", m_cacheFilepath.string().c_str());
+            m_entries.clear();
+            m_cacheFile.Close();
+            return;
+        }
+
+        CacheEntry& entry = m_entries[fileEntry.pathId];
+        entry.contentHash = fileEntry.contentHash;
+        entry.data = FileView(m_cacheFile.GetData() + fileEntry.dataOffset, fileEntry.dataSize);
+    }
+
+    AM_LOG_INFO("Loaded {} JSON binary cache entries from {}", m_entries.size(), m_cacheFilepath.string().c_str());
+}
+
+
+void JsonBinaryCache::StoreCacheFile() noexcept
+{
+    std::vector<uint8_t> buffer;
+
+    {
+        std::lock_guard<std::mutex> lock(m_entriesMutex);
+
+        size_t usedEntriesCount = 0;
+        size_t dataSize = 0;
+
+        for (const auto& [pathId, entry] : m_entries) {
+            if (entry.isUsed) {
+                ++usedEntriesCount;
+                dataSize += entry.data.size();
+            }
+        }
+
+        // Unused entries are dropped, so the file is rewritten even if nothing was added
+        if (!m_isDirty && usedEntriesCount == m_entries.size()) {
+            return;
+        }
+
+        const size_t entriesSize = usedEntriesCount * sizeof(JsonCacheEntry);
+
+        JsonCacheHeader header = {};
+        header.magic = AM_JSON_CACHE_MAGIC;
+        header.version = AM_JSON_CACHE_VERSION;
+        header.entriesCount = usedEntriesCount;
+
+        buffer.resize(sizeof(JsonCacheHeader) + entriesSize + dataSize);
+        memcpy_s(buffer.data(), buffer.size(), &header, sizeof(header));
+
+        uint8_t* pEntryData = buffer.data() + sizeof(JsonCacheHeader);
+        uint64_t dataOffset = sizeof(JsonCacheHeader) + entriesSize;
+
+        for (const auto& [pathId, entry] : m_entries) {
+            if (!entry.isUsed) {
+                continue;
+            }
+
+            JsonCacheEntry fileEntry = {};
+            fileEntry.pathId      = pathId;
+            fileEntry.contentHash = entry.contentHash;
+            fileEntry.dataOffset  = dataOffset;
+            fileEntry.dataSize    = entry.data.size();
+
+            memcpy_s(pEntryData, buffer.size() - (pEntryData - buffer.data()), &fileEntry, sizeof(fileEntry));
+            memcpy_s(buffer.data() + dataOffset, buffer.size() - dataOffset, entry.data.data(), entry.data.size());
+
+            pEntryData += sizeof(JsonCacheEntry);
+            dataOffset += entry.data.size();
+        }
+
+        m_entries.clear();
+        m_isDirty = false;
+    }
+
+    // The mapping must be released before the cache file is replaced
+    m_cacheFile.Close();
+
+    if (AsyncFileWriter::IsInitialized()) {
+        AsyncFileWriter::Instance().WriteFileAsync(m_cacheFilepath, std::move(buffer));
+    } else {
+        WriteBinaryFileAtomic(m_cacheFilepath, buffer.data(), buffer.size());
+    }
+}
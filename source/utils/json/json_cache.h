@@ -0,0 +1,113 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <filesystem>
+#include <optional>
+#include <vector>
+#include <mutex>
+#include <memory>
+
+#include <cstdint>
+
+#include "path_system/path_system.h"
+
+#include "utils/file/mapped_file.h"
+#include "utils/data_structures/strid.h"
+#include "utils/data_structures/hash.h"
+#include "utils/data_structures/flat_hash_map.h"
+
+
+// Persistent cache of parsed JSON files in CBOR form. Entries are keyed by the file path StrID and are valid only for the
+// content hash they were made for. The cache file is memory-mapped, so an unchanged JSON file is decoded straight from the
+// mapping without reading and parsing its text. Thread-safe
+class JsonBinaryCache
+{
+public:
+    static JsonBinaryCache& Instance() noexcept;
+
+    // Maps the cache file if it exists. Terminate stores the cache back if any entry was added
+    static bool Init(const fs::path& cacheFilepath) noexcept;
+    static void Terminate() noexcept;
+
+    static bool IsInitialized() noexcept { return s_pJsonBinaryCacheInstance != nullptr; }
+
+    JsonBinaryCache(const JsonBinaryCache& cache) = delete;
+    JsonBinaryCache& operator=(const JsonBinaryCache& cache) = delete;
+
+    JsonBinaryCache(JsonBinaryCache&& cache) = delete;
+    JsonBinaryCache& operator=(JsonBinaryCache&& cache) = delete;
+
+    ~JsonBinaryCache();
+
+    // CBOR data of an entry. Data of the entries added during this run is owned here too, so it stays valid even if the entry
+    // is replaced meanwhile. Data of the entries from the cache file stays valid until the cache is terminated
+    struct CacheData
+    {
+        bool IsEmpty() const noexcept { return data.empty(); }
+
+        FileView data;
+        std::shared_ptr<const std::vector<uint8_t>> pOwnedData;
+    };
+
+public:
+    // Returns nullopt if there is no entry for the file or the entry was made for different file content
+    std::optional<nlohmann::json> Load(ds::StrID jsonFilepath, const ds::Hash128& contentHash) noexcept;
+
+    // Same lookup as Load, but returns the raw CBOR data for SAX readers. Returns empty data on miss
+    CacheData FindData(ds::StrID jsonFilepath, const ds::Hash128& contentHash) noexcept;
+
+    // Returns the added CBOR data or empty data if the JSON can't be encoded. Replaced entry data added during this run is released
+    // once nobody holds it
+    CacheData Add(ds::StrID jsonFilepath, const ds::Hash128& contentHash, const nlohmann::json& json) noexcept;
+
+    // Adds already encoded CBOR data, e.g. written straight from SAX events without building the tree
+    CacheData Add(ds::StrID jsonFilepath, const ds::Hash128& contentHash, std::vector<uint8_t>&& cborData) noexcept;
+
+    size_t GetEntriesCount() const noexcept;
+
+private:
+    struct CacheEntry
+    {
+        ds::Hash128 contentHash;
+        FileView data;
+
+        // Owns the data of the entries added during this run, null for the ones pointing into the cache file mapping.
+        // Shared, so Load can decode the data outside of the lock while the entry is being replaced
+        std::shared_ptr<const std::vector<uint8_t>> pOwnedData;
+
+        // Set when the entry is looked up or added during this run. Only used entries are stored back
+        bool isUsed = false;
+    };
+
+    struct CacheKeyHasher
+    {
+        using is_avalanching = void;
+        uint64_t operator()(ds::StrID::IdType id) const noexcept { return id; }
+    };
+
+private:
+    explicit JsonBinaryCache(const fs::path& cacheFilepath);
+
+    // Returns empty data on miss and marks the found entry used
+    CacheData FindEntryData(ds::StrID jsonFilepath, const ds::Hash128& contentHash) noexcept;
+
+    void OpenCacheFile() noexcept;
+
+    // Entries point into the cache file mapping, so the cache is stored only once on destruction. Entries which weren't used during
+    // this run are dropped, so the file doesn't keep the data of renamed and removed JSON files
+    void StoreCacheFile() noexcept;
+
+private:
+    static inline std::unique_ptr<JsonBinaryCache> s_pJsonBinaryCacheInstance = nullptr;
+
+private:
+    fs::path m_cacheFilepath;
+    MappedFile m_cacheFile;
+
+    // StrID ids are hashes of the path strings, so they stay valid between runs
+    ds::FlatHashMap<ds::StrID::IdType, CacheEntry, CacheKeyHasher> m_entries;
+
+    mutable std::mutex m_entriesMutex;
+
+    bool m_isDirty = false;
+};
@@ -0,0 +1,498 @@
+#include "pch.h"
+
+#include "json_schema.h"
+#include "json_cache.h"
+
+#include "utils/debug/assertion.h"
+#include "utils/file/virtual_file_system.h"
+#include "utils/data_structures/small_vector.h"
+#include "utils/data_structures/strid.h"
+
+
+// Deeper configs spill the frames stack to the heap
+static constexpr size_t AM_JSON_SCHEMA_INLINE_FRAMES_COUNT = 16;
+
+
+namespace amjson
+{
+    // Routes SAX events of nlohmann parsers to the schema readers. Keeps a stack of the objects and arrays being read,
+    // subtrees of unknown fields are skipped by tracking their nesting depth only
+    class JsonSchemaSaxHandler
+    {
+    public:
+        JsonSchemaSaxHandler(void* pRootValue, const JsonSchemaReader* pRootReader) noexcept
+            : m_pendingTarget{ pRootValue, pRootReader } {}
+
+        bool null() noexcept { return ReadScalar("null", [](const Target& target) { return false; }); }
+
+        bool boolean(bool value) noexcept
+        {
+            return ReadScalar("boolean", [value](const Target& target) {
+                return target.pReader->pReadBool && target.pReader->pReadBool(target.pValue, value);
+            });
+        }
+
+        bool number_integer(nlohmann::json::number_integer_t value) noexcept
+        {
+            return ReadScalar("integer", [value](const Target& target) {
+                return target.pReader->pReadInteger && target.pReader->pReadInteger(target.pValue, value);
+            });
+        }
+
+        bool number_unsigned(nlohmann::json::number_unsigned_t value) noexcept
+        {
+            return ReadScalar("integer", [value](const Target& target) {
+                return target.pReader->pReadUnsigned && target.pReader->pReadUnsigned(target.pValue, value);
+            });
+        }
+
+        bool number_float(nlohmann::json::number_float_t value, const nlohmann::json::string_t& text) noexcept
+        {
+            return ReadScalar("float", [value](const Target& target) {
+                return target.pReader->pReadFloat && target.pReader->pReadFloat(target.pValue, value);
+            });
+        }
+
+        bool string(nlohmann::json::string_t& value) noexcept
+        {
+            return ReadScalar("string", [&value](const Target& target) {
+                return target.pReader->pReadString && target.pReader->pReadString(target.pValue, value);
+            });
+        }
+
+        bool binary(nlohmann::json::binary_t& value) noexcept { return ReadScalar("binary", [](const Target& target) { return false; }); }
+
+        bool start_object(size_t elementsCount) noexcept
+        {
+            if (m_skippedDepth > 0) {
+                ++m_skippedDepth;
+                return true;
+            }
+
+            const Target target = AcquireTarget();
+            if (!target.pReader) {
+                m_skippedDepth = 1;
+                return true;
+            }
+
+            if (!target.pReader->pFindField && !target.pReader->isMap) {
+                return Fail("object");
+            }
+
+            m_frames.emplace_back(Frame{ target.pValue, target.pReader, 0 });
+            return true;
+        }
+
+        bool key(nlohmann::json::string_t& name) noexcept
+        {
+            if (m_skippedDepth > 0) {
+                return true;
+            }
+
+            Frame& frame = m_frames.back();
+
+            if (frame.pReader->isMap) {
+                m_pendingTarget.pValue = frame.pReader->pAddElement(frame.pValue, name, &m_pendingTarget.pReader);
+                return true;
+            }
+
+            const uint32_t fieldIdx = frame.pReader->pFindField(frame.pValue, name, &m_pendingTarget.pValue, &m_pendingTarget.pReader);
+
+            if (fieldIdx == UINT32_MAX) {
+                m_pendingTarget = Target();
+                return true;
+            }
+
+            frame.readFieldsMask |= 1ull << fieldIdx;
+            return true;
+        }
+
+        bool end_object() noexcept
+        {
+            if (m_skippedDepth > 0) {
+                --m_skippedDepth;
+                return true;
+            }
+
+            const Frame frame = m_frames.back();
+            m_frames.pop_back();
+
+            for (uint32_t i = 0; i < frame.pReader->fieldsCount; ++i) {
+                if ((frame.readFieldsMask & (1ull << i)) == 0) {
+                    AM_LOG_WARN("Json schema error. Required field '{}' is missing", frame.pReader->pFieldNames[i]);
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool start_array(size_t elementsCount) noexcept
+        {
+            if (m_skippedDepth > 0) {
+                ++m_skippedDepth;
+                return true;
+            }
+
+            const Target target = AcquireTarget();
+            if (!target.pReader) {
+                m_skippedDepth = 1;
+                return true;
+            }
+
+            if (!target.pReader->pAddElement || target.pReader->isMap) {
+                return Fail("array");
+            }
+
+            m_frames.emplace_back(Frame{ target.pValue, target.pReader, 0 });
+            return true;
+        }
+
+        bool end_array() noexcept
+        {
+            if (m_skippedDepth > 0) {
+                --m_skippedDepth;
+                return true;
+            }
+
+            m_frames.pop_back();
+            return true;
+        }
+
+        bool parse_error(size_t position, const std::string& lastToken, const nlohmann::json::exception& exception) noexcept
+        {
+            AM_LOG_WARN("Json parsing error. Error: {}", exception.what());
+            return false;
+        }
+
+    private:
+        struct Target
+        {
+            void* pValue = nullptr;
+            const JsonSchemaReader* pReader = nullptr;  // nullptr for values of unknown fields
+        };
+
+        struct Frame
+        {
+            void* pValue;
+            const JsonSchemaReader* pReader;
+            uint64_t readFieldsMask;
+        };
+
+    private:
+        // Array elements are created on their first event, object fields and map items are resolved by the preceding key
+        Target AcquireTarget() noexcept
+        {
+            Target target;
+
+            if (!m_frames.empty() && m_frames.back().pReader->pAddElement && !m_frames.back().pReader->isMap) {
+                const Frame& frame = m_frames.back();
+                target.pValue = frame.pReader->pAddElement(frame.pValue, std::string_view(), &target.pReader);
+            } else {
+                target = m_pendingTarget;
+                m_pendingTarget = Target();
+            }
+
+            return target;
+        }
+
+        template <typename ReadFunc>
+        bool ReadScalar(const char* pValueKind, const ReadFunc& func) noexcept
+        {
+            if (m_skippedDepth > 0) {
+                return true;
+            }
+
+            const Target target = AcquireTarget();
+            if (!target.pReader) {
+                return true;
+            }
+
+            if (!func(target)) {
+                return Fail(pValueKind);
+            }
+
+            return true;
+        }
+
+        bool Fail(const char* pValueKind) noexcept
+        {
+            AM_LOG_WARN("Json schema error. Unexpected or out of range {} value", pValueKind);
+            return false;
+        }
+
+    private:
+        ds::SmallVector<Frame, AM_JSON_SCHEMA_INLINE_FRAMES_COUNT> m_frames;
+        Target m_pendingTarget;
+
+        uint32_t m_skippedDepth = 0;
+    };
+
+
+    // Encodes SAX events to CBOR, so a text load can fill JsonBinaryCache without building a nlohmann::json tree.
+    // Text parser doesn't know element counts in advance, so objects and arrays are written with indefinite length
+    class JsonCborSaxWriter
+    {
+    public:
+        explicit JsonCborSaxWriter(std::vector<uint8_t>& outData) noexcept
+            : m_data(outData) {}
+
+        bool null() noexcept { return WriteByte(0xF6); }
+        bool boolean(bool value) noexcept { return WriteByte(value ? 0xF5 : 0xF4); }
+
+        bool number_integer(nlohmann::json::number_integer_t value) noexcept
+        {
+            // Negative integers are stored as -1 - value, which can't overflow
+            return value >= 0 ? WriteHead(0, static_cast<uint64_t>(value)) : WriteHead(1, static_cast<uint64_t>(-(value + 1)));
+        }
+
+        bool number_unsigned(nlohmann::json::number_unsigned_t value) noexcept { return WriteHead(0, value); }
+
+        bool number_float(nlohmann::json::number_float_t value, const nlohmann::json::string_t& text) noexcept
+        {
+            uint64_t bits = 0;
+            memcpy_s(&bits, sizeof(bits), &value, sizeof(value));
+
+            WriteByte(0xFB);
+            return WriteBigEndian(bits, sizeof(bits));
+        }
+
+        bool string(nlohmann::json::string_t& value) noexcept { return WriteBytes(3, value.data(), value.size()); }
+        bool binary(nlohmann::json::binary_t& value) noexcept { return WriteBytes(2, value.data(), value.size()); }
+
+        bool start_object(size_t elementsCount) noexcept { return WriteByte(0xBF); }
+        bool key(nlohmann::json::string_t& name) noexcept { return string(name); }
+        bool end_object() noexcept { return WriteByte(0xFF); }
+
+        bool start_array(size_t elementsCount) noexcept { return WriteByte(0x9F); }
+        bool end_array() noexcept { return WriteByte(0xFF); }
+
+        bool parse_error(size_t position, const std::string& lastToken, const nlohmann::json::exception& exception) noexcept { return false; }
+
+    private:
+        bool WriteByte(uint8_t value) noexcept
+        {
+            m_data.emplace_back(value);
+            return true;
+        }
+
+        bool WriteBigEndian(uint64_t value, size_t bytesCount) noexcept
+        {
+            for (size_t i = bytesCount; i > 0; --i) {
+                m_data.emplace_back(static_cast<uint8_t>(value >> ((i - 1) * 8)));
+            }
+
+            return true;
+        }
+
+        bool WriteHead(uint8_t majorType, uint64_t value) noexcept
+        {
+            const uint8_t type = static_cast<uint8_t>(majorType << 5);
+
+            if (value < 24) {
+                return WriteByte(static_cast<uint8_t>(type | value));
+            }
+
+            if (value <= UINT8_MAX) {
+                WriteByte(type | 24);
+                return WriteBigEndian(value, 1);
+            }
+
+            if (value <= UINT16_MAX) {
+                WriteByte(type | 25);
+                return WriteBigEndian(value, 2);
+            }
+
+            if (value <= UINT32_MAX) {
+                WriteByte(type | 26);
+                return WriteBigEndian(value, 4);
+            }
+
+            WriteByte(type | 27);
+            return WriteBigEndian(value, 8);
+        }
+
+        bool WriteBytes(uint8_t majorType, const void* pData, size_t size) noexcept
+        {
+            WriteHead(majorType, size);
+
+            const uint8_t* pDataU8 = static_cast<const uint8_t*>(pData);
+            m_data.insert(m_data.end(), pDataU8, pDataU8 + size);
+
+            return true;
+        }
+
+    private:
+        std::vector<uint8_t>& m_data;
+    };
+
+
+    // Feeds every SAX event to the schema handler and the CBOR writer. The writer goes first, since the schema handler
+    // may move strings out of the events
+    class JsonSchemaCachingSaxHandler
+    {
+    public:
+        JsonSchemaCachingSaxHandler(JsonSchemaSaxHandler& schemaHandler, JsonCborSaxWriter& cborWriter) noexcept
+            : m_schemaHandler(schemaHandler), m_cborWriter(cborWriter) {}
+
+        bool null() noexcept { return m_cborWriter.null() && m_schemaHandler.null(); }
+        bool boolean(bool value) noexcept { return m_cborWriter.boolean(value) && m_schemaHandler.boolean(value); }
+
+        bool number_integer(nlohmann::json::number_integer_t value) noexcept
+        {
+            return m_cborWriter.number_integer(value) && m_schemaHandler.number_integer(value);
+        }
+
+        bool number_unsigned(nlohmann::json::number_unsigned_t value) noexcept
+        {
+            return m_cborWriter.number_unsigned(value) && m_schemaHandler.number_unsigned(value);
+        }
+
+        bool number_float(nlohmann::json::number_float_t value, const nlohmann::json::string_t& text) noexcept
+        {
+            return m_cborWriter.number_float(value, text) && m_schemaHandler.number_float(value, text);
+        }
+
+        bool string(nlohmann::json::string_t& value) noexcept { return m_cborWriter.string(value) && m_schemaHandler.string(value); }
+        bool binary(nlohmann::json::binary_t& value) noexcept { return m_cborWriter.binary(value) && m_schemaHandler.binary(value); }
+
+        bool start_object(size_t elementsCount) noexcept
+        {
+            return m_cborWriter.start_object(elementsCount) && m_schemaHandler.start_object(elementsCount);
+        }
+
+        bool key(nlohmann::json::string_t& name) noexcept { return m_cborWriter.key(name) && m_schemaHandler.key(name); }
+        bool end_object() noexcept { return m_cborWriter.end_object() && m_schemaHandler.end_object(); }
+
+        bool start_array(size_t elementsCount) noexcept
+        {
+            return m_cborWriter.start_array(elementsCount) && m_schemaHandler.start_array(elementsCount);
+        }
+
+        bool end_array() noexcept { return m_cborWriter.end_array() && m_schemaHandler.end_array(); }
+
+        bool parse_error(size_t position, const std::string& lastToken, const nlohmann::json::exception& exception) noexcept
+        {
+            return m_schemaHandler.parse_error(position, lastToken, exception);
+        }
+
+    private:
+        JsonSchemaSaxHandler& m_schemaHandler;
+        JsonCborSaxWriter& m_cborWriter;
+    };
+
+
+    // Cache miss path: single SAX pass over the text fills the value and encodes the CBOR cache entry at the same time
+    static bool ParseJsonSchemaTextAndCache(ds::StrID jsonFilepath, const ds::Hash128& contentHash, const uint8_t* pJsonText, size_t size,
+        void* pValue, const JsonSchemaReader* pReader) noexcept
+    {
+        std::vector<uint8_t> cborData;
+        cborData.reserve(size);
+
+        JsonSchemaSaxHandler schemaHandler(pValue, pReader);
+        JsonCborSaxWriter cborWriter(cborData);
+        JsonSchemaCachingSaxHandler handler(schemaHandler, cborWriter);
+
+        try {
+            if (!nlohmann::json::sax_parse(pJsonText, pJsonText + size, &handler)) {
+                return false;
+            }
+        } catch (const nlohmann::json::exception& e) {
+            AM_LOG_WARN("Json parsing error. Error: {}", e.what());
+            return false;
+        }
+
+        JsonBinaryCache::Instance().Add(jsonFilepath, contentHash, std::move(cborData));
+
+        return true;
+    }
+
+
+    bool ParseJsonSchema(const uint8_t* pData, size_t size, JsonSchemaInputFormat format, void* pValue, const JsonSchemaReader* pReader) noexcept
+    {
+        AM_ASSERT(pData || size == 0, "pData is nullptr");
+        AM_ASSERT(pValue && pReader, "Invalid JSON schema target");
+
+        const nlohmann::json::input_format_t inputFormat = format == JSON_SCHEMA_INPUT_FORMAT_CBOR ?
+            nlohmann::json::input_format_t::cbor : nlohmann::json::input_format_t::json;
+
+        JsonSchemaSaxHandler handler(pValue, pReader);
+
+        try {
+            return nlohmann::json::sax_parse(pData, pData + size, &handler, inputFormat);
+        } catch (const nlohmann::json::exception& e) {
+            AM_LOG_WARN("Json parsing error. Error: {}", e.what());
+            return false;
+        }
+    }
+
+
+    bool ParseJsonSchema(const fs::path& pathToJson, void* pValue, const JsonSchemaReader* pReader) noexcept
+    {
+        // Utilities may parse JSON before the application sets VFS up
+        if (!VirtualFileSystem::IsInitialized()) {
+            MappedFile jsonFile;
+            if (!jsonFile.Open(pathToJson, MAPPED_FILE_ACCESS_SEQUENTIAL)) {
+                AM_LOG_WARN("Json parsing error. Failed to open {} file.", pathToJson.string());
+                return false;
+            }
+
+            return ParseJsonSchema(jsonFile.GetData(), jsonFile.GetSize(), JSON_SCHEMA_INPUT_FORMAT_TEXT, pValue, pReader);
+        }
+
+        const VirtualFileSystem& vfs = VirtualFileSystem::Instance();
+
+        if (JsonBinaryCache::IsInitialized()) {
+            const std::optional<ds::Hash128> contentHash = vfs.GetContentHash(pathToJson);
+
+            if (contentHash.has_value()) {
+                JsonBinaryCache& cache = JsonBinaryCache::Instance();
+                const ds::StrID jsonFilepath = ds::StrID(pathToJson.string());
+
+                const JsonBinaryCache::CacheData cborData = cache.FindData(jsonFilepath, contentHash.value());
+
+                if (!cborData.IsEmpty()) {
+                    return ParseJsonSchema(cborData.data.data(), cborData.data.size(), JSON_SCHEMA_INPUT_FORMAT_CBOR, pValue, pReader);
+                }
+
+                VirtualFile jsonFile;
+                if (!vfs.Open(pathToJson, jsonFile, MAPPED_FILE_ACCESS_SEQUENTIAL)) {
+                    AM_LOG_WARN("Json parsing error. Failed to open {} file.", pathToJson.string());
+                    return false;
+                }
+
+                return ParseJsonSchemaTextAndCache(jsonFilepath, contentHash.value(), jsonFile.GetView().data(), jsonFile.GetView().size(), 
+                    pValue, pReader);
+            }
+        }
+
+        VirtualFile jsonFile;
+        if (!vfs.Open(pathToJson, jsonFile, MAPPED_FILE_ACCESS_SEQUENTIAL)) {
+            AM_LOG_WARN("Json parsing error. Failed to open {} file.", pathToJson.string());
+            return false;
+        }
+
+        return ParseJsonSchema(jsonFile.GetView().data(), jsonFile.GetView().size(), JSON_SCHEMA_INPUT_FORMAT_TEXT, pValue, pReader);
+    }
+
+
+    bool ParseJsonSchema(const fs::path& pathToJson, const uint8_t* pJsonText, size_t size, void* pValue, const JsonSchemaReader* pReader) noexcept
+    {
+        if (!JsonBinaryCache::IsInitialized()) {
+            return ParseJsonSchema(pJsonText, size, JSON_SCHEMA_INPUT_FORMAT_TEXT, pValue, pReader);
+        }
+
+        JsonBinaryCache& cache = JsonBinaryCache::Instance();
+
+        const ds::StrID jsonFilepath = ds::StrID(pathToJson.string());
+        const ds::Hash128 contentHash = amHashMem128(pJsonText, size);
+
+        const JsonBinaryCache::CacheData cborData = cache.FindData(jsonFilepath, contentHash);
+
+        if (cborData.IsEmpty()) {
+            return ParseJsonSchemaTextAndCache(jsonFilepath, contentHash, pJsonText, size, pValue, pReader);
+        }
+
+        return ParseJsonSchema(cborData.data.data(), cborData.data.size(), JSON_SCHEMA_INPUT_FORMAT_CBOR, pValue, pReader);
+    }
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+#include <limits>
+
+#include <cstdint>
+
+#include "path_system/path_system.h"
+
+
+// Typed JSON configs. A schema is an X-macro list of FIELD(type, member, "json name") entries, AM_JSON_SCHEMA_STRUCT
+// generates a plain struct with those members and a SAX reader for it. Loaders fill the struct straight from parser
+// events without building a nlohmann::json tree. All fields are required, unknown JSON fields are skipped. Generated structs
+// are comparable, so reloaded configs can be diffed against the current ones.
+// Supported field types are bool, integers, floats, std::string, std::vector, amjson::JsonMap and other schema structs
+namespace amjson
+{
+    // JSON object with arbitrary keys. Items order depends on the input format, sort them if it matters
+    template <typename T>
+    using JsonMap = std::vector<std::pair<std::string, T>>;
+
+
+    // Type-erased SAX reader of one C++ type. Callbacks of the JSON kinds the type can't be read from are nullptr
+    struct JsonSchemaReader
+    {
+        bool (*pReadBool)(void* pValue, bool value) noexcept;
+        bool (*pReadInteger)(void* pValue, int64_t value) noexcept;
+        bool (*pReadUnsigned)(void* pValue, uint64_t value) noexcept;
+        bool (*pReadFloat)(void* pValue, double value) noexcept;
+        bool (*pReadString)(void* pValue, std::string_view value) noexcept;
+
+        // Schema structs. Returns the field index and outputs the field with its reader, or returns UINT32_MAX for unknown keys
+        uint32_t (*pFindField)(void* pObject, std::string_view key, void** ppField, const JsonSchemaReader** ppFieldReader) noexcept;
+        const char* const* pFieldNames;
+        uint32_t fieldsCount;
+
+        // Arrays and maps. Appends a default element and outputs its reader. Key is empty for arrays
+        void* (*pAddElement)(void* pContainer, std::string_view key, const JsonSchemaReader** ppElementReader) noexcept;
+        bool isMap;
+    };
+
+
+    enum JsonSchemaInputFormat
+    {
+        JSON_SCHEMA_INPUT_FORMAT_TEXT,
+        JSON_SCHEMA_INPUT_FORMAT_CBOR,
+        JSON_SCHEMA_INPUT_FORMAT_COUNT
+    };
+
+
+    template <typename T>
+    const JsonSchemaReader* GetJsonSchemaReader() noexcept;
+
+
+    bool ParseJsonSchema(const uint8_t* pData, size_t size, JsonSchemaInputFormat format, void* pValue, const JsonSchemaReader* pReader) noexcept;
+
+    // Resets outValue and fills it from JSON text. Returns false if the text is malformed or doesn't match the schema
+    template <typename T>
+    bool ParseJsonSchema(const uint8_t* pJsonText, size_t size, T& outValue) noexcept;
+
+    // Unchanged files are read from their JsonBinaryCache CBOR entries if the cache is initialized
+    bool ParseJsonSchema(const fs::path& pathToJson, void* pValue, const JsonSchemaReader* pReader) noexcept;
+
+    template <typename T>
+    bool ParseJsonSchema(const fs::path& pathToJson, T& outValue) noexcept;
+
+    // Same as above for already read file content
+    bool ParseJsonSchema(const fs::path& pathToJson, const uint8_t* pJsonText, size_t size, void* pValue, const JsonSchemaReader* pReader) noexcept;
+
+    template <typename T>
+    bool ParseJsonSchema(const fs::path& pathToJson, const uint8_t* pJsonText, size_t size, T& outValue) noexcept;
+}
+
+
+#define AM_JSON_SCHEMA_DECLARE_FIELD(type, member, jsonName) type member = {};
+
+#define AM_JSON_SCHEMA_FIELD_NAME(type, member, jsonName) jsonName,
+
+#define AM_JSON_SCHEMA_COMPARE_FIELD(type, member, jsonName) && member == other.member
+
+#define AM_JSON_SCHEMA_FIND_FIELD(type, member, jsonName)                       \
+    if (key == jsonName) {                                                      \
+        *ppField = &pObject->member;                                            \
+        *ppFieldReader = ::amjson::GetJsonSchemaReader<type>();                 \
+        return fieldIdx;                                                        \
+    }                                                                           \
+    ++fieldIdx;
+
+
+#define AM_JSON_SCHEMA_STRUCT(StructName, SCHEMA)                                                                   \
+    struct StructName                                                                                               \
+    {                                                                                                               \
+        SCHEMA(AM_JSON_SCHEMA_DECLARE_FIELD)                                                                        \
+                                                                                                                    \
+        bool operator==(const StructName& other) const noexcept                                                     \
+        {                                                                                                           \
+            return true SCHEMA(AM_JSON_SCHEMA_COMPARE_FIELD);                                                       \
+        }                                                                                                           \
+                                                                                                                    \
+        bool operator!=(const StructName& other) const noexcept { return !(*this == other); }                       \
+                                                                                                                    \
+        static const ::amjson::JsonSchemaReader* GetJsonSchemaReader() noexcept                                     \
+        {                                                                                                           \
+            static constexpr const char* FIELD_NAMES[] = { SCHEMA(AM_JSON_SCHEMA_FIELD_NAME) };                     \
+            static_assert(std::size(FIELD_NAMES) <= 64, "Schema structs are limited to 64 fields");                \
+                                                                                                                    \
+            static constexpr ::amjson::JsonSchemaReader READER = {                                                  \
+                nullptr, nullptr, nullptr, nullptr, nullptr,                                                        \
+                &StructName::FindJsonSchemaField, FIELD_NAMES, static_cast<uint32_t>(std::size(FIELD_NAMES)),       \
+                nullptr, false                                                                                      \
+            };                                                                                                      \
+                                                                                                                    \
+            return &READER;                                                                                         \
+        }                                                                                                           \
+                                                                                                                    \
+        static uint32_t FindJsonSchemaField(void* pValue, std::string_view key, void** ppField,                     \
+            const ::amjson::JsonSchemaReader** ppFieldReader) noexcept                                              \
+        {                                                                                                           \
+            StructName* pObject = static_cast<StructName*>(pValue);                                                 \
+            uint32_t fieldIdx = 0;                                                                                  \
+                                                                                                                    \
+            SCHEMA(AM_JSON_SCHEMA_FIND_FIELD)                                                                       \
+                                                                                                                    \
+            return UINT32_MAX;                                                                                      \
+        }                                                                                                           \
+    }
+
+
+#include "json_schema.hpp"
@@ -0,0 +1,181 @@
+namespace amjson
+{
+    namespace detail
+    {
+        template <typename T, typename = void>
+        struct IsJsonSchemaStruct : std::false_type {};
+
+        template <typename T>
+        struct IsJsonSchemaStruct<T, std::void_t<decltype(T::GetJsonSchemaReader())>> : std::true_type {};
+
+
+        template <typename T>
+        struct IsJsonSchemaArray : std::false_type {};
+
+        template <typename T>
+        struct IsJsonSchemaArray<std::vector<T>> : std::true_type {};
+
+
+        template <typename T>
+        struct IsJsonSchemaMap : std::false_type {};
+
+        template <typename T>
+        struct IsJsonSchemaMap<JsonMap<T>> : std::true_type {};
+
+
+        template <typename T>
+        inline bool ReadJsonSchemaBool(void* pValue, bool value) noexcept
+        {
+            *static_cast<T*>(pValue) = value;
+            return true;
+        }
+
+
+        template <typename T>
+        inline bool ReadJsonSchemaInteger(void* pValue, int64_t value) noexcept
+        {
+            if constexpr (std::is_integral_v<T>) {
+                if (value < static_cast<int64_t>(std::numeric_limits<T>::min()) ||
+                    (std::is_signed_v<T> && value > static_cast<int64_t>(std::numeric_limits<T>::max()))) {
+                    return false;
+                }
+            }
+
+            *static_cast<T*>(pValue) = static_cast<T>(value);
+            return true;
+        }
+
+
+        template <typename T>
+        inline bool ReadJsonSchemaUnsigned(void* pValue, uint64_t value) noexcept
+        {
+            if constexpr (std::is_integral_v<T>) {
+                if (value > static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+                    return false;
+                }
+            }
+
+            *static_cast<T*>(pValue) = static_cast<T>(value);
+            return true;
+        }
+
+
+        template <typename T>
+        inline bool ReadJsonSchemaFloat(void* pValue, double value) noexcept
+        {
+            *static_cast<T*>(pValue) = static_cast<T>(value);
+            return true;
+        }
+
+
+        inline bool ReadJsonSchemaString(void* pValue, std::string_view value) noexcept
+        {
+            static_cast<std::string*>(pValue)->assign(value);
+            return true;
+        }
+
+
+        template <typename ContainerT>
+        inline void* AddJsonSchemaArrayElement(void* pContainer, std::string_view key, const JsonSchemaReader** ppElementReader) noexcept
+        {
+            *ppElementReader = GetJsonSchemaReader<typename ContainerT::value_type>();
+            return &static_cast<ContainerT*>(pContainer)->emplace_back();
+        }
+
+
+        template <typename ContainerT>
+        inline void* AddJsonSchemaMapElement(void* pContainer, std::string_view key, const JsonSchemaReader** ppElementReader) noexcept
+        {
+            *ppElementReader = GetJsonSchemaReader<typename ContainerT::value_type::second_type>();
+
+            auto& element = static_cast<ContainerT*>(pContainer)->emplace_back();
+            element.first.assign(key);
+
+            return &element.second;
+        }
+    }
+
+
+    template <typename T>
+    inline const JsonSchemaReader* GetJsonSchemaReader() noexcept
+    {
+        if constexpr (detail::IsJsonSchemaStruct<T>::value) {
+            return T::GetJsonSchemaReader();
+        } else if constexpr (detail::IsJsonSchemaMap<T>::value) {
+            static constexpr JsonSchemaReader READER = {
+                nullptr, nullptr, nullptr, nullptr, nullptr,
+                nullptr, nullptr, 0,
+                &detail::AddJsonSchemaMapElement<T>, true
+            };
+
+            return &READER;
+        } else if constexpr (detail::IsJsonSchemaArray<T>::value) {
+            static constexpr JsonSchemaReader READER = {
+                nullptr, nullptr, nullptr, nullptr, nullptr,
+                nullptr, nullptr, 0,
+                &detail::AddJsonSchemaArrayElement<T>, false
+            };
+
+            return &READER;
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            static constexpr JsonSchemaReader READER = {
+                nullptr, nullptr, nullptr, nullptr, &detail::ReadJsonSchemaString,
+                nullptr, nullptr, 0,
+                nullptr, false
+            };
+
+            return &READER;
+        } else if constexpr (std::is_same_v<T, bool>) {
+            static constexpr JsonSchemaReader READER = {
+                &detail::ReadJsonSchemaBool<T>, nullptr, nullptr, nullptr, nullptr,
+                nullptr, nullptr, 0,
+                nullptr, false
+            };
+
+            return &READER;
+        } else if constexpr (std::is_integral_v<T>) {
+            static constexpr JsonSchemaReader READER = {
+                nullptr, &detail::ReadJsonSchemaInteger<T>, &detail::ReadJsonSchemaUnsigned<T>, nullptr, nullptr,
+                nullptr, nullptr, 0,
+                nullptr, false
+            };
+
+            return &READER;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            static constexpr JsonSchemaReader READER = {
+                nullptr, &detail::ReadJsonSchemaInteger<T>, &detail::ReadJsonSchemaUnsigned<T>, &detail::ReadJsonSchemaFloat<T>, nullptr,
+                nullptr, nullptr, 0,
+                nullptr, false
+            };
+
+            return &READER;
+        } else {
+            static_assert(detail::IsJsonSchemaStruct<T>::value, "Unsupported JSON schema field type");
+            return nullptr;
+        }
+    }
+
+
+    template <typename T>
+    inline bool ParseJsonSchema(const uint8_t* pJsonText, size_t size, T& outValue) noexcept
+    {
+        outValue = T();
+        return ParseJsonSchema(pJsonText, size, JSON_SCHEMA_INPUT_FORMAT_TEXT, &outValue, GetJsonSchemaReader<T>());
+    }
+
+
+    template <typename T>
+    inline bool ParseJsonSchema(const fs::path& pathToJson, T& outValue) noexcept
+    {
+        outValue = T();
+        return ParseJsonSchema(pathToJson, &outValue, GetJsonSchemaReader<T>());
+    }
+
+
+    template <typename T>
+    inline bool ParseJsonSchema(const fs::path& pathToJson, const uint8_t* pJsonText, size_t size, T& outValue) noexcept
+    {
+        outValue = T();
+        return ParseJsonSchema(pathToJson, pJsonText, size, &outValue, GetJsonSchemaReader<T>());
+    }
+}